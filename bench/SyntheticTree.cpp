@@ -0,0 +1,197 @@
+#include "SyntheticTree.hpp"
+
+#include <rlSystem/FileSystem.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+
+
+namespace bench
+{
+
+	namespace
+	{
+
+		constexpr const char8_t *szExtensions[] = { u8".dat", u8".txt", u8".BIN", u8".log" };
+
+		uint64_t NextFileSize(Random &oRandom, const TreeConfig &oConfig)
+		{
+			switch (oConfig.eSizeDist)
+			{
+			case SizeDistribution::Fixed:
+				return oConfig.iMeanFileSize;
+
+			case SizeDistribution::Uniform:
+				return oConfig.iMeanFileSize ? oRandom.below(2 * oConfig.iMeanFileSize + 1) : 0;
+
+			case SizeDistribution::LogNormal:
+			{
+				if (oConfig.iMeanFileSize == 0)
+					return 0;
+
+				// Box-Muller, sigma = 1; mu is chosen so that the mean is iMeanFileSize.
+				constexpr double dSigma = 1.0;
+				constexpr double dPi    = 3.14159265358979323846;
+
+				const double dU1 = 1.0 - oRandom.unit(); // (0, 1]
+				const double dU2 = oRandom.unit();
+				const double dZ  = std::sqrt(-2.0 * std::log(dU1)) * std::cos(2.0 * dPi * dU2);
+				const double dMu = std::log((double)oConfig.iMeanFileSize) - dSigma * dSigma / 2;
+
+				const double dSize = std::exp(dMu + dSigma * dZ);
+				return dSize > 1e12 ? (uint64_t)1e12 : (uint64_t)dSize;
+			}
+			}
+
+			return 0;
+		}
+
+		std::u8string NumberedName(const char8_t *szPrefix, unsigned iNumber, unsigned iDigits)
+		{
+			std::u8string sResult = szPrefix;
+			std::u8string sNumber;
+			do
+			{
+				sNumber.insert(sNumber.begin(), char8_t(u8'0' + iNumber % 10));
+				iNumber /= 10;
+			} while (iNumber);
+
+			while (sNumber.length() < iDigits)
+				sNumber.insert(sNumber.begin(), u8'0');
+
+			return sResult + sNumber;
+		}
+
+		bool WriteFile(const std::u8string &sPath, uint64_t iSize, Random &oRandom)
+		{
+			std::ofstream file(
+#ifdef _WIN32
+				std::filesystem::path(sPath),
+#else
+				reinterpret_cast<const char *>(sPath.c_str()),
+#endif
+				std::ios::binary | std::ios::trunc);
+			if (!file)
+				return false;
+
+			// content is random, but only the first block is generated; it's repeated afterwards.
+			char buf[4096];
+			for (size_t i = 0; i < sizeof(buf); i += sizeof(uint64_t))
+			{
+				const uint64_t iValue = oRandom.next();
+				std::memcpy(buf + i, &iValue, sizeof(iValue));
+			}
+
+			while (iSize)
+			{
+				const size_t iChunk = iSize < sizeof(buf) ? (size_t)iSize : sizeof(buf);
+				file.write(buf, iChunk);
+				iSize -= iChunk;
+			}
+
+			return (bool)file;
+		}
+
+		bool GenerateLevel(const std::u8string &sDir, unsigned iLevel, Random &oRandom,
+			const TreeConfig &oConfig, TreeInfo &oInfo)
+		{
+			for (unsigned i = 0; i < oConfig.iFilesPerDir; ++i)
+			{
+				const auto sPath = rlSystem::Path::IncludeTrailingDelim(sDir.c_str()) +
+					NumberedName(u8"File_", i, 4) + szExtensions[oRandom.below(std::size(szExtensions))];
+				const uint64_t iSize = NextFileSize(oRandom, oConfig);
+
+				if (!WriteFile(sPath, iSize, oRandom))
+					return false;
+
+				oInfo.oFiles.push_back(sPath);
+				oInfo.iTotalBytes += iSize;
+			}
+
+			if (iLevel >= oConfig.iDepth)
+				return true;
+
+			for (unsigned i = 0; i < oConfig.iDirFanOut; ++i)
+			{
+				const auto sSubdir = rlSystem::Path::IncludeTrailingDelim(sDir.c_str()) +
+					NumberedName((i % 2) ? u8"dir_" : u8"Dir_", i, 2);
+
+				if (!rlSystem::Directory::Create(sSubdir.c_str()))
+					return false;
+				oInfo.oDirectories.push_back(sSubdir);
+
+				if (!GenerateLevel(sSubdir, iLevel + 1, oRandom, oConfig, oInfo))
+					return false;
+			}
+
+			return true;
+		}
+
+	}
+
+
+
+	uint64_t Random::next()
+	{
+		uint64_t z = (m_iState += 0x9E3779B97F4A7C15);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+		return z ^ (z >> 31);
+	}
+
+	uint64_t Random::below(uint64_t iMax)
+	{
+		if (iMax == 0)
+			return 0;
+		return next() % iMax;
+	}
+
+	double Random::unit() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+
+	const char *ToString(SizeDistribution eDist)
+	{
+		switch (eDist)
+		{
+		case SizeDistribution::Fixed:     return "fixed";
+		case SizeDistribution::Uniform:   return "uniform";
+		case SizeDistribution::LogNormal: return "lognormal";
+		}
+
+		return "";
+	}
+
+	bool Parse(const char *sz, SizeDistribution &eDist)
+	{
+		for (auto e : { SizeDistribution::Fixed, SizeDistribution::Uniform,
+			SizeDistribution::LogNormal })
+		{
+			if (std::strcmp(sz, ToString(e)) == 0)
+			{
+				eDist = e;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	bool GenerateTree(const char8_t *szRoot, const TreeConfig &oConfig, TreeInfo &oInfo)
+	{
+		if (rlSystem::Path::Exists(szRoot))
+			return false;
+
+		oInfo = {};
+
+		if (!rlSystem::Directory::Create(szRoot))
+			return false;
+		oInfo.sRoot = rlSystem::Path::Absolute(szRoot);
+
+		Random oRandom(oConfig.iSeed);
+		return GenerateLevel(oInfo.sRoot, 0, oRandom, oConfig, oInfo);
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+#ifndef RLSYSTEM_BENCH_SYNTHETICTREE
+#define RLSYSTEM_BENCH_SYNTHETICTREE
+
+
+
+
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+
+namespace bench
+{
+
+	enum class SizeDistribution
+	{
+		Fixed,     // every file has exactly iMeanFileSize bytes
+		Uniform,   // uniformly distributed in [0, 2 * iMeanFileSize]
+		LogNormal  // log-normally distributed around iMeanFileSize (many small, few large files)
+	};
+
+	struct TreeConfig
+	{
+		unsigned         iDepth        = 3;   // number of directory levels below the root
+		unsigned         iDirFanOut    = 4;   // subdirectories per directory
+		unsigned         iFilesPerDir  = 16;  // files per directory
+		uint64_t         iMeanFileSize = 4096;
+		SizeDistribution eSizeDist     = SizeDistribution::LogNormal;
+		uint64_t         iSeed         = 0x726C53797374656D; // "rlSystem"
+	};
+
+	struct TreeInfo
+	{
+		std::u8string              sRoot;
+		std::vector<std::u8string> oFiles;       // all generated files, in creation order
+		std::vector<std::u8string> oDirectories; // all generated directories, without the root
+		uint64_t                   iTotalBytes = 0;
+	};
+
+
+
+	/// <summary>
+	/// A small, fully specified PRNG (SplitMix64).<para/>
+	/// Unlike the <c>std::</c> distributions, its output is identical on every platform and
+	/// standard library, so a given seed always produces the same tree.
+	/// </summary>
+	class Random final
+	{
+	public: // methods
+
+		explicit Random(uint64_t iSeed) : m_iState(iSeed) {}
+
+		uint64_t next();
+
+		/// <summary>Get a random number in [0, iMax).</summary>
+		uint64_t below(uint64_t iMax);
+
+		/// <summary>Get a random number in [0, 1).</summary>
+		double unit();
+
+
+	private: // variables
+
+		uint64_t m_iState;
+
+	};
+
+	const char *ToString(SizeDistribution eDist);
+	bool Parse(const char *sz, SizeDistribution &eDist);
+
+	/// <summary>Generate a reproducible synthetic directory tree.</summary>
+	/// <param name="szRoot">
+	/// The directory to create the tree in. It must not exist yet.
+	/// </param>
+	/// <returns>Could the tree be created?</returns>
+	bool GenerateTree(const char8_t *szRoot, const TreeConfig &oConfig, TreeInfo &oInfo);
+
+}
+
+
+
+
+
+#endif // RLSYSTEM_BENCH_SYNTHETICTREE
\ No newline at end of file
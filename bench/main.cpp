@@ -0,0 +1,1012 @@
+#include "SyntheticTree.hpp"
+
+#include <rlSystem/AppExecution.hpp>
+#include <rlSystem/DirectoryHandle.hpp>
+#include <rlSystem/ExclusionRules.hpp>
+#include <rlSystem/FileSystem.hpp>
+#include <rlSystem/Pipeline.hpp>
+#include <rlSystem/Prefetcher.hpp>
+#include <rlSystem/ProcessBatch.hpp>
+#include <rlSystem/TempFile.hpp>
+#include <rlSystem/UnicodeCaseFolding.hpp>
+#include <rlSystem/UnicodeTranscoding.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+
+
+namespace
+{
+
+	struct BenchConfig
+	{
+		bench::TreeConfig oTree;
+		unsigned          iIterations = 5;
+		unsigned          iCopySample = 256; // number of files copied by the File::Copy benchmark
+		uint64_t          iLargeFile  = 256 * 1024 * 1024; // size of the large-file copy benchmark
+		std::u8string     sWorkDir    = u8"rlSystem_bench";
+		const char       *szOutFile   = nullptr;
+		bool              bKeep       = false;
+	};
+
+	/// <summary>Results are added to this so the compiler can't optimize the calls away.</summary>
+	volatile uint64_t g_iSink = 0;
+
+	struct BenchResult
+	{
+		std::string           sName;
+		uint64_t              iItems = 0; // items processed per iteration
+		std::vector<uint64_t> oSamples;   // nanoseconds per iteration
+	};
+
+	void PrintUsage(const char *szExe)
+	{
+		std::fprintf(stderr,
+			"Usage: %s [options]\n"
+			"  --depth N          directory levels below the root      (default: 3)\n"
+			"  --fanout N         subdirectories per directory         (default: 4)\n"
+			"  --files N          files per directory                  (default: 16)\n"
+			"  --size N           mean file size in bytes              (default: 4096)\n"
+			"  --size-dist D      fixed | uniform | lognormal          (default: lognormal)\n"
+			"  --seed N           seed for the tree generator\n"
+			"  --iterations N     iterations per benchmark             (default: 5)\n"
+			"  --copy-sample N    files copied by the File::Copy bench (default: 256)\n"
+			"  --large-file N     size of the large-file copy, 0 = skip (default: 256 MiB)\n"
+			"  --workdir PATH     scratch directory, must not exist    (default: rlSystem_bench)\n"
+			"  --out FILE         write the JSON report to FILE instead of stdout\n"
+			"  --keep             don't delete the scratch directory afterwards\n",
+			szExe);
+	}
+
+	bool ParseArgs(int argc, char *argv[], BenchConfig &oConfig)
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			const char *szArg = argv[i];
+			const bool bHasValue = i + 1 < argc;
+
+			auto number = [&](auto &iDest) -> bool
+			{
+				if (!bHasValue)
+					return false;
+				char *szEnd = nullptr;
+				const auto iValue = std::strtoull(argv[++i], &szEnd, 0);
+				if (*szEnd)
+					return false;
+				iDest = (std::remove_reference_t<decltype(iDest)>)iValue;
+				return true;
+			};
+
+			bool bOK = true;
+			if      (std::strcmp(szArg, "--depth")       == 0) bOK = number(oConfig.oTree.iDepth);
+			else if (std::strcmp(szArg, "--fanout")      == 0) bOK = number(oConfig.oTree.iDirFanOut);
+			else if (std::strcmp(szArg, "--files")       == 0) bOK = number(oConfig.oTree.iFilesPerDir);
+			else if (std::strcmp(szArg, "--size")        == 0) bOK = number(oConfig.oTree.iMeanFileSize);
+			else if (std::strcmp(szArg, "--seed")        == 0) bOK = number(oConfig.oTree.iSeed);
+			else if (std::strcmp(szArg, "--iterations")  == 0) bOK = number(oConfig.iIterations);
+			else if (std::strcmp(szArg, "--copy-sample") == 0) bOK = number(oConfig.iCopySample);
+			else if (std::strcmp(szArg, "--large-file")  == 0) bOK = number(oConfig.iLargeFile);
+			else if (std::strcmp(szArg, "--size-dist") == 0)
+				bOK = bHasValue && bench::Parse(argv[++i], oConfig.oTree.eSizeDist);
+			else if (std::strcmp(szArg, "--workdir") == 0 && bHasValue)
+				oConfig.sWorkDir = reinterpret_cast<const char8_t *>(argv[++i]);
+			else if (std::strcmp(szArg, "--out") == 0 && bHasValue)
+				oConfig.szOutFile = argv[++i];
+			else if (std::strcmp(szArg, "--keep") == 0)
+				oConfig.bKeep = true;
+			else
+				bOK = false;
+
+			if (!bOK)
+			{
+				std::fprintf(stderr, "Invalid argument \"%s\".\n", szArg);
+				return false;
+			}
+		}
+
+		if (oConfig.iIterations == 0)
+			oConfig.iIterations = 1;
+
+		return true;
+	}
+
+	/// <summary>Run a benchmark.</summary>
+	/// <param name="fnSetup">Called before every iteration, not timed. May be empty.</param>
+	/// <param name="fnRun">The timed operation. Returns the number of processed items.</param>
+	BenchResult Measure(const char *szName, unsigned iIterations,
+		const std::function<void()> &fnSetup, const std::function<uint64_t()> &fnRun)
+	{
+		std::fprintf(stderr, "Running %s...\n", szName);
+
+		BenchResult oResult;
+		oResult.sName = szName;
+		oResult.oSamples.reserve(iIterations);
+
+		for (unsigned i = 0; i < iIterations; ++i)
+		{
+			if (fnSetup)
+				fnSetup();
+
+			const auto tpStart = std::chrono::steady_clock::now();
+			oResult.iItems     = fnRun();
+			const auto tpEnd   = std::chrono::steady_clock::now();
+
+			oResult.oSamples.push_back((uint64_t)
+				std::chrono::duration_cast<std::chrono::nanoseconds>(tpEnd - tpStart).count());
+		}
+
+		return oResult;
+	}
+
+	std::string EscapeJSON(const std::string &s)
+	{
+		std::string sResult;
+		sResult.reserve(s.length());
+		for (char c : s)
+		{
+			switch (c)
+			{
+			case '"':  sResult += "\\\""; break;
+			case '\\': sResult += "\\\\"; break;
+			case '\n': sResult += "\\n";  break;
+			default:   sResult += c;
+			}
+		}
+		return sResult;
+	}
+
+	void WriteJSON(FILE *pFile, const BenchConfig &oConfig, const bench::TreeInfo &oTree,
+		const std::vector<BenchResult> &oResults)
+	{
+		std::fprintf(pFile, "{\n");
+		std::fprintf(pFile, "  \"benchmark\": \"rlSystem\",\n");
+		std::fprintf(pFile, "  \"config\": {\n");
+		std::fprintf(pFile, "    \"depth\": %u,\n",             oConfig.oTree.iDepth);
+		std::fprintf(pFile, "    \"fanout\": %u,\n",            oConfig.oTree.iDirFanOut);
+		std::fprintf(pFile, "    \"files_per_dir\": %u,\n",     oConfig.oTree.iFilesPerDir);
+		std::fprintf(pFile, "    \"mean_file_size\": %llu,\n",
+			(unsigned long long)oConfig.oTree.iMeanFileSize);
+		std::fprintf(pFile, "    \"size_dist\": \"%s\",\n",     bench::ToString(oConfig.oTree.eSizeDist));
+		std::fprintf(pFile, "    \"seed\": %llu,\n",            (unsigned long long)oConfig.oTree.iSeed);
+		std::fprintf(pFile, "    \"iterations\": %u\n",         oConfig.iIterations);
+		std::fprintf(pFile, "  },\n");
+		std::fprintf(pFile, "  \"tree\": {\n");
+		std::fprintf(pFile, "    \"files\": %zu,\n",            oTree.oFiles.size());
+		std::fprintf(pFile, "    \"directories\": %zu,\n",      oTree.oDirectories.size());
+		std::fprintf(pFile, "    \"bytes\": %llu\n",            (unsigned long long)oTree.iTotalBytes);
+		std::fprintf(pFile, "  },\n");
+		std::fprintf(pFile, "  \"results\": [\n");
+
+		for (size_t i = 0; i < oResults.size(); ++i)
+		{
+			const auto &oResult = oResults[i];
+
+			auto oSorted = oResult.oSamples;
+			std::sort(oSorted.begin(), oSorted.end());
+
+			uint64_t iSum = 0;
+			for (auto iSample : oSorted)
+				iSum += iSample;
+
+			const uint64_t iMean   = iSum / oSorted.size();
+			const uint64_t iMedian = oSorted[oSorted.size() / 2];
+
+			std::fprintf(pFile, "    {\n");
+			std::fprintf(pFile, "      \"name\": \"%s\",\n",   EscapeJSON(oResult.sName).c_str());
+			std::fprintf(pFile, "      \"iterations\": %zu,\n", oSorted.size());
+			std::fprintf(pFile, "      \"items\": %llu,\n",    (unsigned long long)oResult.iItems);
+			std::fprintf(pFile, "      \"min_ns\": %llu,\n",   (unsigned long long)oSorted.front());
+			std::fprintf(pFile, "      \"median_ns\": %llu,\n", (unsigned long long)iMedian);
+			std::fprintf(pFile, "      \"mean_ns\": %llu,\n",  (unsigned long long)iMean);
+			std::fprintf(pFile, "      \"max_ns\": %llu,\n",   (unsigned long long)oSorted.back());
+			std::fprintf(pFile, "      \"median_ns_per_item\": %.1f\n",
+				oResult.iItems ? (double)iMedian / oResult.iItems : 0.0);
+			std::fprintf(pFile, "    }%s\n", i + 1 < oResults.size() ? "," : "");
+		}
+
+		std::fprintf(pFile, "  ]\n");
+		std::fprintf(pFile, "}\n");
+	}
+
+}
+
+
+
+int main(int argc, char *argv[])
+{
+	BenchConfig oConfig;
+	if (!ParseArgs(argc, argv, oConfig))
+	{
+		PrintUsage(argv[0]);
+		return 1;
+	}
+
+	if (rlSystem::Path::Exists(oConfig.sWorkDir.c_str()))
+	{
+		std::fprintf(stderr, "The scratch directory \"%s\" already exists.\n",
+			reinterpret_cast<const char *>(oConfig.sWorkDir.c_str()));
+		return 1;
+	}
+
+	if (!rlSystem::Directory::Create(oConfig.sWorkDir.c_str()))
+	{
+		std::fprintf(stderr, "Couldn't create the scratch directory.\n");
+		return 1;
+	}
+	const auto sWorkDir = rlSystem::Path::IncludeTrailingDelim(
+		rlSystem::Path::Absolute(oConfig.sWorkDir.c_str()).c_str());
+
+	const auto sTreeDir  = sWorkDir + u8"tree";
+	const auto sCopyDir  = sWorkDir + u8"copy";
+	const auto sScratch  = sWorkDir + u8"scratch";
+
+	std::fprintf(stderr, "Generating tree...\n");
+	bench::TreeInfo oTree;
+	if (!bench::GenerateTree(sTreeDir.c_str(), oConfig.oTree, oTree))
+	{
+		std::fprintf(stderr, "Couldn't generate the synthetic tree.\n");
+		rlSystem::Directory::Delete(sWorkDir.c_str());
+		return 1;
+	}
+
+	const unsigned iIt = oConfig.iIterations;
+	std::vector<BenchResult> oResults;
+
+	auto fnClearCopyDir = [&]
+	{
+		std::error_code ec;
+		fs::remove_all(sCopyDir, ec);
+	};
+
+
+
+	// enumeration
+
+	oResults.push_back(Measure("Directory::GetFiles/all/recursive", iIt, {}, [&]
+	{
+		return (uint64_t)rlSystem::Directory::GetFiles(sTreeDir.c_str(), nullptr, true, true).size();
+	}));
+
+	oResults.push_back(Measure("Directory::GetFiles/regex/recursive", iIt, {}, [&]
+	{
+		return (uint64_t)rlSystem::Directory::GetFiles(sTreeDir.c_str(), u8R"(File_\d+\.dat)",
+			true, true).size();
+	}));
+
+	oResults.push_back(Measure("Directory::GetFiles/regex-icase/recursive", iIt, {}, [&]
+	{
+		return (uint64_t)rlSystem::Directory::GetFiles(sTreeDir.c_str(), u8R"(file_\d+\.bin)",
+			false, true).size();
+	}));
+
+	// 40 extensions + 8 globs; with regexes, this would take 48 walks.
+	rlSystem::PatternSet oPatterns(false);
+	for (unsigned i = 0; i < 40; ++i)
+	{
+		const auto sExt = u8"ext" + std::u8string(
+			reinterpret_cast<const char8_t *>(std::to_string(i).c_str()));
+		oPatterns.AddExtension(sExt.c_str());
+	}
+	oPatterns.AddExtension(u8"bin");
+	for (const char8_t *szGlob : { u8"*_0001.*", u8"file_00[2-4]?.dat", u8"*.tmp", u8"*~",
+		u8"#*#", u8"*.bak", u8"?ile_*1.log", u8"core.*" })
+		oPatterns.AddGlob(szGlob);
+
+	// a literal suffix is matched on the casefolded names instead of by std::regex::icase.
+	oResults.push_back(Measure("Directory::GetFiles/suffix-icase/recursive", iIt, {}, [&]
+	{
+		return (uint64_t)rlSystem::Directory::GetFiles(sTreeDir.c_str(), u8R"(.*\.BIN)",
+			false, true).size();
+	}));
+
+	oResults.push_back(Measure("Directory::GetFiles/pattern-set/recursive", iIt, {}, [&]
+	{
+		return (uint64_t)rlSystem::Directory::GetFiles(sTreeDir.c_str(), oPatterns, true).size();
+	}));
+
+	// "files larger than the mean size": once in the walk vs. afterwards with File::GetSize
+	rlSystem::Directory::Filter oSizeFilter;
+	oSizeFilter.iMinSize = oConfig.oTree.iMeanFileSize;
+
+	oResults.push_back(Measure("Directory::Enumerate/size-filter", iIt, {}, [&]
+	{
+		return (uint64_t)rlSystem::Directory::Enumerate(sTreeDir.c_str(), oSizeFilter).size();
+	}));
+
+	oResults.push_back(Measure("Directory::GetFiles+File::GetSize/size-filter", iIt, {}, [&]
+	{
+		uint64_t iCount = 0;
+		for (const auto &sFile : rlSystem::Directory::GetFiles(sTreeDir.c_str(), nullptr, true, true))
+		{
+			if (rlSystem::File::GetSize(sFile.c_str()) >= oConfig.oTree.iMeanFileSize)
+				++iCount;
+		}
+		return iCount;
+	}));
+
+	// excluding half of the subtrees on every level: pruned during the walk vs. afterwards
+	rlSystem::ExclusionRules oExclusions;
+	oExclusions.AddRule(u8"dir_0[13]/");
+
+	rlSystem::Directory::Filter oExcludeFilter;
+	oExcludeFilter.pExclusions = &oExclusions;
+
+	oResults.push_back(Measure("Directory::Enumerate/exclusion-rules", iIt, {}, [&]
+	{
+		return (uint64_t)rlSystem::Directory::Enumerate(sTreeDir.c_str(), oExcludeFilter).size();
+	}));
+
+	oResults.push_back(Measure("Directory::Enumerate/exclude-afterwards", iIt, {}, [&]
+	{
+		uint64_t iCount = 0;
+		for (const auto &oItem : rlSystem::Directory::Enumerate(sTreeDir.c_str(), {}))
+		{
+			const auto sPath = std::u8string_view(oItem.sPath).substr(sTreeDir.length());
+			if (sPath.find(u8"dir_01") == std::u8string_view::npos &&
+				sPath.find(u8"dir_03") == std::u8string_view::npos)
+				++iCount;
+		}
+		return iCount;
+	}));
+
+	oResults.push_back(Measure("Directory::GetTop/largest-100", iIt, {}, [&]
+	{
+		return (uint64_t)rlSystem::Directory::GetTop(sTreeDir.c_str(), {},
+			rlSystem::Directory::SortKey::Size, 100).size();
+	}));
+
+	oResults.push_back(Measure("Directory::GetTop/newest-100/4-threads", iIt, {}, [&]
+	{
+		return (uint64_t)rlSystem::Directory::GetTop(sTreeDir.c_str(), {},
+			rlSystem::Directory::SortKey::Modified, 100, true, 4).size();
+	}));
+
+	oResults.push_back(Measure("Directory::GetFiles/all/flat", iIt, {}, [&]
+	{
+		return (uint64_t)rlSystem::Directory::GetFiles(sTreeDir.c_str(), nullptr, true, false).size();
+	}));
+
+	oResults.push_back(Measure("Directory::GetDirectories/all/recursive", iIt, {}, [&]
+	{
+		return (uint64_t)rlSystem::Directory::GetDirectories(sTreeDir.c_str(), nullptr, true,
+			true).size();
+	}));
+
+	oResults.push_back(Measure("Directory::GetDirectories/regex-icase/recursive", iIt, {}, [&]
+	{
+		return (uint64_t)rlSystem::Directory::GetDirectories(sTreeDir.c_str(), u8R"(dir_0[02])",
+			false, true).size();
+	}));
+
+
+
+	// file operations
+
+	oResults.push_back(Measure("File::GetSize", iIt, {}, [&]
+	{
+		uint64_t iTotal = 0;
+		for (const auto &sFile : oTree.oFiles)
+			iTotal += rlSystem::File::GetSize(sFile.c_str());
+		g_iSink = g_iSink + iTotal;
+		return (uint64_t)oTree.oFiles.size();
+	}));
+
+	const size_t iCopySample = std::min<size_t>(oConfig.iCopySample, oTree.oFiles.size());
+	oResults.push_back(Measure("File::Copy", iIt, [&]
+	{
+		fnClearCopyDir();
+		fs::create_directories(sCopyDir);
+	}, [&]
+	{
+		const auto sPrefix = rlSystem::Path::IncludeTrailingDelim(sCopyDir.c_str());
+		for (size_t i = 0; i < iCopySample; ++i)
+		{
+			const auto sDest = sPrefix + std::u8string(u8"f") +
+				reinterpret_cast<const char8_t *>(std::to_string(i).c_str());
+			rlSystem::File::Copy(oTree.oFiles[i].c_str(), sDest.c_str());
+		}
+		return (uint64_t)iCopySample;
+	}));
+
+	if (oConfig.iLargeFile > 0)
+	{
+		const auto sLargeFile = sWorkDir + u8"large.bin";
+		{
+			std::ofstream oFile(fs::path(sLargeFile), std::ios::binary);
+			bench::Random oRandom(oConfig.oTree.iSeed);
+			std::vector<uint64_t> oBlock(1024 * 1024 / sizeof(uint64_t));
+			for (uint64_t iWritten = 0; iWritten < oConfig.iLargeFile; iWritten += 1024 * 1024)
+			{
+				for (auto &i : oBlock)
+					i = oRandom.next();
+				oFile.write(reinterpret_cast<const char *>(oBlock.data()),
+					(std::streamsize)std::min<uint64_t>(oConfig.iLargeFile - iWritten, 1024 * 1024));
+			}
+		}
+
+		const auto sLargeCopy = sWorkDir + u8"large_copy.bin";
+		auto fnRemoveLargeCopy = [&]
+		{
+			std::error_code ec;
+			fs::remove(sLargeCopy, ec);
+		};
+
+		rlSystem::CopyOptions oSingleStream;
+		oSingleStream.iChunkThreads = 1;
+		oResults.push_back(Measure("File::Copy/large/single-stream", iIt, fnRemoveLargeCopy, [&]
+		{
+			rlSystem::File::Copy(sLargeFile.c_str(), sLargeCopy.c_str(), oSingleStream);
+			return (uint64_t)1;
+		}));
+
+		rlSystem::CopyOptions oChunked;
+		oChunked.iLargeFileThreshold = 0;
+		oResults.push_back(Measure("File::Copy/large/chunked", iIt, fnRemoveLargeCopy, [&]
+		{
+			rlSystem::File::Copy(sLargeFile.c_str(), sLargeCopy.c_str(), oChunked);
+			return (uint64_t)1;
+		}));
+
+		rlSystem::CopyOptions oNoCache;
+		oNoCache.bNoCache = true;
+		oResults.push_back(Measure("File::Copy/large/no-cache", iIt, fnRemoveLargeCopy, [&]
+		{
+			rlSystem::File::Copy(sLargeFile.c_str(), sLargeCopy.c_str(), oNoCache);
+			return (uint64_t)1;
+		}));
+
+		fnRemoveLargeCopy();
+		std::error_code ec;
+		fs::remove(sLargeFile, ec);
+	}
+
+	// create, stat and delete many files in one directory: by path vs. by directory handle
+	constexpr unsigned iScratchFiles = 2000;
+	const auto sScratchPrefix = rlSystem::Path::IncludeTrailingDelim(sScratch.c_str());
+	fs::create_directories(sScratch);
+
+	oResults.push_back(Measure("File/create-stat-delete/by-path", iIt, {}, [&]
+	{
+		uint64_t iTotal = 0;
+		for (unsigned i = 0; i < iScratchFiles; ++i)
+		{
+			const auto sPath = sScratchPrefix + std::u8string(u8"f") +
+				reinterpret_cast<const char8_t *>(std::to_string(i).c_str());
+
+			std::ofstream oFile(fs::path(sPath), std::ios::binary);
+			oFile.put('x');
+			oFile.close();
+			iTotal += rlSystem::File::GetSize(sPath.c_str());
+			rlSystem::File::Delete(sPath.c_str());
+		}
+		g_iSink = g_iSink + iTotal;
+		return (uint64_t)iScratchFiles;
+	}));
+
+	oResults.push_back(Measure("File/create-stat-delete/by-handle", iIt, {}, [&]
+	{
+		const rlSystem::Directory::Handle oScratch(sScratch.c_str());
+
+		uint64_t iTotal = 0;
+		for (unsigned i = 0; i < iScratchFiles; ++i)
+		{
+			const auto sName = std::u8string(u8"f") +
+				reinterpret_cast<const char8_t *>(std::to_string(i).c_str());
+
+			if (FILE *pFile = oScratch.OpenFile(sName.c_str(), "w"))
+			{
+				std::fputc('x', pFile);
+				std::fclose(pFile);
+			}
+			iTotal += oScratch.GetSize(sName.c_str());
+			oScratch.Delete(sName.c_str());
+		}
+		g_iSink = g_iSink + iTotal;
+		return (uint64_t)iScratchFiles;
+	}));
+
+	oResults.push_back(Measure("TempFile/create-write-discard", iIt, {}, [&]
+	{
+		for (unsigned i = 0; i < iScratchFiles; ++i)
+		{
+			rlSystem::TempFile oTemp(sScratch.c_str());
+			if (oTemp)
+				std::fputc('x', oTemp.file());
+		}
+		return (uint64_t)iScratchFiles;
+	}));
+
+	// read all files in order, after evicting them from the page cache
+	{
+		auto fnReadAll = [&](const std::function<const std::u8string *()> &fnNext)
+		{
+			std::vector<char> oBuf(64 * 1024);
+			uint64_t iTotal = 0;
+			uint64_t iFiles = 0;
+			while (const auto *pPath = fnNext())
+			{
+				std::ifstream oFile(fs::path(*pPath), std::ios::binary);
+				while (oFile.read(oBuf.data(), (std::streamsize)oBuf.size()) || oFile.gcount() > 0)
+					iTotal += (uint64_t)oFile.gcount();
+				++iFiles;
+			}
+			g_iSink = g_iSink + iTotal;
+			return iFiles;
+		};
+
+		auto fnEvict = [&]
+		{
+#ifndef _WIN32
+			for (const auto &sFile : oTree.oFiles)
+			{
+				const int iFD = open(reinterpret_cast<const char *>(sFile.c_str()), O_RDONLY);
+				if (iFD >= 0)
+				{
+					posix_fadvise(iFD, 0, 0, POSIX_FADV_DONTNEED);
+					close(iFD);
+				}
+			}
+#endif
+		};
+
+		oResults.push_back(Measure("File/read-all/cold/sequential", iIt, fnEvict, [&]
+		{
+			size_t i = 0;
+			return fnReadAll([&]
+			{
+				return i < oTree.oFiles.size() ? &oTree.oFiles[i++] : nullptr;
+			});
+		}));
+
+		oResults.push_back(Measure("File/read-all/cold/prefetched", iIt, fnEvict, [&]
+		{
+			rlSystem::Prefetcher oPrefetcher(oTree.oFiles);
+			return fnReadAll([&] { return oPrefetcher.Next(); });
+		}));
+	}
+
+	oResults.push_back(Measure("Directory::Copy", iIt, fnClearCopyDir, [&]
+	{
+		rlSystem::Directory::Copy(sTreeDir.c_str(), sCopyDir.c_str());
+		return (uint64_t)1;
+	}));
+
+	oResults.push_back(Measure("Directory::CopyTree", iIt, fnClearCopyDir, [&]
+	{
+		rlSystem::Directory::CopyTree(sTreeDir.c_str(), sCopyDir.c_str());
+		return (uint64_t)(oTree.oFiles.size() + oTree.oDirectories.size() + 1);
+	}));
+
+	oResults.push_back(Measure("Directory::Delete", iIt, [&]
+	{
+		fnClearCopyDir();
+		fs::copy(sTreeDir, sCopyDir, fs::copy_options::recursive);
+	}, [&]
+	{
+		rlSystem::Directory::Delete(sCopyDir.c_str());
+		return (uint64_t)(oTree.oFiles.size() + oTree.oDirectories.size() + 1);
+	}));
+	fnClearCopyDir();
+
+
+
+	// path helpers
+
+	oResults.push_back(Measure("Path::helpers", iIt, {}, [&]
+	{
+		size_t iChecksum = 0;
+		for (const auto &sFile : oTree.oFiles)
+		{
+			const char8_t *szFile = sFile.c_str();
+			iChecksum += rlSystem::Path::GetName(szFile).length();
+			iChecksum += rlSystem::Path::GetFileExtension(szFile).length();
+			iChecksum += rlSystem::Path::SetFileExtension(szFile, u8".tmp").length();
+			iChecksum += rlSystem::Path::IncludeTrailingDelim(szFile).length();
+			iChecksum += rlSystem::Path::ExcludeTrailingDelim(szFile).length();
+			iChecksum += rlSystem::Path::IsAbsolute(szFile);
+		}
+		g_iSink = g_iSink + iChecksum;
+		return (uint64_t)oTree.oFiles.size();
+	}));
+
+	oResults.push_back(Measure("Path::GetParent", iIt, {}, [&]
+	{
+		size_t iChecksum = 0;
+		for (const auto &sFile : oTree.oFiles)
+			iChecksum += rlSystem::Path::GetParent(sFile.c_str()).length();
+		g_iSink = g_iSink + iChecksum;
+		return (uint64_t)oTree.oFiles.size();
+	}));
+
+	oResults.push_back(Measure("Path::GetCased", iIt, {}, [&]
+	{
+		size_t iChecksum = 0;
+		for (const auto &sFile : oTree.oFiles)
+			iChecksum += rlSystem::Path::GetCased(sFile.c_str()).length();
+		g_iSink = g_iSink + iChecksum;
+		return (uint64_t)oTree.oFiles.size();
+	}));
+
+
+
+	// UTF-8 <--> UTF-16, as done for every path on Windows. items: paths
+
+	{
+		namespace Unicode = rlSystem::Unicode;
+		constexpr unsigned iRepeat = 64;
+
+		// the same paths with some non-ASCII characters.
+		std::vector<std::u8string> oMixed;
+		std::vector<std::u16string> oUTF16;
+		size_t iMaxLength = 0;
+		for (const auto &sFile : oTree.oFiles)
+		{
+			oMixed.push_back(sFile + u8"/Stra\u00DFe-\u20AC");
+			oUTF16.push_back(Unicode::ToUTF16(sFile));
+			iMaxLength = std::max(iMaxLength, oMixed.back().length());
+		}
+		std::u16string sBuffer16(Unicode::MaxUTF16Length(iMaxLength), 0);
+		std::u8string sBuffer8(Unicode::MaxUTF8Length(iMaxLength), 0);
+
+		const auto fnToUTF16 = [&](const std::vector<std::u8string> &oPaths, auto fnConvert)
+		{
+			return [&, fnConvert]
+			{
+				size_t iChecksum = 0;
+				for (unsigned i = 0; i < iRepeat; ++i)
+				{
+					for (const auto &sPath : oPaths)
+						iChecksum += fnConvert(sPath, sBuffer16.data(), nullptr);
+				}
+				g_iSink = g_iSink + iChecksum;
+				return (uint64_t)oPaths.size() * iRepeat;
+			};
+		};
+
+		oResults.push_back(Measure("Unicode::UTF8ToUTF16/ascii", iIt, {},
+			fnToUTF16(oTree.oFiles, Unicode::UTF8ToUTF16)));
+		oResults.push_back(Measure("Unicode::UTF8ToUTF16/ascii/reference", iIt, {},
+			fnToUTF16(oTree.oFiles, Unicode::Reference::UTF8ToUTF16)));
+		oResults.push_back(Measure("Unicode::UTF8ToUTF16/mixed", iIt, {},
+			fnToUTF16(oMixed, Unicode::UTF8ToUTF16)));
+		oResults.push_back(Measure("Unicode::UTF8ToUTF16/mixed/reference", iIt, {},
+			fnToUTF16(oMixed, Unicode::Reference::UTF8ToUTF16)));
+
+		const auto fnToUTF8 = [&](auto fnConvert)
+		{
+			return [&, fnConvert]
+			{
+				size_t iChecksum = 0;
+				for (unsigned i = 0; i < iRepeat; ++i)
+				{
+					for (const auto &sPath : oUTF16)
+						iChecksum += fnConvert(sPath, sBuffer8.data(), nullptr);
+				}
+				g_iSink = g_iSink + iChecksum;
+				return (uint64_t)oUTF16.size() * iRepeat;
+			};
+		};
+
+		// a heap-allocated string per conversion vs. the inline buffer.
+		oResults.push_back(Measure("Unicode::ToUTF16/std::u16string", iIt, {}, [&]
+		{
+			size_t iChecksum = 0;
+			for (unsigned i = 0; i < iRepeat; ++i)
+			{
+				for (const auto &sPath : oTree.oFiles)
+					iChecksum += Unicode::ToUTF16(sPath).c_str()[0];
+			}
+			g_iSink = g_iSink + iChecksum;
+			return (uint64_t)oTree.oFiles.size() * iRepeat;
+		}));
+		oResults.push_back(Measure("Unicode::ToUTF16/inline-buffer", iIt, {}, [&]
+		{
+			size_t iChecksum = 0;
+			for (unsigned i = 0; i < iRepeat; ++i)
+			{
+				for (const auto &sPath : oTree.oFiles)
+				{
+					Unicode::InlineString<char16_t> oPath;
+					iChecksum += Unicode::ToUTF16(sPath, oPath)[0];
+				}
+			}
+			g_iSink = g_iSink + iChecksum;
+			return (uint64_t)oTree.oFiles.size() * iRepeat;
+		}));
+
+		oResults.push_back(Measure("Unicode::UTF16ToUTF8/ascii", iIt, {},
+			fnToUTF8(Unicode::UTF16ToUTF8)));
+		oResults.push_back(Measure("Unicode::UTF16ToUTF8/ascii/reference", iIt, {},
+			fnToUTF8(Unicode::Reference::UTF16ToUTF8)));
+	}
+
+
+
+	// case-insensitive comparison and hashing of paths. items: paths
+
+	{
+		namespace Unicode = rlSystem::Unicode;
+		constexpr unsigned iRepeat = 64;
+
+		// the same paths with different casing.
+		std::vector<std::u8string> oUpper;
+		for (const auto &sFile : oTree.oFiles)
+		{
+			auto &sUpper = oUpper.emplace_back(sFile);
+			for (auto &c : sUpper)
+			{
+				if (c >= u8'a' && c <= u8'z')
+					c -= u8'a' - u8'A';
+			}
+		}
+
+		const auto fnCompare = [&](const std::vector<std::u8string> &oOther, auto fnEqual)
+		{
+			return [&, fnEqual]
+			{
+				size_t iChecksum = 0;
+				for (unsigned i = 0; i < iRepeat; ++i)
+				{
+					for (size_t iFile = 0; iFile < oTree.oFiles.size(); ++iFile)
+						iChecksum += fnEqual(oTree.oFiles[iFile], oOther[iFile]);
+				}
+				g_iSink = g_iSink + iChecksum;
+				return (uint64_t)oTree.oFiles.size() * iRepeat;
+			};
+		};
+
+		oResults.push_back(Measure("Unicode::EqualNoCase", iIt, {},
+			fnCompare(oUpper, Unicode::EqualNoCase)));
+		oResults.push_back(Measure("Unicode::EqualNoCase/reference", iIt, {},
+			fnCompare(oUpper, [](std::u8string_view s1, std::u8string_view s2)
+			{
+				return Unicode::Reference::CompareNoCase(s1, s2) == 0;
+			})));
+		oResults.push_back(Measure("Unicode::EqualNoCase/case-sensitive", iIt, {},
+			fnCompare(oTree.oFiles, std::equal_to<std::u8string_view>())));
+
+		const auto fnHash = [&](auto fnHashString)
+		{
+			return [&, fnHashString]
+			{
+				size_t iChecksum = 0;
+				for (unsigned i = 0; i < iRepeat; ++i)
+				{
+					for (const auto &sPath : oTree.oFiles)
+						iChecksum += fnHashString(sPath);
+				}
+				g_iSink = g_iSink + iChecksum;
+				return (uint64_t)oTree.oFiles.size() * iRepeat;
+			};
+		};
+
+		oResults.push_back(Measure("Unicode::HashNoCase", iIt, {}, fnHash(Unicode::HashNoCase)));
+		oResults.push_back(Measure("Unicode::HashNoCase/case-sensitive", iIt, {},
+			fnHash(std::hash<std::u8string_view>())));
+
+		// every path is inserted twice, with different casing.
+		oResults.push_back(Measure("Unicode::NoCaseHash/dedupe", iIt, {}, [&]
+		{
+			std::unordered_set<std::u8string, Unicode::NoCaseHash, Unicode::NoCaseEqual> oSet;
+			oSet.insert(oTree.oFiles.begin(), oTree.oFiles.end());
+			oSet.insert(oUpper.begin(), oUpper.end());
+			g_iSink = g_iSink + oSet.size();
+			return (uint64_t)oTree.oFiles.size() * 2;
+		}));
+		oResults.push_back(Measure("Unicode::NoCaseHash/dedupe/case-sensitive", iIt, {}, [&]
+		{
+			std::unordered_set<std::u8string> oSet;
+			oSet.insert(oTree.oFiles.begin(), oTree.oFiles.end());
+			oSet.insert(oTree.oFiles.begin(), oTree.oFiles.end());
+			g_iSink = g_iSink + oSet.size();
+			return (uint64_t)oTree.oFiles.size() * 2;
+		}));
+	}
+
+
+
+	// process creation
+
+	{
+		auto fnSpawn = [&]
+		{
+			constexpr unsigned iSpawns = 16;
+			for (unsigned i = 0; i < iSpawns; ++i)
+			{
+				int iExitCode = 0;
+#ifdef _WIN32
+				rlSystem::RunApp(u8"cmd.exe", u8"/C exit 0", nullptr, true, &iExitCode, true);
+#else
+				rlSystem::RunApp(u8"true", nullptr, nullptr, true, &iExitCode, true);
+#endif
+			}
+			return (uint64_t)iSpawns;
+		};
+
+		oResults.push_back(Measure("RunApp/spawn-latency", iIt, {}, fnSpawn));
+
+		oResults.push_back(Measure("RunApp/spawn-latency/argv", iIt, {}, [&]
+		{
+			constexpr unsigned iSpawns = 16;
+#ifdef _WIN32
+			const std::u8string_view oArgs[] = { u8"/C", u8"exit", u8"0" };
+			constexpr char8_t szApp[] = u8"cmd.exe";
+#else
+			const std::span<const std::u8string_view> oArgs;
+			constexpr char8_t szApp[] = u8"true";
+#endif
+			for (unsigned i = 0; i < iSpawns; ++i)
+			{
+				int iExitCode = 0;
+				rlSystem::RunApp(szApp, oArgs, {}, nullptr, true, &iExitCode, true);
+			}
+			return (uint64_t)iSpawns;
+		}));
+
+		// the spawn server is forked before the ballast is allocated.
+		const bool bServer = rlSystem::SpawnServer::Start();
+		if (bServer)
+			oResults.push_back(Measure("RunApp/spawn-latency/spawn-server", iIt, {}, fnSpawn));
+
+		// the spawn latency shouldn't depend on the memory used by the parent process.
+		std::vector<char> oBallast(1024 * 1024 * 1024);
+		for (size_t i = 0; i < oBallast.size(); i += 4096)
+			oBallast[i] = 1;
+		if (bServer)
+		{
+			oResults.push_back(Measure("RunApp/spawn-latency/1-GiB-parent/spawn-server", iIt, {},
+				fnSpawn));
+			rlSystem::SpawnServer::Stop();
+		}
+		oResults.push_back(Measure("RunApp/spawn-latency/1-GiB-parent", iIt, {}, fnSpawn));
+	}
+
+#ifndef _WIN32
+	// items: MiB
+	oResults.push_back(Measure("RunConsoleApp/capture-64-MiB", iIt, {}, [&]
+	{
+		constexpr uint64_t iMiB = 64;
+		rlSystem::CapturedOutput oOutput;
+		rlSystem::CaptureOptions oOptions;
+		uint64_t iBytes = 0;
+		oOptions.fnStdOut = [&](std::string_view sData) { iBytes += sData.length(); };
+		rlSystem::RunConsoleApp(u8"head", u8"-c 67108864 /dev/zero", nullptr, nullptr, oOutput,
+			oOptions);
+		g_iSink = g_iSink + iBytes;
+		return iMiB;
+	}));
+
+	// items: MiB. Written to stdin while stdout is read.
+	{
+		constexpr uint64_t iMiB = 64;
+		const std::string sInput(iMiB * 1024 * 1024, 'x');
+		oResults.push_back(Measure("RunConsoleApp/stdin-from-memory-64-MiB", iIt, {}, [&]
+		{
+			rlSystem::InputSource oInput;
+			oInput.sData = sInput;
+			rlSystem::CapturedOutput oOutput;
+			rlSystem::CaptureOptions oOptions;
+			uint64_t iBytes = 0;
+			oOptions.fnStdOut = [&](std::string_view sData) { iBytes += sData.length(); };
+			rlSystem::RunConsoleApp(u8"cat", nullptr, nullptr, nullptr, oOutput, oOptions, nullptr,
+				&oInput);
+			g_iSink = g_iSink + iBytes;
+			return iMiB;
+		}));
+	}
+#endif
+
+#ifndef _WIN32
+	// items: MiB. The same 3-stage chain, once via intermediate files, once as a pipeline.
+	{
+		const auto sStage1 = sWorkDir + u8"stage1.bin";
+		const auto sStage2 = sWorkDir + u8"stage2.bin";
+		const auto sResult = sWorkDir + u8"result.bin";
+		constexpr uint64_t iMiB = 64;
+
+		oResults.push_back(Measure("RunConsoleApp/3-stages-via-files-64-MiB", iIt, {}, [&]
+		{
+			rlSystem::RunConsoleApp(u8"head", u8"-c 67108864 /dev/zero", nullptr, nullptr,
+				sStage1.c_str());
+			const auto sArgs2 = u8"-c 'gzip -1 < \"$0\"' '" + sStage1 + u8"'";
+			rlSystem::RunConsoleApp(u8"sh", sArgs2.c_str(), nullptr, nullptr, sStage2.c_str());
+			const auto sArgs3 = u8"-c 'gzip -d < \"$0\"' '" + sStage2 + u8"'";
+			rlSystem::RunConsoleApp(u8"sh", sArgs3.c_str(), nullptr, nullptr, sResult.c_str());
+			return iMiB;
+		}));
+
+		oResults.push_back(Measure("RunPipeline/3-stages-64-MiB", iIt, {}, [&]
+		{
+			rlSystem::PipelineOptions oOptions;
+			oOptions.sOutputFile = sResult;
+			rlSystem::RunPipeline({ { u8"head", u8"-c 67108864 /dev/zero" }, { u8"gzip", u8"-1" },
+				{ u8"gzip", u8"-d" } }, oOptions);
+			return iMiB;
+		}));
+
+		oResults.push_back(Measure("RunPipeline/3-stages-64-MiB/file-and-callback", iIt, {}, [&]
+		{
+			uint64_t iBytes = 0;
+			rlSystem::PipelineOptions oOptions;
+			oOptions.sOutputFile = sResult;
+			oOptions.fnOutput    = [&](std::string_view sData) { iBytes += sData.length(); };
+			rlSystem::RunPipeline({ { u8"head", u8"-c 67108864 /dev/zero" }, { u8"gzip", u8"-1" },
+				{ u8"gzip", u8"-d" } }, oOptions);
+			g_iSink = g_iSink + iBytes;
+			return iMiB;
+		}));
+
+		rlSystem::File::Delete(sStage1.c_str());
+		rlSystem::File::Delete(sStage2.c_str());
+		rlSystem::File::Delete(sResult.c_str());
+	}
+#endif
+
+	{
+		std::vector<rlSystem::ProcessJob> oJobs(64);
+		for (auto &oJob : oJobs)
+		{
+#ifdef _WIN32
+			oJob.sAppPath = u8"cmd.exe";
+			oJob.sArgs    = u8"/C exit 0";
+#else
+			oJob.sAppPath = u8"sh";
+			oJob.sArgs    = u8"-c 'echo batch'";
+#endif
+		}
+
+		for (const unsigned iParallel : { 1u, 0u })
+		{
+			rlSystem::BatchOptions oOptions;
+			oOptions.iMaxParallel = iParallel;
+			const auto sName = std::string("RunBatch/64-jobs/") +
+				(iParallel == 1 ? "sequential" : "parallel");
+			oResults.push_back(Measure(sName.c_str(), iIt, {}, [&]
+			{
+				const auto oJobResults = rlSystem::RunBatch(oJobs, oOptions);
+				g_iSink = g_iSink + oJobResults.size();
+				return (uint64_t)oJobResults.size();
+			}));
+		}
+	}
+
+
+
+	if (!oConfig.bKeep)
+		rlSystem::Directory::Delete(sWorkDir.c_str());
+
+	FILE *pOut = stdout;
+	if (oConfig.szOutFile)
+	{
+		pOut = std::fopen(oConfig.szOutFile, "w");
+		if (!pOut)
+		{
+			std::fprintf(stderr, "Couldn't open \"%s\" for writing.\n", oConfig.szOutFile);
+			return 1;
+		}
+	}
+
+	WriteJSON(pOut, oConfig, oTree, oResults);
+
+	if (pOut != stdout)
+		std::fclose(pOut);
+
+	return 0;
+}
\ No newline at end of file
@@ -5,9 +5,124 @@
 
 
 
+#include <rlSystem/Process.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+
+
+
 namespace rlSystem
 {
 
+	/// <summary>Options for capturing the output of a console application.</summary>
+	struct CaptureOptions
+	{
+		/// <summary>
+		/// Called for every chunk of <c>stdout</c> output as soon as it's received.<para/>
+		/// If set, the output isn't stored in <c>CapturedOutput::sStdOut</c>.
+		/// </summary>
+		std::function<void(std::string_view sData)> fnStdOut;
+
+		/// <summary>Like <c>fnStdOut</c>, for <c>stderr</c>.</summary>
+		std::function<void(std::string_view sData)> fnStdErr;
+
+		/// <summary>
+		/// The maximum number of bytes captured per stream. Further output is read, but
+		/// discarded.<para/>
+		/// Zero means no limit.
+		/// </summary>
+		size_t iMaxOutputSize = 0;
+
+		/// <summary>Should <c>stderr</c> be captured together with <c>stdout</c>?</summary>
+		bool bMergeStdErr = false;
+	};
+
+	/// <summary>The captured output of a console application.</summary>
+	struct CapturedOutput
+	{
+		std::string sStdOut;
+		std::string sStdErr;
+
+		/// <summary>Was output discarded because of <c>CaptureOptions::iMaxOutputSize</c>?</summary>
+		bool bTruncated = false;
+	};
+
+
+	/// <summary>
+	/// The source of the <c>stdin</c> input of a console application.<para/>
+	/// If <c>sFile</c> is set, the file is used; otherwise, if <c>hFile</c> is valid, the open
+	/// file; otherwise, <c>sData</c>.
+	/// </summary>
+	struct InputSource
+	{
+#ifdef _WIN32
+		/// <summary>A file handle (<c>HANDLE</c>).</summary>
+		using NativeFile = void *;
+		static constexpr NativeFile InvalidFile = nullptr;
+#else
+		/// <summary>A file descriptor.</summary>
+		using NativeFile = int;
+		static constexpr NativeFile InvalidFile = -1;
+#endif
+
+		/// <summary>
+		/// Data that is written to the application through a pipe, while its output is read.
+		/// <para/>
+		/// Must stay valid until <c>RunConsoleApp</c> returns. The application might not read
+		/// all of it.
+		/// </summary>
+		std::string_view sData;
+
+		/// <summary>
+		/// The path of a file that is opened as <c>stdin</c> of the application, so the
+		/// application reads it directly.
+		/// </summary>
+		std::u8string sFile;
+
+		/// <summary>
+		/// An open file that becomes <c>stdin</c> of the application (e.g. a pipe or a socket).
+		/// <para/>
+		/// It's not closed; the current position is shared with the application.
+		/// </summary>
+		NativeFile hFile = InvalidFile;
+	};
+
+	/// <summary>
+	/// An optional helper process that starts child processes on behalf of the current
+	/// application (Linux only).<para/>
+	/// The helper is forked once, while the current application is still small. Afterwards,
+	/// the synchronous <c>RunApp</c>/<c>RunConsoleApp</c> calls send their requests to it via a
+	/// Unix socket, passing the standard streams and the working directory as file descriptors.
+	/// So the cost of starting a process doesn't depend on the memory and the threads of the
+	/// current application.<para/>
+	/// If the helper isn't running (or a request is too large for it), processes are started
+	/// directly.
+	/// </summary>
+	namespace SpawnServer
+	{
+
+		/// <summary>
+		/// Start the helper process. Should be called early from the main thread, before other
+		/// threads are started (the helper ends with the thread that started it).<para/>
+		/// Always fails on Windows.
+		/// </summary>
+		/// <returns>Is the helper running?</returns>
+		bool Start();
+
+		/// <summary>
+		/// Stop the helper process. Waits until the processes it started have ended.
+		/// </summary>
+		void Stop();
+
+		/// <summary>Is the helper running?</summary>
+		bool IsRunning();
+
+	}
+
 	/// <summary>Run an application.</summary>
 	/// <param name="szAppPath">The path of the executable.</param>
 	/// <param name="szArgs">
@@ -24,14 +139,93 @@ namespace rlSystem
 	/// pointed-to variable will receive the exit code of the called application.
 	/// </param>
 	/// <param name="bHideWindow">Should the application window be hidden?</param>
+	/// <param name="pUsage">
+	/// If this value is not <c>nullptr</c>, the pointed-to variable will receive the resources
+	/// used by the application (if it was executed synchronously).
+	/// </param>
+	/// <returns>Could the application be executed?</returns>
+	bool RunApp(
+		const char8_t       *szAppPath,
+		const char8_t       *szArgs       = nullptr,
+		const char8_t       *szCurrentDir = nullptr,
+		      bool           bSynchronous = false,
+		      int           *pResult      = nullptr,
+		      bool           bHideWindow  = false,
+		      ResourceUsage *pUsage       = nullptr
+	);
+
+	/// <summary>Start an application asynchronously and get a handle to it.</summary>
+	/// <param name="szAppPath">The path of the executable.</param>
+	/// <param name="szArgs">
+	/// The arguments for the application.<para/>
+	/// If this value is <c>nullptr</c>, no arguments are passed to the application.
+	/// </param>
+	/// <param name="szCurrentDir">
+	/// The working directory for the application.<para/>
+	/// If this value is <c>nullptr</c>, the working directory of the current application is used.
+	/// </param>
+	/// <param name="oProcess">
+	/// Receives the started process, which can be waited for or terminated.
+	/// </param>
+	/// <param name="bHideWindow">Should the application window be hidden?</param>
 	/// <returns>Could the application be executed?</returns>
 	bool RunApp(
 		const char8_t *szAppPath,
-		const char8_t *szArgs       = nullptr,
-		const char8_t *szCurrentDir = nullptr,
-		      bool     bSynchronous = false,
-		      int     *pResult      = nullptr,
-		      bool     bHideWindow  = false
+		const char8_t *szArgs,
+		const char8_t *szCurrentDir,
+		      Process &oProcess,
+		      bool     bHideWindow = false
+	);
+
+	/// <summary>
+	/// Run an application, passing the arguments as a list.<para/>
+	/// The arguments reach the application unchanged: on Linux, they're passed to the
+	/// application directly; on Windows, they're quoted as needed.
+	/// </summary>
+	/// <param name="szAppPath">The path of the executable.</param>
+	/// <param name="oArgs">The arguments for the application, without the executable.</param>
+	/// <param name="oEnvironment">
+	/// The environment of the application, as <c>NAME=value</c> entries.<para/>
+	/// If this is empty, the environment of the current application is inherited.
+	/// </param>
+	/// <param name="szCurrentDir">
+	/// The working directory for the application.<para/>
+	/// If this value is <c>nullptr</c>, the working directory of the current application is used.
+	/// </param>
+	/// <param name="bSynchronous">Should the app be executed synchronously?</param>
+	/// <param name="pResult">
+	/// If <c>bSynchronous</c> is set to <c>true</c> and this value is not <c>nullptr</c>, the
+	/// pointed-to variable will receive the exit code of the called application.
+	/// </param>
+	/// <param name="bHideWindow">Should the application window be hidden?</param>
+	/// <param name="pUsage">
+	/// If this value is not <c>nullptr</c>, the pointed-to variable will receive the resources
+	/// used by the application (if it was executed synchronously).
+	/// </param>
+	/// <returns>Could the application be executed?</returns>
+	bool RunApp(
+		const char8_t                             *szAppPath,
+		      std::span<const std::u8string_view>  oArgs,
+		      std::span<const std::u8string_view>  oEnvironment = {},
+		const char8_t                             *szCurrentDir = nullptr,
+		      bool                                 bSynchronous = false,
+		      int                                 *pResult      = nullptr,
+		      bool                                 bHideWindow  = false,
+		      ResourceUsage                       *pUsage       = nullptr
+	);
+
+	/// <summary>
+	/// Start an application asynchronously, passing the arguments as a list, and get a handle to
+	/// it.<para/>
+	/// For the parameters, see the other <c>RunApp</c> overloads.
+	/// </summary>
+	bool RunApp(
+		const char8_t                             *szAppPath,
+		      std::span<const std::u8string_view>  oArgs,
+		      std::span<const std::u8string_view>  oEnvironment,
+		const char8_t                             *szCurrentDir,
+		      Process                             &oProcess,
+		      bool                                 bHideWindow = false
 	);
 
 	/// <summary>Run a console application synchronously.</summary>
@@ -59,14 +253,68 @@ namespace rlSystem
 	/// <param name="szStdErrFile">
 	/// Redirection of <c>stderr</c> output, see <c>szStdOutFile</c>.
 	/// </param>
+	/// <param name="pUsage">
+	/// If this value is not <c>nullptr</c>, the pointed-to variable will receive the resources
+	/// used by the application.
+	/// </param>
+	/// <param name="pInput">
+	/// The input for the application.<para/>
+	/// If this value is <c>nullptr</c>, the application reads the input of the current
+	/// application.
+	/// </param>
 	/// <returns></returns>
 	bool RunConsoleApp(
-		const char8_t *szAppPath,
-		const char8_t *szArgs       = nullptr,
-		const char8_t *szCurrentDir = nullptr,
-		      int     *pResult      = nullptr,
-		const char8_t *szStdOutFile = nullptr,
-		const char8_t *szStdErrFile = nullptr
+		const char8_t       *szAppPath,
+		const char8_t       *szArgs       = nullptr,
+		const char8_t       *szCurrentDir = nullptr,
+		      int           *pResult      = nullptr,
+		const char8_t       *szStdOutFile = nullptr,
+		const char8_t       *szStdErrFile = nullptr,
+		      ResourceUsage *pUsage       = nullptr,
+		const InputSource   *pInput       = nullptr
+	);
+
+	/// <summary>Run a console application synchronously and capture its output.</summary>
+	/// <param name="szAppPath">The path of the executable.</param>
+	/// <param name="szArgs">
+	/// The arguments for the application.<para/>
+	/// If this value is <c>nullptr</c>, no arguments are passed to the application.
+	/// </param>
+	/// <param name="szCurrentDir">
+	/// The working directory for the application.<para/>
+	/// If this value is <c>nullptr</c>, the working directory of the current application is used.
+	/// </param>
+	/// <param name="pResult">
+	/// If this value is not <c>nullptr</c>, the pointed-to variable will receive the exit code of
+	/// the called application.
+	/// </param>
+	/// <param name="oOutput">
+	/// Receives the output of the application (unless it's passed to callbacks).
+	/// </param>
+	/// <param name="oOptions">
+	/// How the output is captured.<para/>
+	/// Both streams are read at the same time, so the application never blocks because one of
+	/// them is full. The callbacks for one stream are never called concurrently.
+	/// </param>
+	/// <param name="pUsage">
+	/// If this value is not <c>nullptr</c>, the pointed-to variable will receive the resources
+	/// used by the application.
+	/// </param>
+	/// <param name="pInput">
+	/// The input for the application.<para/>
+	/// If this value is <c>nullptr</c>, the application reads the input of the current
+	/// application.
+	/// </param>
+	/// <returns>Could the application be executed?</returns>
+	bool RunConsoleApp(
+		const char8_t        *szAppPath,
+		const char8_t        *szArgs,
+		const char8_t        *szCurrentDir,
+		      int            *pResult,
+		      CapturedOutput &oOutput,
+		const CaptureOptions &oOptions = {},
+		      ResourceUsage  *pUsage   = nullptr,
+		const InputSource    *pInput   = nullptr
 	);
 
 }
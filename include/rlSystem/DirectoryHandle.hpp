@@ -0,0 +1,164 @@
+#ifndef RLSYSTEM_DIRECTORYHANDLE
+#define RLSYSTEM_DIRECTORYHANDLE
+
+
+
+
+
+#include <rlSystem/FileSystem.hpp>
+
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <string_view>
+
+
+
+namespace rlSystem
+{
+
+	namespace Directory
+	{
+
+		/// <summary>
+		/// An open directory. All operations take names relative to it.<para/>
+		/// On Linux, the handle holds a directory file descriptor and every operation is a
+		/// single <c>*at</c> system call (or, for moves to another file system, goes through
+		/// <c>/proc/self/fd</c>), so the kernel doesn't resolve the directory's path again and a
+		/// directory that's renamed or replaced in the meantime is never mixed up with the
+		/// original one.<para/>
+		/// On Windows, the operations are forwarded to the path-based functions.
+		/// </summary>
+		class Handle final
+		{
+		public: // methods
+
+			/// <summary>Create an invalid handle.</summary>
+			Handle() noexcept = default;
+
+			/// <summary>Open a directory. Check <c>valid()</c> to see if this succeeded.</summary>
+			explicit Handle(const char8_t *szDirPath);
+
+			Handle(Handle &&other) noexcept;
+			Handle &operator=(Handle &&other) noexcept;
+
+			Handle(const Handle &) = delete;
+			Handle &operator=(const Handle &) = delete;
+
+			~Handle();
+
+			/// <summary>Was the directory opened successfully?</summary>
+			bool valid() const noexcept;
+			explicit operator bool() const noexcept { return valid(); }
+
+			/// <summary>
+			/// The absolute path of the directory when it was opened, with a trailing delimiter.
+			/// </summary>
+			const std::u8string &path() const noexcept { return m_sPath; }
+
+			/// <summary>Close the directory. The handle is invalid afterwards.</summary>
+			void close() noexcept;
+
+
+			/// <summary>Does an item exist in the directory?</summary>
+			/// <param name="szName">
+			/// The name of the item.<para/>
+			/// Like all names passed to a <c>Handle</c>, this may also be a relative path.
+			/// </param>
+			/// <param name="iTypes">
+			/// The accepted item types, a combination of <c>ItemType</c> values. Symbolic links are
+			/// followed, so <c>ItemType::Symlink</c> never matches.
+			/// </param>
+			bool Exists(const char8_t *szName, unsigned iTypes = ItemType::All) const;
+
+			/// <summary>Get the size of a file in the directory, in bytes.</summary>
+			/// <returns>
+			/// If the function succeeds, it returns the size of the file, in bytes.<para/>
+			/// If the function fails, it returns zero.
+			/// </returns>
+			size_t GetSize(const char8_t *szName) const;
+
+			/// <summary>Create a subdirectory. Parent directories are not created.</summary>
+			/// <returns>
+			/// Was the subdirectory created?<para/>
+			/// Returns <c>false</c> if it already existed.
+			/// </returns>
+			bool Create(const char8_t *szName) const;
+
+			/// <summary>
+			/// Delete a file or subdirectory. Subdirectories are deleted including their contents.
+			/// </summary>
+			/// <returns>Was the item deleted?</returns>
+			bool Delete(const char8_t *szName) const;
+
+			/// <summary>Rename an item inside the directory.</summary>
+			/// <param name="bReplace">
+			/// May an existing item at <c>szNewName</c> be replaced?<para/>
+			/// If not, the check and the rename are a single atomic operation.
+			/// </param>
+			bool Move(const char8_t *szOrigName, const char8_t *szNewName,
+				bool bReplace = true) const;
+
+			/// <summary>
+			/// Move an item to another directory.<para/>
+			/// If <c>oNewDir</c> is on a different file system, the item is copied and then
+			/// deleted, which isn't atomic. On Linux, the items are still accessed via the
+			/// directory descriptors (through <c>/proc/self/fd</c>; without <c>/proc</c>, such a
+			/// move fails).
+			/// </summary>
+			/// <param name="oNewDir">The directory the item is moved to.</param>
+			/// <param name="szNewName">The name of the item in <c>oNewDir</c>.</param>
+			/// <param name="bReplace">
+			/// May an existing item at <c>szNewName</c> be replaced?<para/>
+			/// Across file systems, an existing directory is only deleted after the item was
+			/// copied completely.
+			/// </param>
+			bool Move(const char8_t *szOrigName, const Handle &oNewDir, const char8_t *szNewName,
+				bool bReplace = true) const;
+
+			/// <summary>Open a subdirectory.</summary>
+			/// <returns>
+			/// A handle to the subdirectory. If it couldn't be opened, the handle is invalid.
+			/// </returns>
+			Handle Open(const char8_t *szName) const;
+
+			/// <summary>Open a file in the directory.</summary>
+			/// <param name="szMode">
+			/// A mode string like in <c>fopen</c>: <c>"r"</c>, <c>"w"</c> or <c>"a"</c>, optionally
+			/// followed by <c>"+"</c>, <c>"b"</c> and/or <c>"x"</c> (only after <c>"w"</c>: fail if
+			/// the file exists; the check is atomic).
+			/// </param>
+			/// <returns>
+			/// The opened file, which must be closed via <c>fclose</c>.<para/>
+			/// If the file couldn't be opened, the return value is <c>nullptr</c>.
+			/// </returns>
+			FILE *OpenFile(const char8_t *szName, const char *szMode) const;
+
+			/// <summary>Enumerate the items directly inside the directory.</summary>
+			/// <param name="fnCallback">
+			/// Called for every item with its name and type (one of <c>ItemType</c>).
+			/// Return <c>false</c> to stop the enumeration.
+			/// </param>
+			/// <returns>Could the directory be read?</returns>
+			bool Enumerate(
+				const std::function<bool(std::u8string_view sName, unsigned iType)> &fnCallback) const;
+
+
+		private: // variables
+
+			std::u8string m_sPath;
+#ifndef _WIN32
+			int           m_iFD = -1;
+#endif
+
+		};
+
+	}
+
+}
+
+
+
+
+
+#endif // RLSYSTEM_DIRECTORYHANDLE
\ No newline at end of file
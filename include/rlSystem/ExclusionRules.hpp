@@ -0,0 +1,136 @@
+#ifndef RLSYSTEM_EXCLUSIONRULES
+#define RLSYSTEM_EXCLUSIONRULES
+
+
+
+
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+
+namespace rlSystem
+{
+
+	/// <summary>
+	/// A list of rules in <c>.gitignore</c> syntax that decide which items of a directory tree
+	/// are excluded, e.g. <c>"node_modules/"</c>, <c>"/build"</c>, <c>"*.o"</c>,
+	/// <c>"!keep.o"</c>.<para/>
+	/// Paths are checked relative to the searched directory, with <c>/</c> as delimiter. As
+	/// in Git, the last matching rule decides.<para/>
+	/// The rules are parsed once when they're added; plain names and <c>*.ext</c> rules are
+	/// compared directly, only other rules are matched as globs.
+	/// </summary>
+	class ExclusionRules final
+	{
+	public: // types
+
+		enum class Result
+		{
+			None,     // no rule matches
+			Excluded, // the last matching rule excludes the path
+			Included  // the last matching rule is a negated one ("!...")
+		};
+
+
+	public: // methods
+
+		/// <param name="bCaseSensitive">
+		/// Should the rules be matched case-sensitively?<para/>
+		/// If not, paths and rules are compared by their Unicode simple case folding (except
+		/// inside brackets, which only support ASCII characters).
+		/// </param>
+		explicit ExclusionRules(bool bCaseSensitive = true);
+
+		/// <summary>Add a rule.</summary>
+		/// <param name="sRule">
+		/// A line of a <c>.gitignore</c> file:<para/>
+		/// Blank lines and lines starting with <c>#</c> are ignored.<para/>
+		/// A leading <c>!</c> negates the rule, i.e. re-includes matching items. Items inside an
+		/// excluded directory can't be re-included, as the directory isn't searched.<para/>
+		/// A trailing <c>/</c> restricts the rule to directories.<para/>
+		/// A rule with a <c>/</c> at the beginning or in the middle is matched against the
+		/// whole path relative to <c>sBase</c>; any other rule against the name of the item, on
+		/// every level.<para/>
+		/// <c>*</c> matches any sequence of characters except <c>/</c>, <c>?</c> one character
+		/// except <c>/</c>, <c>[a-z]</c> and <c>[!a-z]</c> one character of (not of) a set.
+		/// A leading <c>**/</c> matches in all directories, a trailing <c>/**</c> everything
+		/// inside a directory, <c>/**/</c> any number of directories.<para/>
+		/// A backslash escapes the next character.
+		/// </param>
+		/// <param name="sBase">
+		/// The directory the rule belongs to, relative to the searched directory (e.g. the
+		/// directory of the <c>.gitignore</c> file). Empty for the searched directory itself.
+		/// <para/>
+		/// The rule only applies to items inside this directory.
+		/// </param>
+		/// <returns>Was a rule added (i.e. was the line no blank line or comment)?</returns>
+		bool AddRule(std::u8string_view sRule, std::u8string_view sBase = {});
+
+		/// <summary>Add the rules of a text in <c>.gitignore</c> format.</summary>
+		/// <returns>The number of rules added.</returns>
+		size_t AddRules(std::u8string_view sText, std::u8string_view sBase = {});
+
+		/// <summary>Add the rules of a file in <c>.gitignore</c> format.</summary>
+		/// <returns>Could the file be read?</returns>
+		bool AddFile(const char8_t *szFilePath, std::u8string_view sBase = {});
+
+		/// <summary>The number of rules.</summary>
+		size_t size() const noexcept { return m_oRules.size(); }
+		bool empty() const noexcept { return m_oRules.empty(); }
+
+		bool caseSensitive() const noexcept { return m_bCaseSensitive; }
+
+		/// <summary>Check a path against the rules.</summary>
+		/// <param name="sPath">
+		/// The path of an item, relative to the searched directory.<para/>
+		/// Only the item itself is checked, not its parent directories.
+		/// </param>
+		/// <param name="bDirectory">Is the item a directory?</param>
+		Result Check(std::u8string_view sPath, bool bDirectory) const;
+
+		/// <summary>Is an item excluded by the rules?</summary>
+		/// <param name="sPath">The path of an item, relative to the searched directory.</param>
+		/// <param name="bDirectory">Is the item a directory?</param>
+		bool IsExcluded(std::u8string_view sPath, bool bDirectory) const
+		{
+			return Check(sPath, bDirectory) == Result::Excluded;
+		}
+
+
+	private: // types
+
+		enum class RuleKind
+		{
+			Name,   // sPattern is the exact name/path
+			Suffix, // "*" followed by sPattern
+			Glob
+		};
+
+		struct Rule
+		{
+			std::u8string sPattern;
+			std::u8string sBase;     // empty or ending with '/'
+			RuleKind      eKind;
+			bool          bNegated;
+			bool          bDirOnly;
+			bool          bAnchored; // matched against the path instead of the name
+		};
+
+
+	private: // variables
+
+		bool m_bCaseSensitive;
+		std::vector<Rule> m_oRules;
+
+	};
+
+}
+
+
+
+
+
+#endif // RLSYSTEM_EXCLUSIONRULES
\ No newline at end of file
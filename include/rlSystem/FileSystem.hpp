@@ -5,6 +5,13 @@
 
 
 
+#include <rlSystem/ExclusionRules.hpp>
+#include <rlSystem/PatternSet.hpp>
+
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -13,6 +20,49 @@
 namespace rlSystem
 {
 
+	/// <summary>Options for copying and moving files and directories.</summary>
+	struct CopyOptions
+	{
+		/// <summary>
+		/// The number of files that are copied at the same time.<para/>
+		/// Zero means the number of hardware threads.
+		/// </summary>
+		unsigned iThreads = 0;
+
+		/// <summary>
+		/// When moving to a different file system: compare the copy to the original before the
+		/// original is deleted?
+		/// </summary>
+		bool bVerify = false;
+
+		/// <summary>
+		/// Files of at least this size are split into chunks of <c>iChunkSize</c> bytes that are
+		/// copied concurrently.
+		/// </summary>
+		uint64_t iLargeFileThreshold = 256 * 1024 * 1024;
+
+		/// <summary>The size of the chunks of large files, in bytes.</summary>
+		uint64_t iChunkSize = 64 * 1024 * 1024;
+
+		/// <summary>
+		/// The number of chunks of a large file that are copied at the same time.<para/>
+		/// Zero means the number of hardware threads.<para/>
+		/// When copying a directory tree with more than one file thread (<c>iThreads</c>), large
+		/// files aren't split, so the total number of threads never exceeds <c>iThreads</c>.
+		/// </summary>
+		unsigned iChunkThreads = 0;
+
+		/// <summary>
+		/// Keep the copied data out of the cache?<para/>
+		/// Meant for bulk transfers that shouldn't evict the cached data of other programs. On
+		/// Linux, the pages are dropped right after they were read/written; on Windows, the
+		/// cache is bypassed.
+		/// </summary>
+		bool bNoCache = false;
+	};
+
+
+
 	namespace File
 	{
 
@@ -29,20 +79,48 @@ namespace rlSystem
 		/// <summary>Move a file to a different path.</summary>
 		/// <param name="szOrigFilePath">The current path of the file.</param>
 		/// <param name="szNewFilePath">The new path of the file.</param>
+		/// <param name="oOptions">
+		/// Only used if <c>szNewFilePath</c> is on a different file system. In that case, the file
+		/// is copied (including its metadata) and deleted afterwards.<para/>
+		/// If such a move was interrupted, the next call continues it.
+		/// </param>
 		/// <returns>
 		/// Was the file successfully moved?<para/>
 		/// Always returns <c>false</c> if <c>szOrigFilePath</c> does not exist as file.
 		/// </returns>
-		bool Move(const char8_t *szOrigFilePath, const char8_t *szNewFilePath);
+		bool Move(const char8_t *szOrigFilePath, const char8_t *szNewFilePath,
+			const CopyOptions &oOptions = {});
 
-		/// <summary>Copy a file.</summary>
+		/// <summary>
+		/// Copy a file, including its permissions and timestamps.<para/>
+		/// On Linux, holes in sparse files are preserved; only the data is actually copied.
+		/// </summary>
 		/// <param name="szOrigFilePath">The path of the original file.</param>
-		/// <param name="szCopyFilePath">The path of the copied file.</param>
+		/// <param name="szCopyFilePath">
+		/// The path of the copied file.<para/>
+		/// If a file already exists at this path, the function fails.
+		/// </param>
+		/// <param name="oOptions">
+		/// Controls how large files are copied; see <c>CopyOptions::iLargeFileThreshold</c>.
+		/// </param>
 		/// <returns>
 		/// Was the file successfully copied?<para/>
 		/// Always returns <c>false</c> if <c>szOrigFilePath</c> does not exist as a file.
 		/// </returns>
-		bool Copy(const char8_t *szOrigFilePath, const char8_t *szCopyFilePath);
+		bool Copy(const char8_t *szOrigFilePath, const char8_t *szCopyFilePath,
+			const CopyOptions &oOptions = {});
+
+		/// <summary>Read a file sequentially, block by block.</summary>
+		/// <param name="fnConsumer">
+		/// Called for every block of data. Return <c>false</c> to stop reading.
+		/// </param>
+		/// <param name="bNoCache">
+		/// Keep the file's data out of the cache? See <c>CopyOptions::bNoCache</c>.
+		/// </param>
+		/// <returns>Was the complete file read?</returns>
+		bool Read(const char8_t *szFilePath,
+			const std::function<bool(const void *pData, size_t iSize)> &fnConsumer,
+			bool bNoCache = false);
 
 		/// <summary>Get the total size of a file, in bytes.</summary>
 		/// <param name="szFilePath">The path of the file to get the filesize of.</param>
@@ -90,13 +168,25 @@ namespace rlSystem
 		/// <summary>Move a directory to a different path.</summary>
 		/// <param name="szOrigDirPath">The current path of the directory.</param>
 		/// <param name="szNewDirPath">The new path of the directory.</param>
+		/// <param name="oOptions">
+		/// Only used if <c>szNewDirPath</c> is on a different file system. In that case, the
+		/// directory tree is copied (including its metadata, using multiple threads) and deleted
+		/// afterwards.<para/>
+		/// If such a move was interrupted, the next call only copies the files that weren't copied
+		/// completely yet.<para/>
+		/// If any part of the tree can't be read, the move fails and the original is kept.
+		/// </param>
 		/// <returns>
 		/// Was the directory successfully moved?<para/>
 		/// Always returns <c>false</c> if <c>szOrigPath</c> does not exist as directory.
 		/// </returns>
-		bool Move(const char8_t *szOrigDirPath, const char8_t *szNewDirPath);
+		bool Move(const char8_t *szOrigDirPath, const char8_t *szNewDirPath,
+			const CopyOptions &oOptions = {});
 
-		/// <summary>Copy a directory.</summary>
+		/// <summary>
+		/// Copy a directory.<para/>
+		/// Only the directory's direct contents are copied; see <c>CopyTree</c> for a deep copy.
+		/// </summary>
 		/// <param name="szOrigDirPath">The path of the original directory.</param>
 		/// <param name="szCopyDirPath">The path of the copied directory.</param>
 		/// <returns>
@@ -105,6 +195,24 @@ namespace rlSystem
 		/// </returns>
 		bool Copy(const char8_t *szOrigDirPath, const char8_t *szCopyDirPath);
 
+		/// <summary>
+		/// Copy a directory tree, including all subdirectories and the metadata of all items.
+		/// <para/>
+		/// The files are copied by multiple threads; symbolic links are copied as links.
+		/// </summary>
+		/// <param name="szOrigDirPath">The path of the original directory.</param>
+		/// <param name="szCopyDirPath">
+		/// The path of the copy. Must not exist yet and must not be inside the original.
+		/// </param>
+		/// <param name="oOptions">Controls how the data is copied.</param>
+		/// <returns>
+		/// Was the directory tree successfully copied?<para/>
+		/// Always returns <c>false</c> if <c>szOrigDirPath</c> does not exist as a directory or
+		/// any of its subdirectories can't be read.
+		/// </returns>
+		bool CopyTree(const char8_t *szOrigDirPath, const char8_t *szCopyDirPath,
+			const CopyOptions &oOptions = {});
+
 		/// <summary>Get a list of files in a directory.</summary>
 		/// <param name="szDirPath">The path of the directory to search.</param>
 		/// <param name="szRegexFilename">
@@ -112,6 +220,12 @@ namespace rlSystem
 		/// returned.<para/>
 		/// If this parameter is <c>nullptr</c> or an empty string, all files will be returned.
 		/// </param>
+		/// <param name="bRegexCaseSensitive">
+		/// Should the expression be matched case-sensitively?<para/>
+		/// If not, names and expression are compared by their Unicode simple case folding, except
+		/// inside bracket expressions and escape sequences, which only ignore the case of ASCII
+		/// letters.
+		/// </param>
 		/// <param name="bRecursive">Should subdirectories also be searched?</param>
 		/// <returns>A list of (absolute) paths of matched files.</returns>
 		std::vector<std::u8string> GetFiles(
@@ -129,6 +243,12 @@ namespace rlSystem
 		/// If this parameter is <c>nullptr</c> or an empty string, all directories will be
 		/// returned.
 		/// </param>
+		/// <param name="bRegexCaseSensitive">
+		/// Should the expression be matched case-sensitively?<para/>
+		/// If not, names and expression are compared by their Unicode simple case folding, except
+		/// inside bracket expressions and escape sequences, which only ignore the case of ASCII
+		/// letters.
+		/// </param>
 		/// <param name="bRecursive">Should subdirectories also be searched?</param>
 		/// <returns>A list of (absolute) paths of matched files.</returns>
 		std::vector<std::u8string> GetDirectories(
@@ -138,6 +258,258 @@ namespace rlSystem
 			      bool     bRecursive
 		);
 
+		/// <summary>A file or directory found by a pattern-based search.</summary>
+		struct PatternMatch
+		{
+			std::u8string sPath;    // the absolute path of the item
+			size_t        iPattern; // the index of the (first) matching pattern
+		};
+
+		/// <summary>Get a list of files in a directory that match any of a set of patterns.</summary>
+		/// <param name="szDirPath">The path of the directory to search.</param>
+		/// <param name="oPatterns">
+		/// The patterns that are matched against the filename. Only matching files are returned.
+		/// <para/>
+		/// All patterns are checked in a single walk, no matter how many there are.
+		/// </param>
+		/// <param name="bRecursive">Should subdirectories also be searched?</param>
+		/// <returns>
+		/// A list of (absolute) paths of matched files, each with the index of the matching pattern.
+		/// <para/>
+		/// Subdirectories that can't be read are skipped.
+		/// </returns>
+		std::vector<PatternMatch> GetFiles(
+			const char8_t    *szDirPath,
+			const PatternSet &oPatterns,
+			      bool        bRecursive
+		);
+
+		/// <summary>
+		/// Get a list of subdirectories in a directory that match any of a set of patterns.
+		/// </summary>
+		/// <param name="szDirPath">The path of the directory to search.</param>
+		/// <param name="oPatterns">
+		/// The patterns that are matched against the directory names. Only matching directories are
+		/// returned.
+		/// </param>
+		/// <param name="bRecursive">Should subdirectories also be searched?</param>
+		/// <returns>
+		/// A list of (absolute) paths of matched directories, each with the index of the matching
+		/// pattern.<para/>
+		/// Subdirectories that can't be read are skipped.
+		/// </returns>
+		std::vector<PatternMatch> GetDirectories(
+			const char8_t    *szDirPath,
+			const PatternSet &oPatterns,
+			      bool        bRecursive
+		);
+
+		/// <summary>A point in time, as used for file modification times.</summary>
+		using FileTime = std::chrono::system_clock::time_point;
+
+		/// <summary>Types of file system items. The values can be combined.</summary>
+		namespace ItemType
+		{
+			constexpr unsigned File      = 0x01;
+			constexpr unsigned Directory = 0x02;
+			constexpr unsigned Symlink   = 0x04; // symbolic links (on Windows: all reparse points)
+			constexpr unsigned Other     = 0x08; // devices, pipes, sockets, ...
+			constexpr unsigned All       = 0x0F;
+		}
+
+		enum class HiddenFilter
+		{
+			Any,         // don't filter by visibility
+			VisibleOnly, // skip hidden items; hidden directories aren't searched at all
+			HiddenOnly   // only report hidden items
+		};
+
+		/// <summary>
+		/// Conditions for the items returned by <c>Enumerate</c>.<para/>
+		/// The filters are applied while walking the directory tree, using the metadata the walk
+		/// gets anyway where possible. Directories that are excluded by <c>iMaxDepth</c>,
+		/// <c>eHidden</c> or exclusion rules are not searched.
+		/// </summary>
+		struct Filter
+		{
+			/// <summary>The item types to report, a combination of <c>ItemType</c> values.</summary>
+			unsigned iTypes = ItemType::File;
+
+			/// <summary>
+			/// Allowed size range of files, in bytes (inclusive). Doesn't affect other item types.
+			/// </summary>
+			uint64_t iMinSize = 0;
+			uint64_t iMaxSize = UINT64_MAX;
+
+			/// <summary>Allowed range of the last modification time (inclusive).</summary>
+			FileTime tMinModified = FileTime::min();
+			FileTime tMaxModified = FileTime::max();
+
+			/// <summary>
+			/// The maximum depth of reported items.<para/>
+			/// 0 means only the items directly inside the searched directory.
+			/// </summary>
+			unsigned iMaxDepth = UINT_MAX;
+
+			/// <summary>Visibility filter, see <c>Path::IsHidden</c>.</summary>
+			HiddenFilter eHidden = HiddenFilter::Any;
+
+			/// <summary>
+			/// If not <c>nullptr</c>, only items with a name matching one of the patterns are
+			/// reported. Doesn't affect which directories are searched.
+			/// </summary>
+			const PatternSet *pPatterns = nullptr;
+
+			/// <summary>
+			/// If not <c>nullptr</c>, items excluded by these rules are not reported; excluded
+			/// directories are not searched at all.
+			/// </summary>
+			const ExclusionRules *pExclusions = nullptr;
+
+			/// <summary>
+			/// If not empty, files with this name (e.g. <c>".gitignore"</c>) are read from every
+			/// searched directory. Their rules apply to the directory's subtree and take
+			/// precedence over those of parent directories and <c>pExclusions</c>, as in Git.
+			/// <para/>
+			/// The rules are case-sensitive unless <c>pExclusions</c> is case-insensitive.
+			/// </summary>
+			std::u8string sIgnoreFileName;
+
+			/// <summary>
+			/// Should <c>Item::iSize</c> and <c>Item::tModified</c> be set even if the filter
+			/// doesn't need them?<para/>
+			/// On some systems, this requires an additional query per item.
+			/// </summary>
+			bool bFetchMetadata = false;
+		};
+
+		/// <summary>An item found by <c>Enumerate</c>.</summary>
+		struct Item
+		{
+			std::u8string sPath;          // absolute path
+			unsigned      iType;          // one of the ItemType values
+			unsigned      iDepth;         // 0 = directly inside the searched directory
+			uint64_t      iSize     = 0;  // only set if the filter needed it or bFetchMetadata
+			FileTime      tModified = {}; // only set if the filter needed it or bFetchMetadata
+			size_t        iPattern  = PatternSet::NoMatch; // the matching pattern, if any
+		};
+
+		/// <summary>Get all items in a directory tree that pass a filter.</summary>
+		/// <param name="szDirPath">The path of the directory to search.</param>
+		/// <param name="oFilter">The conditions for the returned items.</param>
+		/// <returns>
+		/// The matching items, in the order they were found.<para/>
+		/// Symbolic links are reported as such and never followed. Subdirectories that can't be
+		/// read are skipped.
+		/// </returns>
+		std::vector<Item> Enumerate(const char8_t *szDirPath, const Filter &oFilter);
+
+		/// <summary>Walk all items in a directory tree that pass a filter.</summary>
+		/// <param name="szDirPath">The path of the directory to search.</param>
+		/// <param name="oFilter">The conditions for the reported items.</param>
+		/// <param name="fnCallback">
+		/// Called for every matching item. If it returns <c>false</c>, the search is stopped.
+		/// </param>
+		/// <returns>Could the directory be searched?</returns>
+		bool Enumerate(const char8_t *szDirPath, const Filter &oFilter,
+			const std::function<bool(const Item &oItem)> &fnCallback);
+
+		/// <summary>
+		/// Walk all items in a directory tree that pass a filter, sorted by name.<para/>
+		/// The items of every directory are sorted (binary, by their names) before they are
+		/// reported; the contents of a subdirectory are reported directly after the subdirectory
+		/// itself. So the items are reported in the order of their paths, while only the
+		/// directories on the current path have to be kept in memory.
+		/// </summary>
+		/// <param name="szDirPath">The path of the directory to search.</param>
+		/// <param name="oFilter">The conditions for the reported items.</param>
+		/// <param name="fnCallback">
+		/// Called for every matching item. If it returns <c>false</c>, the search is stopped.
+		/// </param>
+		/// <returns>Could the directory be searched?</returns>
+		bool EnumerateSorted(const char8_t *szDirPath, const Filter &oFilter,
+			const std::function<bool(const Item &oItem)> &fnCallback);
+
+		enum class SortKey
+		{
+			Name,     // the name of the item (binary comparison)
+			Size,     // Item::iSize
+			Modified  // Item::tModified
+		};
+
+		/// <summary>
+		/// The first N items of a sequence according to a sort key, collected with memory usage
+		/// proportional to N.<para/>
+		/// When a search is split into multiple partitions, every partition can collect its own
+		/// top items, which are then merged.
+		/// </summary>
+		class TopItems final
+		{
+		public: // methods
+
+			/// <param name="iCount">The maximum number of kept items.</param>
+			/// <param name="eKey">The key to sort by.</param>
+			/// <param name="bDescending">
+			/// Should the highest values be kept (i.e. the largest or newest items)?
+			/// </param>
+			TopItems(size_t iCount, SortKey eKey, bool bDescending);
+
+			/// <summary>Add an item.</summary>
+			/// <returns>Is the item (currently) part of the top items?</returns>
+			bool Add(const Item &oItem);
+
+			/// <summary>Add all items of another list. <c>oOther</c> is empty afterwards.</summary>
+			void Merge(TopItems &&oOther);
+
+			size_t size() const noexcept { return m_oHeap.size(); }
+
+			/// <summary>
+			/// Get the top items, best item first. This object is empty afterwards.<para/>
+			/// Items with the same key are ordered by their paths.
+			/// </summary>
+			std::vector<Item> Take();
+
+
+		private: // methods
+
+			bool Better(const Item &a, const Item &b) const;
+
+
+		private: // variables
+
+			size_t            m_iCount;
+			SortKey           m_eKey;
+			bool              m_bDescending;
+			std::vector<Item> m_oHeap; // the front is the worst item
+		};
+
+		/// <summary>Get the first N items in a directory tree according to a sort key.</summary>
+		/// <param name="szDirPath">The path of the directory to search.</param>
+		/// <param name="oFilter">The conditions for the returned items.</param>
+		/// <param name="eKey">The key to sort by.</param>
+		/// <param name="iCount">The maximum number of returned items.</param>
+		/// <param name="bDescending">
+		/// Should the highest values be returned (i.e. the largest or newest items)?
+		/// </param>
+		/// <param name="iThreads">
+		/// The number of threads to search with. If this is 0, the number of hardware threads is
+		/// used.<para/>
+		/// Every subdirectory of <c>szDirPath</c> is a partition of the search.
+		/// </param>
+		/// <returns>
+		/// Up to <c>iCount</c> items, best item first.<para/>
+		/// The memory used for the search only depends on <c>iCount</c>, not on the number of
+		/// items in the directory tree.
+		/// </returns>
+		std::vector<Item> GetTop(
+			const char8_t *szDirPath,
+			const Filter  &oFilter,
+			      SortKey  eKey,
+			      size_t   iCount,
+			      bool     bDescending = true,
+			      unsigned iThreads    = 1
+		);
+
 		/// <summary>Is a directory readonly?</summary>
 		/// <param name="szDirPath">The path to a directory.</param>
 		/// <returns>
@@ -181,8 +553,13 @@ namespace rlSystem
 		/// <summary>Move a file or directory to a different path.</summary>
 		/// <param name="szOrigPath">The current path of the file or directory.</param>
 		/// <param name="szNewPath">The new path of the file or directory.</param>
+		/// <param name="oOptions">
+		/// Only used if <c>szNewPath</c> is on a different file system.<para/>
+		/// See <c>File::Move</c> and <c>Directory::Move</c>.
+		/// </param>
 		/// <returns>Was the file/directory successfully moved?</returns>
-		bool Move(const char8_t *szOrigPath, const char8_t *szNewPath);
+		bool Move(const char8_t *szOrigPath, const char8_t *szNewPath,
+			const CopyOptions &oOptions = {});
 
 		/// <summary>Copy a file or directory.</summary>
 		/// <param name="szOrigPath">The path of the original file or directory.</param>
@@ -263,13 +640,27 @@ namespace rlSystem
 		std::u8string GetName(const char8_t *szPath);
 
 		/// <summary>Get a path with the actual casing set for it.</summary>
-		/// <param name="szPath">The path of an existing file or directory.</param>
+		/// <param name="szPath">
+		/// The path of an existing file or directory. The casing may differ from the actual one.
+		/// </param>
 		/// <returns>
-		/// On non-Windows system, this function returns the input without further action.<para/>
-		/// On Windows, the return value is <c>szPath</c>, but with the actual casing.
+		/// On Windows, the return value is <c>szPath</c>, but with the actual casing.<para/>
+		/// On other systems, the return value is the absolute version of <c>szPath</c>, with every
+		/// item resolved case-insensitively. If an item exists with the exact casing, it's
+		/// preferred over other items with the same name.<para/>
+		/// If the path can't be resolved, an empty string is returned.<para/>
+		/// On non-Windows systems, the contents of every queried directory are cached, so
+		/// resolving many paths doesn't read the same directory over and over. A directory's
+		/// cached contents are updated once its modification time changes.
 		/// </returns>
 		std::u8string GetCased(const char8_t *szPath);
 
+		/// <summary>
+		/// Clear the directory cache used by <c>GetCased</c>.<para/>
+		/// Does nothing on Windows.
+		/// </summary>
+		void ClearCasingCache();
+
 #ifdef _WIN32
 		/// <summary>
 		/// Expand the environment variables in a string.<para/>
@@ -0,0 +1,153 @@
+#ifndef RLSYSTEM_PATTERNSET
+#define RLSYSTEM_PATTERNSET
+
+
+
+
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+
+
+namespace rlSystem
+{
+
+	/// <summary>
+	/// A set of filename patterns that is matched in a single pass.<para/>
+	/// Every pattern gets an index (the order in which the patterns were added). When matching a
+	/// name, the lowest index of all matching patterns is reported.<para/>
+	/// Extensions and exact names are looked up in hash tables; all globs are combined into one
+	/// bit-parallel automaton, so the cost of a match barely grows with the number of globs.
+	/// </summary>
+	class PatternSet final
+	{
+	public: // static variables
+
+		/// <summary>Returned by <c>Match</c> if no pattern matches.</summary>
+		static constexpr size_t NoMatch = SIZE_MAX;
+
+
+	public: // methods
+
+		/// <param name="bCaseSensitive">
+		/// Should the patterns be matched case-sensitively?<para/>
+		/// If not, names and patterns are compared by their Unicode simple case folding (except
+		/// inside brackets, which only support ASCII characters).
+		/// </param>
+		explicit PatternSet(bool bCaseSensitive = true);
+
+		/// <summary>Add a file extension.</summary>
+		/// <param name="szExtension">
+		/// The extension, with or without leading period (<c>".txt"</c> or <c>"txt"</c>).<para/>
+		/// A name matches if it ends with a period followed by the extension. Multi-part
+		/// extensions like <c>".tar.gz"</c> are supported.
+		/// </param>
+		/// <returns>The index of the new pattern.</returns>
+		size_t AddExtension(const char8_t *szExtension);
+
+		/// <summary>Add an exact name.</summary>
+		/// <returns>The index of the new pattern.</returns>
+		size_t AddName(const char8_t *szName);
+
+		/// <summary>Add a glob.</summary>
+		/// <param name="szGlob">
+		/// A glob pattern that is matched against the whole name:<para/>
+		/// <c>*</c> matches any sequence of characters (including none),<para/>
+		/// <c>?</c> matches exactly one character,<para/>
+		/// <c>[abc]</c>, <c>[a-z]</c> match one of the given characters, <c>[!abc]</c> any other
+		/// character. Only ASCII characters are supported inside brackets.<para/>
+		/// To match a literal <c>*</c>, <c>?</c> or <c>[</c>, enclose it in brackets.
+		/// </param>
+		/// <returns>The index of the new pattern.</returns>
+		size_t AddGlob(const char8_t *szGlob);
+
+		/// <summary>The total number of patterns.</summary>
+		size_t size() const noexcept { return m_iCount; }
+		bool empty() const noexcept { return m_iCount == 0; }
+
+		bool caseSensitive() const noexcept { return m_bCaseSensitive; }
+
+		/// <summary>Match a filename against all patterns.</summary>
+		/// <param name="sName">A filename, without directory.</param>
+		/// <returns>
+		/// The lowest index of all matching patterns.<para/>
+		/// If no pattern matches, the return value is <c>NoMatch</c>.
+		/// </returns>
+		size_t Match(std::u8string_view sName) const;
+
+
+	private: // types
+
+		using Word = uint64_t;
+
+		/// <summary>Allows looking up <c>std::u8string_view</c>s without creating a string.</summary>
+		struct StringHash
+		{
+			using is_transparent = void;
+
+			size_t operator()(std::u8string_view s) const noexcept
+			{
+				return std::hash<std::u8string_view>{}(s);
+			}
+		};
+
+		using StringMap = std::unordered_map<std::u8string, size_t, StringHash, std::equal_to<>>;
+
+		struct GlobInfo
+		{
+			size_t iPattern;    // index of the pattern
+			size_t iAcceptBit;  // bit that's set once the glob matched completely
+		};
+
+
+	private: // methods
+
+		std::u8string Normalize(std::u8string_view s) const;
+
+		size_t MatchGlobs(std::u8string_view sName) const;
+
+		/// <summary>Allocate a new state bit of the glob automaton.</summary>
+		size_t AddState();
+
+
+	private: // variables
+
+		bool   m_bCaseSensitive;
+		size_t m_iCount = 0;
+
+		// extension (without leading period) --> pattern index
+		StringMap m_oExtensions;
+		size_t m_iMaxExtensionLen = 0;
+
+		// exact name --> pattern index
+		StringMap m_oNames;
+
+
+
+		// Glob automaton (Shift-And):
+		// Every glob with n tokens occupies n + 1 consecutive state bits; bit k means "the first k
+		// tokens matched". For every byte c, a state bit is reached from its predecessor if
+		// m_oShift[c] contains it, and stays active if m_oLoop[c] contains it.
+
+		size_t               m_iStates = 0;
+		std::vector<Word>    m_oInitial;       // active states before the first byte
+		std::vector<Word>    m_oShift[256];
+		std::vector<Word>    m_oLoop[256];
+		std::vector<Word>    m_oEpsilon;       // states that also activate their successor
+		std::vector<Word>    m_oAccept;
+		std::vector<GlobInfo> m_oGlobs;
+
+	};
+
+}
+
+
+
+
+
+#endif // RLSYSTEM_PATTERNSET
\ No newline at end of file
@@ -0,0 +1,79 @@
+#ifndef RLSYSTEM_PIPELINE
+#define RLSYSTEM_PIPELINE
+
+
+
+
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+
+namespace rlSystem
+{
+
+	/// <summary>A console application in a pipeline.</summary>
+	struct PipelineStage
+	{
+		/// <summary>The path of the executable.</summary>
+		std::u8string sAppPath;
+
+		/// <summary>The arguments for the application.</summary>
+		std::u8string sArgs;
+
+		/// <summary>
+		/// The working directory for the application.<para/>
+		/// If this value is empty, the working directory of the current application is used.
+		/// </summary>
+		std::u8string sCurrentDir;
+	};
+
+	struct PipelineOptions
+	{
+		/// <summary>
+		/// A file that's passed to <c>stdin</c> of the first stage.<para/>
+		/// If empty, the first stage inherits <c>stdin</c> of the current application.
+		/// </summary>
+		std::u8string sInputFile;
+
+		/// <summary>
+		/// A file that receives the <c>stdout</c> output of the last stage. If a file already
+		/// exists at the given path, it's cleared first.<para/>
+		/// If neither this nor <c>fnOutput</c> is set, the last stage inherits <c>stdout</c> of
+		/// the current application.
+		/// </summary>
+		std::u8string sOutputFile;
+
+		/// <summary>
+		/// Called for every chunk of <c>stdout</c> output of the last stage as soon as it's
+		/// received. Can be combined with <c>sOutputFile</c>.
+		/// </summary>
+		std::function<void(std::string_view sData)> fnOutput;
+	};
+
+	/// <summary>
+	/// Run console applications as a pipeline (<c>a | b | c</c>): the <c>stdout</c> output of
+	/// every stage is passed to <c>stdin</c> of the next one. All stages run at the same time;
+	/// <c>stderr</c> is inherited.<para/>
+	/// The data between the stages never passes through the current application. On Linux, if
+	/// the output goes both to a file and to <c>fnOutput</c>, it's duplicated in the kernel
+	/// (<c>tee</c>) and moved to the file without copying it (<c>splice</c>).
+	/// </summary>
+	/// <param name="pExitCodes">
+	/// If this value is not <c>nullptr</c>, the pointed-to vector will receive the exit codes
+	/// of the stages that were started.
+	/// </param>
+	/// <returns>Could all stages be executed?</returns>
+	bool RunPipeline(const std::vector<PipelineStage> &oStages,
+		const PipelineOptions &oOptions = {}, std::vector<int> *pExitCodes = nullptr);
+
+}
+
+
+
+
+
+#endif // RLSYSTEM_PIPELINE
\ No newline at end of file
@@ -0,0 +1,117 @@
+#ifndef RLSYSTEM_PREFETCHER
+#define RLSYSTEM_PREFETCHER
+
+
+
+
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+
+namespace rlSystem
+{
+
+	struct PrefetchOptions
+	{
+		/// <summary>The number of files that are prefetched ahead of the consumer at first.</summary>
+		unsigned iInitialWindow = 8;
+
+		/// <summary>The limits of the window when it's adapted.</summary>
+		unsigned iMinWindow = 2;
+		unsigned iMaxWindow = 256;
+
+		/// <summary>
+		/// The maximum number of bytes that were prefetched but not consumed yet.<para/>
+		/// The file directly after the consumer is always prefetched, even if it's larger.
+		/// </summary>
+		uint64_t iMaxBytesInFlight = 256 * 1024 * 1024;
+
+		/// <summary>
+		/// Adapt the window to the rate at which the files are consumed?<para/>
+		/// If the consumer catches up with the prefetcher, the window grows. If files are
+		/// prefetched much longer than <c>tTargetLead</c> before they're consumed, it shrinks, so
+		/// prefetched data isn't evicted from the cache again before it's read.
+		/// </summary>
+		bool bAdaptive = true;
+
+		std::chrono::milliseconds tTargetLead = std::chrono::milliseconds(500);
+	};
+
+	/// <summary>
+	/// Reads files ahead of a consumer that processes a list of files in order, e.g. the result
+	/// of <c>Directory::GetFiles</c>.<para/>
+	/// A background thread asks the kernel to load the next files into the page cache
+	/// (<c>posix_fadvise(POSIX_FADV_WILLNEED)</c>), so opening and reading them doesn't stall on
+	/// a cold cache.<para/>
+	/// Only has an effect on Linux; elsewhere, it just returns the paths.
+	/// </summary>
+	class Prefetcher final
+	{
+	public: // methods
+
+		/// <param name="oPaths">The files, in the order they will be consumed.</param>
+		explicit Prefetcher(std::vector<std::u8string> oPaths, const PrefetchOptions &oOptions = {});
+
+		Prefetcher(const Prefetcher &) = delete;
+		Prefetcher &operator=(const Prefetcher &) = delete;
+
+		~Prefetcher();
+
+		/// <summary>
+		/// Get the next file to consume. Also tells the prefetcher that the previous file was
+		/// consumed.
+		/// </summary>
+		/// <returns>
+		/// The path of the next file.<para/>
+		/// If all files were consumed, the return value is <c>nullptr</c>.
+		/// </returns>
+		const std::u8string *Next();
+
+		/// <summary>The total number of files.</summary>
+		size_t size() const noexcept { return m_oPaths.size(); }
+
+		/// <summary>The current number of files that are prefetched ahead of the consumer.</summary>
+		unsigned window() const;
+
+
+	private: // methods
+
+		void Run();
+
+
+	private: // variables
+
+		const std::vector<std::u8string> m_oPaths;
+		const PrefetchOptions            m_oOptions;
+
+		mutable std::mutex      m_mux;
+		std::condition_variable m_cv;
+
+		// index --> prefetched bytes and the time the prefetch was issued
+		std::vector<uint64_t>                              m_oSizes;
+		std::vector<std::chrono::steady_clock::time_point> m_oIssueTimes;
+
+		size_t   m_iNext          = 0; // index of the file returned by the next call to Next()
+		size_t   m_iIssued        = 0; // all files before this index were prefetched (or skipped)
+		uint64_t m_iBytesInFlight = 0;
+		unsigned m_iWindow;
+		bool     m_bStop          = false;
+
+		std::thread m_oThread;
+
+	};
+
+}
+
+
+
+
+
+#endif // RLSYSTEM_PREFETCHER
\ No newline at end of file
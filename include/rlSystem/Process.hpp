@@ -0,0 +1,178 @@
+#ifndef RLSYSTEM_PROCESS
+#define RLSYSTEM_PROCESS
+
+
+
+
+
+#include <chrono>
+#include <cstdint>
+
+
+
+namespace rlSystem
+{
+
+	namespace Internal
+	{
+		struct ProcessAccess;
+	}
+
+	/// <summary>The resources used by a child process.</summary>
+	struct ResourceUsage
+	{
+		/// <summary>The time from starting the process until it was found to have ended.</summary>
+		std::chrono::nanoseconds tWall{};
+
+		/// <summary>The CPU time spent in user mode.</summary>
+		std::chrono::nanoseconds tUser{};
+
+		/// <summary>The CPU time spent in kernel mode.</summary>
+		std::chrono::nanoseconds tSystem{};
+
+		/// <summary>The peak resident set size (peak working set on Windows), in bytes.</summary>
+		uint64_t iPeakRSS = 0;
+
+		/// <summary>
+		/// The number of context switches because the process waited (e.g. for I/O), and because
+		/// it was preempted.<para/>
+		/// Linux only, zero on Windows.
+		/// </summary>
+		uint64_t iVoluntaryContextSwitches   = 0;
+		uint64_t iInvoluntaryContextSwitches = 0;
+
+		/// <summary>
+		/// The number of bytes read and written via system calls, including cached data, pipes
+		/// and sockets.
+		/// </summary>
+		uint64_t iReadBytes  = 0;
+		uint64_t iWriteBytes = 0;
+
+		/// <summary>
+		/// The number of bytes actually read from and written to storage devices.<para/>
+		/// Linux only, zero on Windows.
+		/// </summary>
+		uint64_t iStorageReadBytes  = 0;
+		uint64_t iStorageWriteBytes = 0;
+	};
+
+	/// <summary>
+	/// A running (or finished) child process, started via <c>RunApp</c>.<para/>
+	/// Waiting never requires a thread per process: <c>handle()</c> can be added to an event loop
+	/// (<c>epoll</c>/<c>poll</c> on Linux, <c>WaitForMultipleObjects</c> on Windows), which
+	/// reports the process as readable/signaled when it has ended. Then, <c>TryWait</c> returns
+	/// the exit code.<para/>
+	/// If the object is destroyed before the process was waited for, the process keeps running
+	/// and is reaped in the background (by a single thread for all such processes).
+	/// </summary>
+	class Process final
+	{
+	public: // types
+
+#ifdef _WIN32
+		/// <summary>The process handle (<c>HANDLE</c>).</summary>
+		using NativeHandle = void *;
+#else
+		/// <summary>
+		/// A <c>pidfd</c> file descriptor, or -1 if the kernel doesn't support them (before 5.3).
+		/// </summary>
+		using NativeHandle = int;
+#endif
+
+
+	public: // methods
+
+		/// <summary>Create an invalid object.</summary>
+		Process() noexcept = default;
+
+		Process(Process &&other) noexcept;
+		Process &operator=(Process &&other) noexcept;
+
+		Process(const Process &) = delete;
+		Process &operator=(const Process &) = delete;
+
+		~Process();
+
+		/// <summary>Does the object refer to a process?</summary>
+		bool valid() const noexcept;
+		explicit operator bool() const noexcept { return valid(); }
+
+		/// <summary>The ID of the process, or zero.</summary>
+		int id() const noexcept { return m_iID; }
+
+		/// <summary>
+		/// The OS object to wait for. Owned by this object; don't close it.
+		/// </summary>
+		NativeHandle handle() const noexcept { return m_hHandle; }
+
+		/// <summary>Has the process ended? Doesn't block.</summary>
+		/// <param name="pExitCode">
+		/// If this value is not <c>nullptr</c> and the process has ended, the pointed-to variable
+		/// receives its exit code. On Linux, if the process was terminated by a signal, the exit
+		/// code is 128 + the signal number.
+		/// </param>
+		bool TryWait(int *pExitCode = nullptr);
+
+		/// <summary>Wait until the process has ended or a timeout has elapsed.</summary>
+		/// <param name="pExitCode">See <c>TryWait</c>.</param>
+		/// <returns>Has the process ended?</returns>
+		bool WaitFor(std::chrono::milliseconds tTimeout, int *pExitCode = nullptr);
+
+		/// <summary>Wait until the process has ended.</summary>
+		/// <returns>The exit code of the process (see <c>TryWait</c>), or -1 on error.</returns>
+		int Wait();
+
+		/// <summary>
+		/// Terminate the process immediately (<c>SIGKILL</c> on Linux, <c>TerminateProcess</c>
+		/// on Windows). It must still be waited for.
+		/// </summary>
+		/// <returns>
+		/// Could the process be terminated? Also <c>true</c> if it has already ended.
+		/// </returns>
+		bool Kill();
+
+		/// <summary>
+		/// The resources used by the process. Only available after it was waited for; zero
+		/// before. On Linux, this includes all children of the process that it waited for.
+		/// </summary>
+		const ResourceUsage &usage() const noexcept { return m_oUsage; }
+
+
+	private: // methods
+
+		friend struct Internal::ProcessAccess;
+
+		Process(int iID, NativeHandle hHandle,
+			std::chrono::steady_clock::time_point tpStart) noexcept :
+			m_iID(iID), m_hHandle(hHandle), m_tpStart(tpStart) {}
+
+		/// <summary>Record that the process has ended.</summary>
+		void finish(int iExitCode) noexcept;
+
+		/// <summary>Release everything without waiting for the process.</summary>
+		void reset() noexcept;
+
+
+	private: // variables
+
+		int          m_iID       = 0;
+#ifdef _WIN32
+		NativeHandle m_hHandle   = nullptr;
+#else
+		NativeHandle m_hHandle   = -1;
+#endif
+		bool         m_bFinished = false;
+		int          m_iExitCode = -1;
+
+		std::chrono::steady_clock::time_point m_tpStart;
+		ResourceUsage                         m_oUsage;
+
+	};
+
+}
+
+
+
+
+
+#endif // RLSYSTEM_PROCESS
\ No newline at end of file
@@ -0,0 +1,110 @@
+#ifndef RLSYSTEM_PROCESSBATCH
+#define RLSYSTEM_PROCESSBATCH
+
+
+
+
+
+#include <rlSystem/AppExecution.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+
+
+namespace rlSystem
+{
+
+	/// <summary>A console application to run as part of a batch.</summary>
+	struct ProcessJob
+	{
+		/// <summary>The path of the executable.</summary>
+		std::u8string sAppPath;
+
+		/// <summary>The arguments for the application.</summary>
+		std::u8string sArgs;
+
+		/// <summary>
+		/// The working directory for the application.<para/>
+		/// If this value is empty, the working directory of the current application is used.
+		/// </summary>
+		std::u8string sCurrentDir;
+
+		/// <summary>
+		/// Jobs with a higher priority are started first. Jobs with the same priority are started
+		/// in the order they were passed.
+		/// </summary>
+		int iPriority = 0;
+
+		/// <summary>
+		/// Should the output be captured?<para/>
+		/// If <c>false</c>, the application writes to the console of the current application.
+		/// </summary>
+		bool bCapture = true;
+
+		/// <summary>How the output is captured, if <c>bCapture</c> is <c>true</c>.</summary>
+		CaptureOptions oCapture;
+	};
+
+	/// <summary>The result of a <c>ProcessJob</c>.</summary>
+	struct ProcessJobResult
+	{
+		/// <summary>Could the application be executed?</summary>
+		bool bStarted = false;
+
+		/// <summary>Was the job skipped because another job failed (see <c>bFailFast</c>)?</summary>
+		bool bCancelled = false;
+
+		int iExitCode = -1;
+
+		/// <summary>The time from starting the application until it ended.</summary>
+		std::chrono::nanoseconds tDuration{};
+
+		CapturedOutput oOutput;
+
+		/// <summary>The resources used by the application.</summary>
+		ResourceUsage oUsage;
+
+		/// <summary>Did the job succeed (i.e. did it run and return zero)?</summary>
+		bool succeeded() const noexcept { return bStarted && iExitCode == 0; }
+	};
+
+	struct BatchOptions
+	{
+		/// <summary>
+		/// The maximum number of applications running at the same time.<para/>
+		/// Zero means the number of hardware threads.
+		/// </summary>
+		unsigned iMaxParallel = 0;
+
+		/// <summary>
+		/// Stop starting jobs as soon as one job failed? Jobs that are already running are
+		/// waited for; the others are marked as cancelled.
+		/// </summary>
+		bool bFailFast = false;
+
+		/// <summary>
+		/// Called whenever a job ended, in the order the jobs end. Calls are never concurrent.
+		/// <para/>
+		/// The first parameter is the index of the job.
+		/// </summary>
+		std::function<void(size_t iJob, const ProcessJobResult &oResult)> fnFinished;
+	};
+
+	/// <summary>
+	/// Run a batch of independent console applications, several of them at once.
+	/// </summary>
+	/// <returns>The results, in the same order as the jobs.</returns>
+	std::vector<ProcessJobResult> RunBatch(const std::vector<ProcessJob> &oJobs,
+		const BatchOptions &oOptions = {});
+
+}
+
+
+
+
+
+#endif // RLSYSTEM_PROCESSBATCH
\ No newline at end of file
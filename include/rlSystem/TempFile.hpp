@@ -0,0 +1,137 @@
+#ifndef RLSYSTEM_TEMPFILE
+#define RLSYSTEM_TEMPFILE
+
+
+
+
+
+#include <cstdio>
+#include <string>
+
+
+
+namespace rlSystem
+{
+
+	/// <summary>
+	/// A temporary file that's deleted when the object is destroyed, unless it was published.
+	/// <para/>
+	/// On Linux, the file is created via <c>O_TMPFILE</c> if the file system supports it: it has
+	/// no name until it's published, so it disappears even if the process crashes. Otherwise,
+	/// a file with a random name is created exclusively, so there's no race with other
+	/// processes and no separate existence check.<para/>
+	/// The file is only accessible by its owner.
+	/// </summary>
+	class TempFile final
+	{
+	public: // methods
+
+		/// <summary>Create a temporary file. Check <c>valid()</c> to see if this succeeded.</summary>
+		/// <param name="szDirPath">
+		/// The directory to create the file in.<para/>
+		/// If this is <c>nullptr</c>, the system's temporary directory is used.
+		/// </param>
+		explicit TempFile(const char8_t *szDirPath = nullptr);
+
+		TempFile(TempFile &&other) noexcept;
+		TempFile &operator=(TempFile &&other) noexcept;
+
+		TempFile(const TempFile &) = delete;
+		TempFile &operator=(const TempFile &) = delete;
+
+		~TempFile();
+
+		/// <summary>Is there an open temporary file?</summary>
+		bool valid() const noexcept { return m_pFile != nullptr; }
+		explicit operator bool() const noexcept { return valid(); }
+
+		/// <summary>
+		/// The file, opened for reading and writing. Owned by this object; don't close it.
+		/// </summary>
+		FILE *file() const noexcept { return m_pFile; }
+
+		/// <summary>
+		/// The current path of the file.<para/>
+		/// Empty if the file doesn't have a name (yet).
+		/// </summary>
+		const std::u8string &path() const noexcept { return m_sPath; }
+
+		/// <summary>
+		/// Give the file its final name. On success, the file is closed and kept; the object
+		/// is invalid afterwards.
+		/// </summary>
+		/// <param name="szFilePath">
+		/// The final path of the file. Must be on the same file system as the temporary file.
+		/// </param>
+		/// <param name="bReplace">May an existing file at <c>szFilePath</c> be replaced?</param>
+		/// <returns>Was the file published?</returns>
+		bool Publish(const char8_t *szFilePath, bool bReplace = false);
+
+		/// <summary>Close and delete the file. The object is invalid afterwards.</summary>
+		void Discard() noexcept;
+
+
+	private: // variables
+
+		FILE         *m_pFile = nullptr;
+		std::u8string m_sPath;
+
+	};
+
+
+
+	/// <summary>
+	/// A temporary directory that's deleted, including its contents, when the object is
+	/// destroyed.<para/>
+	/// The directory gets a random name and is created exclusively.
+	/// </summary>
+	class TempDirectory final
+	{
+	public: // methods
+
+		/// <summary>
+		/// Create a temporary directory. Check <c>valid()</c> to see if this succeeded.
+		/// </summary>
+		/// <param name="szParentDirPath">
+		/// The directory to create the temporary directory in.<para/>
+		/// If this is <c>nullptr</c>, the system's temporary directory is used.
+		/// </param>
+		explicit TempDirectory(const char8_t *szParentDirPath = nullptr);
+
+		TempDirectory(TempDirectory &&other) noexcept;
+		TempDirectory &operator=(TempDirectory &&other) noexcept;
+
+		TempDirectory(const TempDirectory &) = delete;
+		TempDirectory &operator=(const TempDirectory &) = delete;
+
+		~TempDirectory();
+
+		bool valid() const noexcept { return !m_sPath.empty(); }
+		explicit operator bool() const noexcept { return valid(); }
+
+		/// <summary>The absolute path of the directory.</summary>
+		const std::u8string &path() const noexcept { return m_sPath; }
+
+		/// <summary>
+		/// Keep the directory: it won't be deleted. The object is invalid afterwards.
+		/// </summary>
+		/// <returns>The path of the directory.</returns>
+		std::u8string Release() noexcept;
+
+		/// <summary>Delete the directory. The object is invalid afterwards.</summary>
+		void Discard() noexcept;
+
+
+	private: // variables
+
+		std::u8string m_sPath;
+
+	};
+
+}
+
+
+
+
+
+#endif // RLSYSTEM_TEMPFILE
\ No newline at end of file
@@ -0,0 +1,129 @@
+#ifndef RLSYSTEM_UNICODECASEFOLDING
+#define RLSYSTEM_UNICODECASEFOLDING
+
+
+
+
+
+#include <rlSystem/UnicodeTranscoding.hpp>
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+
+
+namespace rlSystem
+{
+
+	/// <summary>
+	/// Case-insensitive comparison and hashing of UTF-8 strings, e.g. paths.<para/>
+	/// Characters are compared by their simple case folding (one code point to one code point,
+	/// as used by case-insensitive file systems). Runs of ASCII characters are folded and
+	/// compared 16 characters at a time (SSE2 on x86/x64, NEON on ARM64); only other characters
+	/// are decoded and looked up in the Unicode table.<para/>
+	/// Invalid bytes are kept as they are: they only equal themselves and are ordered after all
+	/// valid characters.
+	/// </summary>
+	namespace Unicode
+	{
+
+		/// <summary>
+		/// The maximum length of the folded version of a UTF-8 string of the given length.<para/>
+		/// (A few two-byte characters fold to three-byte characters.)
+		/// </summary>
+		constexpr size_t MaxFoldedLength(size_t iLength) noexcept { return iLength + iLength / 2; }
+
+		/// <summary>Get the simple case folding of a code point.</summary>
+		char32_t FoldCase(char32_t c) noexcept;
+
+		/// <summary>Casefold a UTF-8 string.</summary>
+		/// <param name="pDest">
+		/// Receives the result. Must have room for <c>MaxFoldedLength(s.length())</c> code units.
+		/// No terminating zero is written.
+		/// </param>
+		/// <returns>The number of code units written.</returns>
+		size_t FoldCase(std::u8string_view s, char8_t *pDest) noexcept;
+
+		/// <summary>Casefold a UTF-8 string.</summary>
+		std::u8string FoldCase(std::u8string_view s);
+
+		/// <summary>
+		/// Casefold a UTF-8 string, without allocating if the result fits into the inline buffer.
+		/// </summary>
+		/// <returns>The zero-terminated result.</returns>
+		template <size_t iInlineLength>
+		const char8_t *FoldCase(std::u8string_view s, InlineString<char8_t, iInlineLength> &oDest)
+		{
+			char8_t *p = oDest.reserve(MaxFoldedLength(s.length()));
+			oDest.setLength(FoldCase(s, p));
+			return oDest.c_str();
+		}
+
+		/// <summary>Compare two UTF-8 strings, ignoring the case.</summary>
+		/// <returns>
+		/// A negative value if <c>s1</c> comes first, a positive value if <c>s2</c> comes first,
+		/// zero if they're equal.<para/>
+		/// The order is that of the casefolded code points.
+		/// </returns>
+		int CompareNoCase(std::u8string_view s1, std::u8string_view s2) noexcept;
+
+		/// <summary>Are two UTF-8 strings equal, ignoring the case?</summary>
+		bool EqualNoCase(std::u8string_view s1, std::u8string_view s2) noexcept;
+
+		/// <summary>Does a UTF-8 string start with another one, ignoring the case?</summary>
+		bool StartsWithNoCase(std::u8string_view s, std::u8string_view sPrefix) noexcept;
+
+		/// <summary>
+		/// Get a hash of a UTF-8 string that ignores the case: strings that are equal according
+		/// to <c>EqualNoCase</c> have the same hash.
+		/// </summary>
+		size_t HashNoCase(std::u8string_view s) noexcept;
+
+		/// <summary>
+		/// A hash for case-insensitive hash tables, e.g.
+		/// <c>std::unordered_map&lt;std::u8string, T, NoCaseHash, NoCaseEqual&gt;</c>.<para/>
+		/// Allows looking up <c>std::u8string_view</c>s without creating a string.
+		/// </summary>
+		struct NoCaseHash
+		{
+			using is_transparent = void;
+
+			size_t operator()(std::u8string_view s) const noexcept { return HashNoCase(s); }
+		};
+
+		/// <summary>The equality to use together with <c>NoCaseHash</c>.</summary>
+		struct NoCaseEqual
+		{
+			using is_transparent = void;
+
+			bool operator()(std::u8string_view s1, std::u8string_view s2) const noexcept
+			{
+				return EqualNoCase(s1, s2);
+			}
+		};
+
+
+
+		/// <summary>
+		/// Character-by-character implementations with the same results, as a reference for tests
+		/// and benchmarks.
+		/// </summary>
+		namespace Reference
+		{
+
+			size_t FoldCase(std::u8string_view s, char8_t *pDest) noexcept;
+
+			int CompareNoCase(std::u8string_view s1, std::u8string_view s2) noexcept;
+
+		}
+
+	}
+
+}
+
+
+
+
+
+#endif // RLSYSTEM_UNICODECASEFOLDING
\ No newline at end of file
@@ -0,0 +1,197 @@
+#ifndef RLSYSTEM_UNICODETRANSCODING
+#define RLSYSTEM_UNICODETRANSCODING
+
+
+
+
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+
+
+
+namespace rlSystem
+{
+
+	/// <summary>
+	/// Conversion between UTF-8 and UTF-16, on all platforms.<para/>
+	/// Strings are converted in a single pass into a buffer of the maximum possible size. Runs
+	/// of ASCII characters are converted 16 characters at a time (SSE2 on x86/x64, NEON on
+	/// ARM64).<para/>
+	/// Invalid input is replaced by U+FFFD: in UTF-8, once per maximal subpart of an
+	/// ill-formed sequence; in UTF-16, once per unpaired surrogate. This matches
+	/// <c>MultiByteToWideChar</c>/<c>WideCharToMultiByte</c>.
+	/// </summary>
+	namespace Unicode
+	{
+
+		/// <summary>
+		/// The maximum number of UTF-16 code units needed for a UTF-8 string of the given length.
+		/// </summary>
+		constexpr size_t MaxUTF16Length(size_t iUTF8Length) noexcept { return iUTF8Length; }
+
+		/// <summary>
+		/// The maximum number of UTF-8 code units needed for a UTF-16 string of the given length.
+		/// </summary>
+		constexpr size_t MaxUTF8Length(size_t iUTF16Length) noexcept { return iUTF16Length * 3; }
+
+		/// <summary>Convert a UTF-8 string to UTF-16.</summary>
+		/// <param name="pDest">
+		/// Receives the result. Must have room for <c>MaxUTF16Length(sUTF8.length())</c> code
+		/// units. No terminating zero is written.
+		/// </param>
+		/// <param name="pValid">
+		/// If this value is not <c>nullptr</c>, the pointed-to variable receives whether the input
+		/// was valid UTF-8.
+		/// </param>
+		/// <returns>The number of code units written.</returns>
+		size_t UTF8ToUTF16(std::u8string_view sUTF8, char16_t *pDest,
+			bool *pValid = nullptr) noexcept;
+
+		/// <summary>Convert a UTF-16 string to UTF-8.</summary>
+		/// <param name="pDest">
+		/// Receives the result. Must have room for <c>MaxUTF8Length(sUTF16.length())</c> code
+		/// units. No terminating zero is written.
+		/// </param>
+		/// <param name="pValid">
+		/// If this value is not <c>nullptr</c>, the pointed-to variable receives whether the input
+		/// was valid UTF-16.
+		/// </param>
+		/// <returns>The number of code units written.</returns>
+		size_t UTF16ToUTF8(std::u16string_view sUTF16, char8_t *pDest,
+			bool *pValid = nullptr) noexcept;
+
+		/// <summary>Convert a UTF-8 string to UTF-16.</summary>
+		std::u16string ToUTF16(std::u8string_view sUTF8);
+
+		/// <summary>Convert a UTF-16 string to UTF-8.</summary>
+		std::u8string ToUTF8(std::u16string_view sUTF16);
+
+
+
+		/// <summary>
+		/// A zero-terminated string with an inline buffer, for converted paths that are only
+		/// needed for a single call.<para/>
+		/// Strings of up to <c>iInlineLength</c> characters are stored inside the object; only
+		/// longer ones are stored on the heap.
+		/// </summary>
+		template <typename TChar, size_t iInlineLength = 512>
+		class InlineString final
+		{
+		public: // methods
+
+			InlineString() noexcept { m_szInline[0] = 0; }
+
+			InlineString(const InlineString &) = delete;
+			InlineString &operator=(const InlineString &) = delete;
+
+			/// <summary>
+			/// Get a buffer for a string of up to <c>iLength</c> characters (plus the terminating
+			/// zero).<para/>
+			/// The previous content is discarded; <c>setLength</c> must be called afterwards.
+			/// </summary>
+			TChar *reserve(size_t iLength)
+			{
+				if (iLength <= iInlineLength)
+					m_sz = m_szInline;
+				else
+				{
+					if (iLength > m_iHeapLength)
+					{
+						m_up_szHeap   = std::make_unique_for_overwrite<TChar[]>(iLength + 1);
+						m_iHeapLength = iLength;
+					}
+					m_sz = m_up_szHeap.get();
+				}
+
+				m_iLength = 0;
+				m_sz[0]   = 0;
+				return m_sz;
+			}
+
+			/// <summary>
+			/// Set the length of the string that was written to the buffer returned by
+			/// <c>reserve</c>. Adds the terminating zero.
+			/// </summary>
+			void setLength(size_t iLength) noexcept
+			{
+				m_iLength     = iLength;
+				m_sz[iLength] = 0;
+			}
+
+			const TChar *c_str() const noexcept { return m_sz; }
+			size_t length() const noexcept { return m_iLength; }
+			std::basic_string_view<TChar> view() const noexcept { return { m_sz, m_iLength }; }
+
+			/// <summary>Is the string stored inside the object?</summary>
+			bool isInline() const noexcept { return m_sz == m_szInline; }
+
+
+		private: // variables
+
+			TChar                    m_szInline[iInlineLength + 1];
+			std::unique_ptr<TChar[]> m_up_szHeap;
+			size_t                   m_iHeapLength = 0;
+			TChar                   *m_sz          = m_szInline;
+			size_t                   m_iLength     = 0;
+
+		};
+
+		/// <summary>
+		/// Convert a UTF-8 string to UTF-16, without allocating if the result fits into the inline
+		/// buffer.
+		/// </summary>
+		/// <returns>The zero-terminated result.</returns>
+		template <size_t iInlineLength>
+		const char16_t *ToUTF16(std::u8string_view sUTF8,
+			InlineString<char16_t, iInlineLength> &oDest)
+		{
+			char16_t *p = oDest.reserve(MaxUTF16Length(sUTF8.length()));
+			oDest.setLength(UTF8ToUTF16(sUTF8, p));
+			return oDest.c_str();
+		}
+
+		/// <summary>
+		/// Convert a UTF-16 string to UTF-8, without allocating if the result fits into the inline
+		/// buffer.<para/>
+		/// As room for the maximum length is reserved, that's the case for up to a third of
+		/// <c>iInlineLength</c> characters.
+		/// </summary>
+		/// <returns>The zero-terminated result.</returns>
+		template <size_t iInlineLength>
+		const char8_t *ToUTF8(std::u16string_view sUTF16,
+			InlineString<char8_t, iInlineLength> &oDest)
+		{
+			char8_t *p = oDest.reserve(MaxUTF8Length(sUTF16.length()));
+			oDest.setLength(UTF16ToUTF8(sUTF16, p));
+			return oDest.c_str();
+		}
+
+
+
+		/// <summary>
+		/// Character-by-character implementations with the same results, as a reference for tests
+		/// and benchmarks.
+		/// </summary>
+		namespace Reference
+		{
+
+			size_t UTF8ToUTF16(std::u8string_view sUTF8, char16_t *pDest,
+				bool *pValid = nullptr) noexcept;
+
+			size_t UTF16ToUTF8(std::u16string_view sUTF16, char8_t *pDest,
+				bool *pValid = nullptr) noexcept;
+
+		}
+
+	}
+
+}
+
+
+
+
+
+#endif // RLSYSTEM_UNICODETRANSCODING
\ No newline at end of file
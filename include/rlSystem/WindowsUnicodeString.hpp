@@ -7,6 +7,8 @@
 
 
 
+#include <rlSystem/UnicodeTranscoding.hpp>
+
 #include <memory>
 #include <string>
 
@@ -21,9 +23,19 @@ namespace rlSystem
 		using OSChar   = wchar_t;
 		using OSString = std::wstring;
 
+		/// <summary>A buffer for converted strings (see <c>Unicode::InlineString</c>).</summary>
+		using OSBuffer = Unicode::InlineString<OSChar>;
+
 		/// <summary>Convert a UTF-8 string to a Windows UTF-16 string.</summary>
 		OSString ToOS(const char8_t *szUTF8) noexcept;
 
+		/// <summary>
+		/// Convert a UTF-8 string to a Windows UTF-16 string, without allocating if it's short
+		/// enough for the inline buffer (i.e. for most paths).
+		/// </summary>
+		/// <returns>The zero-terminated result, stored in <c>oBuffer</c>.</returns>
+		const OSChar *ToOS(const char8_t *szUTF8, OSBuffer &oBuffer) noexcept;
+
 		/// <summary>Convert a Windows UTF-16 string to a UTF-8 string.</summary>
 		std::u8string FromOS(const OSChar *szOS) noexcept;
 
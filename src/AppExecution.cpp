@@ -1,38 +1,285 @@
 #include <rlSystem/AppExecution.hpp>
 
+#include "include/ProcessSpawn.hpp"
+
 #include <rlSystem/WindowsUnicodeString.hpp>
 #include "include/IncludeWindows.h"
 
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#ifndef _WIN32
+#include <string_view>
+
+#include <fcntl.h>
+#include <spawn.h>
+#include <unistd.h>
+#endif
+
 namespace rlSystem
 {
 
 	namespace
 	{
 
-		bool RunApp_AllOptions(
-		const char8_t *szAppPath,
-		const char8_t *szArgs,
-		const char8_t *szCurrentDir,
-			  bool     bSynchronous,
-			  int     *pResult,
-			  bool     bHideWindow,
-		const char8_t *szStdOutFile,
-		const char8_t *szStdErrFile
-		)
+		/// <summary>The <c>stdin</c> of a child process, as requested via <c>InputSource</c>.</summary>
+		class ChildInput final
 		{
+		public: // methods
+
+			ChildInput() = default;
+			ChildInput(const ChildInput &) = delete;
+			ChildInput &operator=(const ChildInput &) = delete;
+			~ChildInput();
+
+			/// <summary>Open the source.</summary>
+			/// <param name="pInput">
+			/// If this value is <c>nullptr</c>, the input of the current process is inherited.
+			/// </param>
+			bool Open(const InputSource *pInput);
+
+			/// <summary>The file that becomes <c>stdin</c> of the child.</summary>
+			InputSource::NativeFile child() const noexcept { return m_hChild; }
+
+			/// <summary>
+			/// Must be called when the child was started. Closes the copy of the file of the child;
+			/// on Windows, starts writing the data.
+			/// </summary>
+			void Started();
+
+#ifndef _WIN32
+			/// <summary>
+			/// Write the data to the child, while reading the pipes of <c>DrainPipes</c>.
+			/// </summary>
+			void Feed(const int *pFDs = nullptr, Internal::CaptureSink *const *pSinks = nullptr,
+				size_t iCount = 0)
+			{
+				const int iWriter = m_iWriter;
+				m_iWriter = -1;
+				Internal::DrainPipes(pFDs, pSinks, iCount, iWriter, m_sData);
+			}
+#endif
+
+
+		private: // variables
+
+			std::string_view        m_sData;
+			InputSource::NativeFile m_hChild     = InputSource::InvalidFile;
+			bool                    m_bOwnsChild = false;
+
 #ifdef _WIN32
-			std::u8string sCmd;
-			sCmd.reserve(1 + strlen(reinterpret_cast<const char *>(szAppPath)) + 2 +
-				strlen(reinterpret_cast<const char *>(szAppPath)));
-			sCmd = u8'"';
-			sCmd += szAppPath;
-			sCmd += u8'"';
-			if (szArgs)
+			HANDLE      m_hWriter = NULL;
+			std::thread m_oWriter;
+#else
+			int         m_iWriter = -1;
+#endif
+
+		};
+
+		ChildInput::~ChildInput()
+		{
+#ifdef _WIN32
+			if (m_oWriter.joinable())
+				m_oWriter.join();
+			if (m_hWriter)
+				CloseHandle(m_hWriter);
+			if (m_bOwnsChild)
+				CloseHandle(m_hChild);
+#else
+			if (m_iWriter >= 0)
+				close(m_iWriter);
+			if (m_bOwnsChild)
+				close(m_hChild);
+#endif
+		}
+
+		bool ChildInput::Open(const InputSource *pInput)
+		{
+#ifdef _WIN32
+			SECURITY_ATTRIBUTES sa{ sizeof(sa) };
+			sa.bInheritHandle = TRUE;
+
+			if (!pInput)
+				m_hChild = GetStdHandle(STD_INPUT_HANDLE);
+			else if (!pInput->sFile.empty())
+			{
+				// read by the child directly, so large files aren't copied.
+				const HANDLE hFile = CreateFileW(
+					rlSystem::String::ToOS(pInput->sFile.c_str()).c_str(),
+					GENERIC_READ,
+					FILE_SHARE_READ | FILE_SHARE_WRITE,
+					&sa,
+					OPEN_EXISTING,
+					FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+					NULL
+				);
+				if (hFile == INVALID_HANDLE_VALUE)
+					return false;
+				m_hChild     = hFile;
+				m_bOwnsChild = true;
+			}
+			else if (pInput->hFile != InputSource::InvalidFile)
 			{
-				sCmd += u8' ';
-				sCmd += szArgs;
+				// the handle of the caller might not be inheritable.
+				if (!DuplicateHandle(GetCurrentProcess(), pInput->hFile, GetCurrentProcess(),
+					&m_hChild, 0, TRUE, DUPLICATE_SAME_ACCESS))
+					return false;
+				m_bOwnsChild = true;
 			}
+			else
+			{
+				// only the reading end is inherited by the child.
+				HANDLE hRead = NULL;
+				if (!CreatePipe(&hRead, &m_hWriter, &sa, (DWORD)Internal::iPipeSize))
+					return false;
+				m_hChild     = hRead;
+				m_bOwnsChild = true;
+				if (!SetHandleInformation(m_hWriter, HANDLE_FLAG_INHERIT, 0))
+					return false;
+				m_sData = pInput->sData;
+			}
+#else
+			if (!pInput)
+				m_hChild = STDIN_FILENO;
+			else if (!pInput->sFile.empty())
+			{
+				// read by the child directly, so large files aren't copied.
+				m_hChild = open(reinterpret_cast<const char *>(pInput->sFile.c_str()),
+					O_RDONLY | O_CLOEXEC);
+				if (m_hChild < 0)
+					return false;
+				m_bOwnsChild = true;
+			}
+			else if (pInput->hFile != InputSource::InvalidFile)
+				m_hChild = pInput->hFile;
+			else
+			{
+				int iPipe[2];
+				if (pipe2(iPipe, O_CLOEXEC) != 0)
+					return false;
+				fcntl(iPipe[1], F_SETPIPE_SZ, (int)Internal::iPipeSize);
+
+				m_hChild     = iPipe[0];
+				m_bOwnsChild = true;
+				m_iWriter    = iPipe[1];
+				m_sData      = pInput->sData;
+			}
+#endif
+
+			return true;
+		}
+
+		void ChildInput::Started()
+		{
+#ifdef _WIN32
+			if (m_bOwnsChild)
+				CloseHandle(m_hChild);
+
+			// anonymous pipes can't be written asynchronously.
+			if (m_hWriter)
+			{
+				m_oWriter = std::thread(Internal::FillPipe, m_hWriter, m_sData);
+				m_hWriter = NULL; // closed by FillPipe
+			}
+#else
+			// otherwise, the child would never read EOF.
+			if (m_bOwnsChild)
+				close(m_hChild);
+#endif
+			m_bOwnsChild = false;
+			m_hChild     = InputSource::InvalidFile;
+		}
+
+#ifndef _WIN32
+		/// <summary>Run a process synchronously via the spawn server.</summary>
+		/// <param name="szStdOutFile">See <c>RunConsoleApp</c>.</param>
+		/// <param name="szStdErrFile">See <c>RunConsoleApp</c>.</param>
+		Internal::RemoteResult RunViaServer(
+			const Internal::Command &oCommand,
+			const char8_t           *szCurrentDir,
+			const char8_t           *szStdOutFile,
+			const char8_t           *szStdErrFile,
+			      ChildInput        &oInput,
+			      int               &iExitCode,
+			      ResourceUsage     *pUsage
+		)
+		{
+			// the files are opened here, so relative paths are resolved like posix_spawn would.
+			int iOpenFDs[2] = { -1, -1 };
+			const auto fnOpen = [&](const char8_t *szFile, int iDefault, int &iFD)
+			{
+				if (!szFile)
+				{
+					iFD = iDefault;
+					return true;
+				}
+
+				const char *szPath = *szFile ? reinterpret_cast<const char *>(szFile) : "/dev/null";
+				iFD = open(szPath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+				return iFD >= 0;
+			};
 
+			int iFDOut = STDOUT_FILENO;
+			int iFDErr = STDERR_FILENO;
+			bool bOK = fnOpen(szStdOutFile, STDOUT_FILENO, iFDOut);
+			if (bOK && szStdOutFile)
+				iOpenFDs[0] = iFDOut;
+			if (bOK)
+			{
+				if (szStdErrFile && szStdOutFile && *szStdOutFile &&
+					std::u8string_view(szStdOutFile) == std::u8string_view(szStdErrFile))
+					iFDErr = iFDOut;
+				else
+				{
+					bOK = fnOpen(szStdErrFile, STDERR_FILENO, iFDErr);
+					if (bOK && szStdErrFile)
+						iOpenFDs[1] = iFDErr;
+				}
+			}
+
+			auto eResult = Internal::RemoteResult::Failed;
+			Internal::RemoteChild oChild;
+			if (bOK)
+				eResult = Internal::SpawnRemote(oCommand, szCurrentDir, oInput.child(), iFDOut,
+					iFDErr, oChild);
+
+			for (int iFD : iOpenFDs)
+			{
+				if (iFD >= 0)
+					close(iFD);
+			}
+
+			if (eResult == Internal::RemoteResult::Started)
+			{
+				oInput.Started();
+				oInput.Feed();
+				iExitCode = Internal::WaitRemote(oChild, pUsage);
+			}
+			return eResult;
+		}
+#endif
+
+		bool RunApp_AllOptions(
+			  Internal::Command &oCommand,
+		const char8_t           *szCurrentDir,
+			  bool               bSynchronous,
+			  int               *pResult,
+			  bool               bHideWindow,
+		const char8_t           *szStdOutFile,
+		const char8_t           *szStdErrFile,
+			  ResourceUsage     *pUsage   = nullptr,
+			  Process           *pProcess = nullptr,
+		const InputSource       *pInput   = nullptr
+		)
+		{
+			const auto tpStart = std::chrono::steady_clock::now();
+
+			ChildInput oInput;
+			if (!oInput.Open(pInput))
+				return false;
+
+#ifdef _WIN32
 			DWORD dwCreationFlags = 0;
 			if (bHideWindow)
 				dwCreationFlags |= CREATE_NO_WINDOW;
@@ -102,24 +349,10 @@ namespace rlSystem
 			else
 				si.hStdError = GetStdHandle(STD_ERROR_HANDLE);
 
-			si.hStdInput = GetStdHandle(STD_INPUT_HANDLE);
+			si.hStdInput = oInput.child();
 
 			PROCESS_INFORMATION pi{};
-			auto sCmdOS = rlSystem::String::ToOS(sCmd.c_str());
-			if (!CreateProcessW(
-				NULL,                                            // lpApplicationName
-				sCmdOS.data(),                                   // lpCommandLine
-				NULL,                                            // lpProcessAttributes
-				NULL,                                            // lpThreadAttributes
-				TRUE,                                            // bInheritHandles
-				dwCreationFlags,                                 // dwCreationFlags,
-				NULL,                                            // lpEnvironment
-				szCurrentDir ?                                   // lpCurrentDirectory
-				rlSystem::String::ToOS(szCurrentDir).c_str()
-				: 0,
-				&si,                                             // lpStartupInfo
-				&pi                                              // lpProcessInformation
-			))
+			if (!Internal::StartProcess(oCommand, szCurrentDir, dwCreationFlags, si, pi))
 			{
 				if (hStdOut && hStdOut != INVALID_HANDLE_VALUE)
 					CloseHandle(hStdOut);
@@ -127,21 +360,21 @@ namespace rlSystem
 					CloseHandle(hStdErr);
 				return false;
 			}
+			oInput.Started();
 
 			if (bSynchronous)
 			{
-				WaitForSingleObject(pi.hProcess, INFINITE);
-				DWORD dwExitCode;
+				const int iExitCode = Internal::WaitForProcess(pi.hProcess, pUsage);
 				if (pResult)
-				{
-					if (GetExitCodeProcess(pi.hProcess, &dwExitCode))
-						*pResult = dwExitCode;
-					else
-						*pResult = 0;
-				}
+					*pResult = iExitCode;
+				if (pUsage)
+					pUsage->tWall = std::chrono::steady_clock::now() - tpStart;
 			}
 
-			CloseHandle(pi.hProcess);
+			if (pProcess && !bSynchronous)
+				*pProcess = Internal::ProcessAccess::Adopt(pi.hProcess, tpStart);
+			else
+				CloseHandle(pi.hProcess);
 			CloseHandle(pi.hThread);
 
 			if (hStdOut && hStdOut != INVALID_HANDLE_VALUE)
@@ -152,36 +385,333 @@ namespace rlSystem
 			return true;
 
 #else
-#error "Not implemented"
+			(void)bHideWindow; // there are no windows
+
+			if (bSynchronous && SpawnServer::IsRunning())
+			{
+				int iExitCode = -1;
+				switch (RunViaServer(oCommand, szCurrentDir, szStdOutFile, szStdErrFile, oInput,
+					iExitCode, pUsage))
+				{
+				case Internal::RemoteResult::Started:
+					if (pResult)
+						*pResult = iExitCode;
+					if (pUsage)
+						pUsage->tWall = std::chrono::steady_clock::now() - tpStart;
+					return true;
+
+				case Internal::RemoteResult::Failed:
+					return false;
+
+				case Internal::RemoteResult::Unavailable:
+					break; // start the process directly
+				}
+			}
+
+			posix_spawn_file_actions_t oActions;
+			posix_spawn_file_actions_init(&oActions);
+
+			bool bOK = true;
+			if (oInput.child() != STDIN_FILENO)
+				bOK = posix_spawn_file_actions_adddup2(&oActions, oInput.child(), STDIN_FILENO) == 0;
+
+			const auto fnRedirect = [&](int iFD, const char8_t *szFile)
+			{
+				if (!szFile)
+					return true;
+
+				const char *szPath = *szFile ? reinterpret_cast<const char *>(szFile) : "/dev/null";
+				return posix_spawn_file_actions_addopen(&oActions, iFD, szPath,
+					O_WRONLY | O_CREAT | O_TRUNC, 0666) == 0;
+			};
+
+			bOK = bOK && fnRedirect(STDOUT_FILENO, szStdOutFile);
+			if (bOK)
+			{
+				if (szStdErrFile && szStdOutFile && *szStdOutFile &&
+					std::u8string_view(szStdOutFile) == std::u8string_view(szStdErrFile))
+					bOK = posix_spawn_file_actions_adddup2(&oActions, STDOUT_FILENO, STDERR_FILENO) == 0;
+				else
+					bOK = fnRedirect(STDERR_FILENO, szStdErrFile);
+			}
+
+			pid_t pid = 0;
+			if (bOK)
+				bOK = Internal::SpawnChild(oCommand, szCurrentDir, oActions, pid);
+
+			posix_spawn_file_actions_destroy(&oActions);
+
+			if (!bOK)
+				return false;
+			oInput.Started();
+
+			if (bSynchronous)
+			{
+				oInput.Feed();
+				const int iExitCode = Internal::WaitForChild(pid, pUsage);
+				if (pResult)
+					*pResult = iExitCode;
+				if (pUsage)
+					pUsage->tWall = std::chrono::steady_clock::now() - tpStart;
+			}
+			else if (pProcess)
+				*pProcess = Internal::ProcessAccess::Adopt(pid, tpStart);
+			else
+			{
+				// the process must be reaped when it ends, or it stays a zombie.
+				Internal::ReapLater(pid);
+			}
+
+			return true;
 #endif
 		}
 
 	}
 
+	bool RunApp(
+		const char8_t       *szAppPath,
+		const char8_t       *szArgs,
+		const char8_t       *szCurrentDir,
+			  bool           bSynchronous,
+			  int           *pResult,
+			  bool           bHideWindow,
+			  ResourceUsage *pUsage
+	)
+	{
+		Internal::Command oCommand(szAppPath, szArgs);
+		return RunApp_AllOptions(oCommand, szCurrentDir, bSynchronous, pResult,
+			bHideWindow, nullptr, nullptr, pUsage);
+	}
+
 	bool RunApp(
 		const char8_t *szAppPath,
 		const char8_t *szArgs,
 		const char8_t *szCurrentDir,
-			  bool     bSynchronous,
-			  int     *pResult,
+			  Process &oProcess,
 			  bool     bHideWindow
 	)
 	{
-		return RunApp_AllOptions(szAppPath, szArgs, szCurrentDir, bSynchronous, pResult,
-			bHideWindow, nullptr, nullptr);
+		oProcess = Process();
+		Internal::Command oCommand(szAppPath, szArgs);
+		return RunApp_AllOptions(oCommand, szCurrentDir, false, nullptr, bHideWindow,
+			nullptr, nullptr, nullptr, &oProcess);
+	}
+
+	bool RunApp(
+		const char8_t                             *szAppPath,
+		      std::span<const std::u8string_view>  oArgs,
+		      std::span<const std::u8string_view>  oEnvironment,
+		const char8_t                             *szCurrentDir,
+		      bool                                 bSynchronous,
+		      int                                 *pResult,
+		      bool                                 bHideWindow,
+		      ResourceUsage                       *pUsage
+	)
+	{
+		Internal::Command oCommand(szAppPath, oArgs, oEnvironment);
+		return RunApp_AllOptions(oCommand, szCurrentDir, bSynchronous, pResult, bHideWindow,
+			nullptr, nullptr, pUsage);
+	}
+
+	bool RunApp(
+		const char8_t                             *szAppPath,
+		      std::span<const std::u8string_view>  oArgs,
+		      std::span<const std::u8string_view>  oEnvironment,
+		const char8_t                             *szCurrentDir,
+		      Process                             &oProcess,
+		      bool                                 bHideWindow
+	)
+	{
+		oProcess = Process();
+		Internal::Command oCommand(szAppPath, oArgs, oEnvironment);
+		return RunApp_AllOptions(oCommand, szCurrentDir, false, nullptr, bHideWindow,
+			nullptr, nullptr, nullptr, &oProcess);
 	}
 
 	bool RunConsoleApp(
-		const char8_t *szAppPath,
-		const char8_t *szArgs,
-		const char8_t *szCurrentDir,
-			  int     *pResult,
-		const char8_t *szStdOutFile,
-		const char8_t *szStdErrFile
+		const char8_t       *szAppPath,
+		const char8_t       *szArgs,
+		const char8_t       *szCurrentDir,
+			  int           *pResult,
+		const char8_t       *szStdOutFile,
+		const char8_t       *szStdErrFile,
+			  ResourceUsage *pUsage,
+		const InputSource   *pInput
+	)
+	{
+		Internal::Command oCommand(szAppPath, szArgs);
+		return RunApp_AllOptions(oCommand, szCurrentDir, true, pResult, false,
+			szStdOutFile, szStdErrFile, pUsage, nullptr, pInput);
+	}
+
+	bool RunConsoleApp(
+		const char8_t        *szAppPath,
+		const char8_t        *szArgs,
+		const char8_t        *szCurrentDir,
+		      int            *pResult,
+		      CapturedOutput &oOutput,
+		const CaptureOptions &oOptions,
+		      ResourceUsage  *pUsage,
+		const InputSource    *pInput
 	)
 	{
-		return RunApp_AllOptions(szAppPath, szArgs, szCurrentDir, true, pResult, false,
-			szStdOutFile, szStdErrFile);
+		oOutput = {};
+		const auto tpStart = std::chrono::steady_clock::now();
+
+		Internal::Command oCommand(szAppPath, szArgs);
+
+		ChildInput oInput;
+		if (!oInput.Open(pInput))
+			return false;
+
+		Internal::CaptureSink oStdOut(oOutput.sStdOut, oOptions.fnStdOut, oOptions.iMaxOutputSize);
+		Internal::CaptureSink oStdErr(oOutput.sStdErr, oOptions.fnStdErr, oOptions.iMaxOutputSize);
+
+#ifdef _WIN32
+		SECURITY_ATTRIBUTES sa{ sizeof(sa) };
+		sa.bInheritHandle = TRUE;
+
+		// only the writing ends are inherited by the child.
+		HANDLE hPipes[2][2] = { { NULL, NULL }, { NULL, NULL } }; // [stream][read, write]
+		const size_t iPipeCount = oOptions.bMergeStdErr ? 1 : 2;
+		const auto fnClose = [&]
+		{
+			for (auto &h : hPipes)
+			{
+				if (h[0])
+					CloseHandle(h[0]);
+				if (h[1])
+					CloseHandle(h[1]);
+			}
+		};
+		for (size_t i = 0; i < iPipeCount; ++i)
+		{
+			if (!CreatePipe(&hPipes[i][0], &hPipes[i][1], &sa, (DWORD)Internal::iPipeSize) ||
+				!SetHandleInformation(hPipes[i][0], HANDLE_FLAG_INHERIT, 0))
+			{
+				fnClose();
+				return false;
+			}
+		}
+
+		STARTUPINFOW si{};
+		si.cb = sizeof(STARTUPINFOW);
+		si.dwFlags    = STARTF_USESTDHANDLES;
+		si.hStdInput  = oInput.child();
+		si.hStdOutput = hPipes[0][1];
+		si.hStdError  = hPipes[iPipeCount - 1][1];
+
+		PROCESS_INFORMATION pi{};
+		if (!Internal::StartProcess(oCommand, szCurrentDir, 0, si, pi))
+		{
+			fnClose();
+			return false;
+		}
+		oInput.Started();
+
+		// otherwise, ReadFile wouldn't fail when the child exits.
+		for (size_t i = 0; i < iPipeCount; ++i)
+		{
+			CloseHandle(hPipes[i][1]);
+			hPipes[i][1] = NULL;
+		}
+
+		std::thread oStdErrThread;
+		if (iPipeCount == 2)
+			oStdErrThread = std::thread(Internal::DrainPipe, hPipes[1][0], std::ref(oStdErr));
+		Internal::DrainPipe(hPipes[0][0], oStdOut);
+		if (oStdErrThread.joinable())
+			oStdErrThread.join();
+
+		const int iExitCode = Internal::WaitForProcess(pi.hProcess, pUsage);
+		if (pResult)
+			*pResult = iExitCode;
+
+		CloseHandle(pi.hProcess);
+		CloseHandle(pi.hThread);
+		fnClose();
+
+#else
+		// O_CLOEXEC: the pipes must not leak into processes started by other threads.
+		int iPipes[2][2] = { { -1, -1 }, { -1, -1 } }; // [stream][read, write]
+		const size_t iPipeCount = oOptions.bMergeStdErr ? 1 : 2;
+		const auto fnClose = [&]
+		{
+			for (auto &i : iPipes)
+			{
+				if (i[0] >= 0)
+					close(i[0]);
+				if (i[1] >= 0)
+					close(i[1]);
+			}
+		};
+		for (size_t i = 0; i < iPipeCount; ++i)
+		{
+			if (pipe2(iPipes[i], O_CLOEXEC) != 0)
+			{
+				fnClose();
+				return false;
+			}
+
+			// fewer context switches for chatty children. Fails above
+			// /proc/sys/fs/pipe-max-size, which is fine.
+			fcntl(iPipes[i][1], F_SETPIPE_SZ, (int)Internal::iPipeSize);
+		}
+
+		Internal::RemoteChild oRemote;
+		const auto eRemote = Internal::SpawnRemote(oCommand, szCurrentDir, oInput.child(),
+			iPipes[0][1], iPipes[iPipeCount - 1][1], oRemote);
+		bool bOK = eRemote == Internal::RemoteResult::Started;
+
+		pid_t pid = 0;
+		if (eRemote == Internal::RemoteResult::Unavailable)
+		{
+			// dup2 clears O_CLOEXEC on the child's copies.
+			posix_spawn_file_actions_t oActions;
+			posix_spawn_file_actions_init(&oActions);
+			bOK =
+				(oInput.child() == STDIN_FILENO ||
+					posix_spawn_file_actions_adddup2(&oActions, oInput.child(), STDIN_FILENO) == 0) &&
+				posix_spawn_file_actions_adddup2(&oActions, iPipes[0][1], STDOUT_FILENO) == 0 &&
+				posix_spawn_file_actions_adddup2(&oActions, iPipes[iPipeCount - 1][1],
+					STDERR_FILENO) == 0;
+
+			if (bOK)
+				bOK = Internal::SpawnChild(oCommand, szCurrentDir, oActions, pid);
+			posix_spawn_file_actions_destroy(&oActions);
+		}
+
+		// otherwise, the pipes would never report EOF.
+		for (size_t i = 0; i < iPipeCount; ++i)
+		{
+			close(iPipes[i][1]);
+			iPipes[i][1] = -1;
+		}
+
+		if (!bOK)
+		{
+			fnClose();
+			return false;
+		}
+
+		oInput.Started();
+
+		const int iFDs[2] = { iPipes[0][0], iPipes[1][0] };
+		Internal::CaptureSink *const pSinks[2] = { &oStdOut, &oStdErr };
+		oInput.Feed(iFDs, pSinks, iPipeCount);
+		iPipes[0][0] = iPipes[1][0] = -1;
+
+		const int iExitCode = eRemote == Internal::RemoteResult::Started ?
+			Internal::WaitRemote(oRemote, pUsage) : Internal::WaitForChild(pid, pUsage);
+		if (pResult)
+			*pResult = iExitCode;
+#endif
+
+		if (pUsage)
+			pUsage->tWall = std::chrono::steady_clock::now() - tpStart;
+
+		oOutput.bTruncated = oStdOut.truncated() || oStdErr.truncated();
+		return true;
 	}
 
 }
@@ -0,0 +1,160 @@
+#ifndef _WIN32
+
+#include "include/CaseFoldCache.hpp"
+
+#include <algorithm>
+#include <mutex>
+
+#include <dirent.h>
+
+
+
+namespace rlSystem
+{
+
+	namespace Internal
+	{
+
+		namespace
+		{
+
+			/// <summary>
+			/// The maximum number of cached directories. Once exceeded, the cache is cleared so
+			/// that the memory usage can't grow without bounds.
+			/// </summary>
+			constexpr size_t iMaxCachedDirs = 65536;
+
+			/// <summary>
+			/// The coarsest timestamp granularity of the supported file systems (FAT: 2 seconds).
+			/// <para/>
+			/// A table built less than this after the directory's last modification might miss
+			/// changes that didn't alter the modification time.
+			/// </summary>
+			constexpr time_t iTimestampGranularity = 2;
+
+			bool SameVersion(const struct stat &oStat, const struct timespec &tsModified,
+				dev_t iDevice, ino_t iInode)
+			{
+				return oStat.st_mtim.tv_sec  == tsModified.tv_sec  &&
+				       oStat.st_mtim.tv_nsec == tsModified.tv_nsec &&
+				       oStat.st_dev          == iDevice            &&
+				       oStat.st_ino          == iInode;
+			}
+
+		}
+
+
+
+		CaseFoldCache &CaseFoldCache::Instance()
+		{
+			static CaseFoldCache s_oInstance;
+			return s_oInstance;
+		}
+
+		bool CaseFoldCache::Resolve(const std::u8string &sDir, std::u8string_view sName,
+			std::u8string &sResult)
+		{
+			// A miss might also mean the table is outdated: the modification time of a directory
+			// only has the granularity of the file system's clock. So on a miss, a recently built
+			// table is rebuilt once before giving up.
+			for (bool bRebuildIfRecent : { false, true })
+			{
+				const auto pTable = Get(sDir, bRebuildIfRecent);
+				if (!pTable)
+					return false;
+
+				const auto it = pTable->oItems.find(sName);
+				if (it == pTable->oItems.end())
+					continue;
+
+				const auto &oNames = it->second;
+				if (std::binary_search(oNames.begin(), oNames.end(), sName))
+					sResult = sName;
+				else
+					sResult = oNames.front();
+				return true;
+			}
+
+			return false;
+		}
+
+		void CaseFoldCache::Clear()
+		{
+			std::unique_lock lock(m_mux);
+			m_oDirs.clear();
+		}
+
+		std::shared_ptr<const CaseFoldCache::DirTable> CaseFoldCache::Build(
+			const std::u8string &sDir, const struct stat &oStat)
+		{
+			DIR *pDir = opendir(reinterpret_cast<const char *>(sDir.c_str()));
+			if (!pDir)
+				return nullptr;
+
+			auto pTable = std::make_shared<DirTable>();
+			pTable->tsModified = oStat.st_mtim;
+			clock_gettime(CLOCK_REALTIME, &pTable->tsBuilt);
+			pTable->iDevice    = oStat.st_dev;
+			pTable->iInode     = oStat.st_ino;
+
+			while (const dirent *pEntry = readdir(pDir))
+			{
+				const std::u8string_view sName = reinterpret_cast<const char8_t *>(pEntry->d_name);
+				if (sName == u8"." || sName == u8"..")
+					continue;
+
+				pTable->oItems[std::u8string(sName)].emplace_back(sName);
+			}
+			closedir(pDir);
+
+			for (auto &[sKey, oNames] : pTable->oItems)
+			{
+				if (oNames.size() > 1)
+					std::sort(oNames.begin(), oNames.end());
+			}
+
+			return pTable;
+		}
+
+		std::shared_ptr<const CaseFoldCache::DirTable> CaseFoldCache::Get(
+			const std::u8string &sDir, bool bRebuildIfRecent)
+		{
+			struct stat oStat;
+			if (stat(reinterpret_cast<const char *>(sDir.c_str()), &oStat) != 0 ||
+				!S_ISDIR(oStat.st_mode))
+				return nullptr;
+
+			{
+				std::shared_lock lock(m_mux);
+
+				const auto it = m_oDirs.find(sDir);
+				if (it != m_oDirs.end())
+				{
+					const auto &pTable = it->second;
+
+					const bool bRecent =
+						pTable->tsBuilt.tv_sec - pTable->tsModified.tv_sec <= iTimestampGranularity;
+					if (SameVersion(oStat, pTable->tsModified, pTable->iDevice, pTable->iInode) &&
+						!(bRebuildIfRecent && bRecent))
+						return pTable;
+				}
+			}
+
+			// the directory is read without holding the lock, so other lookups aren't blocked.
+			auto pTable = Build(sDir, oStat);
+			if (!pTable)
+				return nullptr;
+
+			std::unique_lock lock(m_mux);
+			if (m_oDirs.size() >= iMaxCachedDirs)
+				m_oDirs.clear();
+			m_oDirs[sDir] = pTable;
+
+			return pTable;
+		}
+
+	}
+
+}
+
+#endif // _WIN32
\ No newline at end of file
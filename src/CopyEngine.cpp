@@ -0,0 +1,738 @@
+#include "include/CopyEngine.hpp"
+
+#include "include/DirectoryWalker.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#ifdef _WIN32
+#include "include/IncludeWindows.h"
+#include <rlSystem/WindowsUnicodeString.hpp>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+
+
+namespace rlSystem
+{
+
+	namespace Internal
+	{
+
+		namespace
+		{
+
+			/// <summary>
+			/// Appended to the destination path of a cross-file system move while it's in
+			/// progress.
+			/// </summary>
+			constexpr char8_t szStagingSuffix[] = u8".rlSystem-move";
+
+			constexpr size_t iBufferSize = 1024 * 1024;
+
+			/// <summary>Resolve a configured thread count (zero = hardware threads).</summary>
+			unsigned ThreadCount(unsigned iThreads)
+			{
+				if (iThreads)
+					return iThreads;
+				return std::max(1u, std::thread::hardware_concurrency());
+			}
+
+			/// <summary>Call a function for every index in [0, iCount) using multiple threads.</summary>
+			/// <returns>Did the function return <c>true</c> for every index?</returns>
+			bool ParallelForEach(size_t iCount, unsigned iThreads,
+				const std::function<bool(size_t i)> &fn)
+			{
+				std::atomic<size_t> iNext   = 0;
+				std::atomic<bool>   bFailed = false;
+
+				const auto fnWorker = [&]
+				{
+					for (size_t i = iNext++; i < iCount && !bFailed; i = iNext++)
+					{
+						if (!fn(i))
+							bFailed = true;
+					}
+				};
+
+				iThreads = (unsigned)std::min<size_t>(iThreads, iCount);
+
+				std::vector<std::thread> oThreads;
+				for (unsigned i = 1; i < iThreads; ++i)
+				{
+					oThreads.emplace_back(fnWorker);
+				}
+				fnWorker();
+
+				for (auto &oThread : oThreads)
+				{
+					oThread.join();
+				}
+
+				return !bFailed;
+			}
+
+			bool CopyDirectoryMetadata(const fs::path &pathOrig, const fs::path &pathCopy)
+			{
+				std::error_code ec;
+
+				const auto oStatus = fs::status(pathOrig, ec);
+				if (ec)
+					return false;
+				fs::permissions(pathCopy, oStatus.permissions(), ec);
+				if (ec)
+					return false;
+
+				const auto tModified = fs::last_write_time(pathOrig, ec);
+				if (ec)
+					return false;
+				fs::last_write_time(pathCopy, tModified, ec);
+
+				return !ec;
+			}
+
+			/// <summary>Create a copy of a symlink or another special (non-regular) file.</summary>
+			bool CopySpecial(const char8_t *szOrigPath, const char8_t *szCopyPath, unsigned iType)
+			{
+				std::error_code ec;
+
+				if (iType == Directory::ItemType::Symlink)
+				{
+					fs::copy_symlink(szOrigPath, szCopyPath, ec);
+					return !ec;
+				}
+
+#ifndef _WIN32
+				struct stat oStat;
+				if (lstat(reinterpret_cast<const char *>(szOrigPath), &oStat) != 0)
+					return false;
+
+				if (S_ISFIFO(oStat.st_mode))
+					return mkfifo(reinterpret_cast<const char *>(szCopyPath),
+						oStat.st_mode & 07777) == 0;
+#endif
+
+				return false; // devices and sockets can't be copied
+			}
+
+#ifndef _WIN32
+
+			/// <summary>
+			/// Copies ranges of bytes from one file descriptor to the same offsets in another one.
+			/// </summary>
+			class RangeCopier final
+			{
+			public: // methods
+
+				RangeCopier(int iFDOrig, int iFDCopy, bool bNoCache) :
+					m_iFDOrig(iFDOrig), m_iFDCopy(iFDCopy), m_bNoCache(bNoCache) {}
+
+				/// <summary>
+				/// Copy a range. Stops early if the end of the original file is reached.
+				/// </summary>
+				bool Copy(off_t iOffset, off_t iEnd)
+				{
+					std::optional<CacheDropper> oDropper;
+					if (m_bNoCache)
+						oDropper.emplace(m_iFDOrig, m_iFDCopy, iOffset);
+
+					// without the cache, the data is copied in smaller steps so the pages can be
+					// dropped soon after they were written.
+					const off_t iMaxStep = m_bNoCache ? CacheDropper::iWindow : (1 << 30);
+
+					while (iOffset < iEnd)
+					{
+						// copy_file_range lets the kernel (or the file system) do the work; it's
+						// not supported between all kinds of files, in which case pread/pwrite is
+						// used.
+						if (m_bKernelCopy)
+						{
+							loff_t iOffsetOrig = iOffset;
+							loff_t iOffsetCopy = iOffset;
+							const ssize_t iCopied = copy_file_range(m_iFDOrig, &iOffsetOrig,
+								m_iFDCopy, &iOffsetCopy, size_t(std::min(iEnd - iOffset, iMaxStep)), 0);
+							if (iCopied == 0)
+								return true;
+							if (iCopied > 0)
+							{
+								iOffset += iCopied;
+								if (oDropper)
+									oDropper->Advance(iOffset);
+								continue;
+							}
+
+							if (errno == EINTR)
+								continue;
+							if (errno != EXDEV && errno != EINVAL && errno != ENOSYS &&
+								errno != EOPNOTSUPP && errno != EBADF)
+								return false;
+
+							m_bKernelCopy = false;
+						}
+
+						if (!m_up_buf)
+							m_up_buf = std::make_unique<char[]>(iBufferSize);
+
+						const ssize_t iRead = pread(m_iFDOrig, m_up_buf.get(),
+							size_t(std::min<off_t>(iEnd - iOffset, iBufferSize)), iOffset);
+						if (iRead == 0)
+							return true;
+						if (iRead < 0)
+						{
+							if (errno == EINTR)
+								continue;
+							return false;
+						}
+
+						for (ssize_t iDone = 0; iDone < iRead;)
+						{
+							const ssize_t iWritten = pwrite(m_iFDCopy, m_up_buf.get() + iDone,
+								iRead - iDone, iOffset + iDone);
+							if (iWritten < 0)
+							{
+								if (errno == EINTR)
+									continue;
+								return false;
+							}
+							iDone += iWritten;
+						}
+						iOffset += iRead;
+						if (oDropper)
+							oDropper->Advance(iOffset);
+					}
+
+					return true;
+				}
+
+
+			private: // variables
+
+				const int  m_iFDOrig;
+				const int  m_iFDCopy;
+				const bool m_bNoCache;
+				bool       m_bKernelCopy = true;
+
+				std::unique_ptr<char[]> m_up_buf; // for the pread/pwrite fallback
+
+			};
+
+			/// <summary>Copy all data from one file descriptor to another.</summary>
+			/// <param name="oStat">The metadata of the original file.</param>
+			bool CopyData(int iFDOrig, int iFDCopy, const struct stat &oStat,
+				const CopyOptions &oOptions)
+			{
+				RangeCopier oCopier(iFDOrig, iFDCopy, oOptions.bNoCache);
+
+				// Fewer allocated blocks than the size requires means the file has holes - or
+				// that it's compressed (e.g. on btrfs or ZFS), so SEEK_HOLE must find a hole
+				// before the end, too. Only the data extents are copied then; the holes are
+				// skipped, so they stay holes in the copy (as long as the destination file
+				// system supports that).
+				const off_t iFirstHole = oStat.st_blocks * 512 < oStat.st_size ?
+					lseek(iFDOrig, 0, SEEK_HOLE) : -1;
+				if (iFirstHole >= 0 && iFirstHole < oStat.st_size)
+				{
+					off_t iData = 0;
+					while (iData < oStat.st_size)
+					{
+						const off_t iNextData = lseek(iFDOrig, iData, SEEK_DATA);
+						if (iNextData < 0)
+						{
+							if (errno == ENXIO) // only a hole left
+								break;
+							if (iData == 0 && errno == EINVAL) // SEEK_DATA not supported
+								return oCopier.Copy(0, std::numeric_limits<off_t>::max());
+							return false;
+						}
+						iData = iNextData;
+
+						off_t iHole = lseek(iFDOrig, iData, SEEK_HOLE);
+						if (iHole < 0)
+							return false;
+						iHole = std::min(iHole, oStat.st_size);
+
+						if (!oCopier.Copy(iData, iHole))
+							return false;
+						iData = iHole;
+					}
+
+					// a trailing hole isn't created by writing, so the size must be set explicitly.
+					return ftruncate(iFDCopy, oStat.st_size) == 0;
+				}
+
+				off_t iCopied = 0;
+
+				// Large files are split into chunks that are copied concurrently; a single
+				// stream can't saturate fast storage. The destination is preallocated first so
+				// the chunks don't fragment it.
+				const unsigned iChunkThreads = ThreadCount(oOptions.iChunkThreads);
+				if (iChunkThreads > 1 && oOptions.iChunkSize > 0 &&
+					(uint64_t)oStat.st_size >= oOptions.iLargeFileThreshold)
+				{
+					// not supported by all file systems, this is only an optimization.
+					if (fallocate(iFDCopy, 0, 0, oStat.st_size) != 0)
+					{
+						// ignore
+					}
+
+					const off_t  iChunkSize = (off_t)oOptions.iChunkSize;
+					const size_t iChunks    = size_t((oStat.st_size + iChunkSize - 1) / iChunkSize);
+
+					const bool bOK = ParallelForEach(iChunks, iChunkThreads, [&](size_t i)
+					{
+						RangeCopier oChunkCopier(iFDOrig, iFDCopy, oOptions.bNoCache);
+
+						const off_t iOffset = off_t(i) * iChunkSize;
+						return oChunkCopier.Copy(iOffset, std::min(iOffset + iChunkSize, oStat.st_size));
+					});
+					if (!bOK)
+						return false;
+
+					iCopied = oStat.st_size;
+				}
+
+				// Copy (the rest) until the end of the file, even if it grew in the meantime.
+				return oCopier.Copy(iCopied, std::numeric_limits<off_t>::max());
+			}
+
+#endif
+
+		}
+
+
+
+#ifndef _WIN32
+
+		CacheDropper::CacheDropper(int iFDRead, int iFDWrite, off_t iOffset) noexcept :
+			m_iFDRead(iFDRead), m_iFDWrite(iFDWrite),
+			m_iDropped(iOffset), m_iMark(iOffset), m_iCurrent(iOffset)
+		{
+			if (m_iFDRead >= 0)
+				posix_fadvise(m_iFDRead, 0, 0, POSIX_FADV_SEQUENTIAL);
+		}
+
+		CacheDropper::~CacheDropper()
+		{
+			if (m_iFDWrite >= 0 && m_iCurrent > m_iDropped)
+			{
+				sync_file_range(m_iFDWrite, m_iDropped, m_iCurrent - m_iDropped,
+					SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+				posix_fadvise(m_iFDWrite, m_iDropped, m_iCurrent - m_iDropped, POSIX_FADV_DONTNEED);
+			}
+
+			if (m_iFDRead >= 0 && m_iCurrent > m_iMark)
+				posix_fadvise(m_iFDRead, m_iMark, m_iCurrent - m_iMark, POSIX_FADV_DONTNEED);
+		}
+
+		void CacheDropper::Advance(off_t iOffset) noexcept
+		{
+			m_iCurrent = iOffset;
+			if (iOffset - m_iMark < iWindow)
+				return;
+
+			// Read data isn't needed anymore.
+			if (m_iFDRead >= 0)
+				posix_fadvise(m_iFDRead, m_iMark, iOffset - m_iMark, POSIX_FADV_DONTNEED);
+
+			// Written data can only be dropped once it's on the disk: start the writeback of
+			// the current window, then wait for the previous one (which usually is complete
+			// already) and drop it. This also keeps the amount of dirty pages small.
+			if (m_iFDWrite >= 0)
+			{
+				sync_file_range(m_iFDWrite, m_iMark, iOffset - m_iMark, SYNC_FILE_RANGE_WRITE);
+
+				if (m_iMark > m_iDropped)
+				{
+					sync_file_range(m_iFDWrite, m_iDropped, m_iMark - m_iDropped,
+						SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE |
+						SYNC_FILE_RANGE_WAIT_AFTER);
+					posix_fadvise(m_iFDWrite, m_iDropped, m_iMark - m_iDropped, POSIX_FADV_DONTNEED);
+				}
+			}
+
+			m_iDropped = m_iMark;
+			m_iMark    = iOffset;
+		}
+
+#endif
+
+
+
+		bool CopyFileWithMetadata(const char8_t *szOrigFilePath, const char8_t *szCopyFilePath,
+			const CopyOptions &oOptions)
+		{
+#ifdef _WIN32
+			// CopyFileExW already copies the attributes and timestamps.
+			// Large files bypass the cache, which is considerably faster for them.
+			DWORD dwFlags = COPY_FILE_FAIL_IF_EXISTS;
+			WIN32_FILE_ATTRIBUTE_DATA oData;
+			if (oOptions.bNoCache)
+				dwFlags |= COPY_FILE_NO_BUFFERING;
+			else if (GetFileAttributesExW(String::ToOS(szOrigFilePath).c_str(), GetFileExInfoStandard,
+				&oData) &&
+				(uint64_t(oData.nFileSizeHigh) << 32 | oData.nFileSizeLow) >= oOptions.iLargeFileThreshold)
+				dwFlags |= COPY_FILE_NO_BUFFERING;
+
+			return CopyFileExW(String::ToOS(szOrigFilePath).c_str(),
+				String::ToOS(szCopyFilePath).c_str(), NULL, NULL, NULL, dwFlags);
+#else
+			const int iFDOrig = open(reinterpret_cast<const char *>(szOrigFilePath),
+				O_RDONLY | O_CLOEXEC);
+			if (iFDOrig < 0)
+				return false;
+
+			struct stat oStat;
+			if (fstat(iFDOrig, &oStat) != 0 || !S_ISREG(oStat.st_mode))
+			{
+				close(iFDOrig);
+				return false;
+			}
+
+			// the final permissions are set at the end, when all data was written.
+			const int iFDCopy = open(reinterpret_cast<const char *>(szCopyFilePath),
+				O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+			if (iFDCopy < 0)
+			{
+				close(iFDOrig);
+				return false;
+			}
+
+			bool bResult = CopyData(iFDOrig, iFDCopy, oStat, oOptions);
+
+			if (bResult)
+			{
+				// the owner can only be changed with the appropriate privileges; that's fine.
+				if (fchown(iFDCopy, oStat.st_uid, oStat.st_gid) != 0)
+				{
+					// ignore
+				}
+
+				const struct timespec tsTimes[2] = { oStat.st_atim, oStat.st_mtim };
+				bResult = fchmod(iFDCopy, oStat.st_mode & 07777) == 0 &&
+					futimens(iFDCopy, tsTimes) == 0;
+			}
+
+			close(iFDOrig);
+			if (close(iFDCopy) != 0)
+				bResult = false;
+
+			if (!bResult)
+				unlink(reinterpret_cast<const char *>(szCopyFilePath));
+
+			return bResult;
+#endif
+		}
+
+		bool IsCompleteCopy(const char8_t *szOrigFilePath, const char8_t *szCopyFilePath)
+		{
+			std::error_code ec;
+
+			const auto iSizeOrig = fs::file_size(szOrigFilePath, ec);
+			if (ec)
+				return false;
+			const auto iSizeCopy = fs::file_size(szCopyFilePath, ec);
+			if (ec || iSizeOrig != iSizeCopy)
+				return false;
+
+			const auto tOrig = fs::last_write_time(szOrigFilePath, ec);
+			if (ec)
+				return false;
+			const auto tCopy = fs::last_write_time(szCopyFilePath, ec);
+
+			return !ec && tOrig == tCopy;
+		}
+
+		bool SameContent(const char8_t *szFilePath1, const char8_t *szFilePath2)
+		{
+			std::ifstream file1(fs::path(szFilePath1), std::ios::binary);
+			std::ifstream file2(fs::path(szFilePath2), std::ios::binary);
+			if (!file1 || !file2)
+				return false;
+
+			auto up_buf1 = std::make_unique<char[]>(iBufferSize);
+			auto up_buf2 = std::make_unique<char[]>(iBufferSize);
+
+			while (true)
+			{
+				file1.read(up_buf1.get(), iBufferSize);
+				file2.read(up_buf2.get(), iBufferSize);
+
+				const auto iRead1 = file1.gcount();
+				const auto iRead2 = file2.gcount();
+				if (iRead1 != iRead2 || std::memcmp(up_buf1.get(), up_buf2.get(), iRead1) != 0)
+					return false;
+
+				if (iRead1 < (std::streamsize)iBufferSize)
+					return file1.eof() && file2.eof();
+			}
+		}
+
+		namespace
+		{
+
+			/// <summary>
+			/// Is a path the same as a directory or inside it, after resolving symlinks and
+			/// <c>..</c>?
+			/// </summary>
+			bool IsSameOrInside(const char8_t *szPath, const char8_t *szDirPath)
+			{
+				std::error_code ec;
+				const auto pathDir = fs::canonical(Path::ExcludeTrailingDelim(szDirPath), ec);
+				if (ec)
+					return false;
+				const auto path = fs::weakly_canonical(Path::ExcludeTrailingDelim(szPath), ec);
+				if (ec)
+					return false;
+
+				auto it = path.begin();
+				for (const auto &oComponent : pathDir)
+				{
+					if (it == path.end() || *it != oComponent)
+						return false;
+					++it;
+				}
+				return true;
+			}
+
+			/// <summary>
+			/// Copy the contents of a directory tree into an existing directory.<para/>
+			/// Both paths are absolute and end with a delimiter.
+			/// </summary>
+			bool CopyTreeContents(const std::u8string &sOrigRoot, const std::u8string &sCopyRoot,
+				const CopyOptions &oOptions, bool bResume)
+			{
+				std::error_code ec;
+
+				struct Job
+				{
+					std::u8string sOrig;
+					std::u8string sCopy;
+				};
+				std::vector<Job> oFiles;
+				std::vector<Job> oDirs = { { sOrigRoot, sCopyRoot } };
+				std::unordered_set<std::u8string> oOrigItems; // relative paths, only when resuming
+				bool bFailed = false;
+
+				// First pass: create the directory structure (and copy special files), collect
+				// the regular files. The walk is strict, so an unreadable subdirectory fails the
+				// copy instead of leaving it incomplete (a move deletes the original afterwards).
+				const bool bWalked = Walk(sOrigRoot.c_str(), UINT_MAX, false,
+					[&](WalkEntry &oEntry) -> WalkAction
+					{
+						const auto sCopy =
+							sCopyRoot + std::u8string(oEntry.sPath.substr(sOrigRoot.length()));
+						if (bResume)
+							oOrigItems.emplace(oEntry.sRelativePath);
+
+						switch (oEntry.iType)
+						{
+						case Directory::ItemType::Directory:
+							if (bResume && !fs::is_directory(fs::symlink_status(sCopy, ec)))
+								fs::remove(sCopy, ec);
+							if (!fs::create_directory(sCopy, ec) &&
+								!(bResume && fs::is_directory(sCopy)))
+							{
+								bFailed = true;
+								return WalkAction::Stop;
+							}
+							oDirs.push_back({ std::u8string(oEntry.sPath), sCopy });
+							break;
+
+						case Directory::ItemType::File:
+							oFiles.push_back({ std::u8string(oEntry.sPath), sCopy });
+							break;
+
+						default:
+							if (bResume)
+								fs::remove_all(sCopy, ec);
+							if (!CopySpecial(std::u8string(oEntry.sPath).c_str(), sCopy.c_str(),
+								oEntry.iType))
+							{
+								bFailed = true;
+								return WalkAction::Stop;
+							}
+						}
+
+						return WalkAction::Continue;
+					}, true);
+				if (!bWalked || bFailed)
+					return false;
+
+				// An interrupted copy may contain items that were deleted from the original since.
+				if (bResume)
+				{
+					const bool bPruned = Walk(sCopyRoot.c_str(), UINT_MAX, false,
+						[&](WalkEntry &oEntry) -> WalkAction
+						{
+							if (oOrigItems.contains(std::u8string(oEntry.sRelativePath)))
+								return WalkAction::Continue;
+
+							fs::remove_all(std::u8string(oEntry.sPath), ec);
+							if (ec)
+							{
+								bFailed = true;
+								return WalkAction::Stop;
+							}
+							return WalkAction::SkipChildren;
+						}, true);
+					if (!bPruned || bFailed)
+						return false;
+				}
+
+				// Second pass: copy the files. If they're already copied concurrently, large files
+				// aren't split into chunks as well: the thread counts would multiply.
+				const unsigned iThreads = ThreadCount(oOptions.iThreads);
+				CopyOptions oFileOptions = oOptions;
+				if (std::min<size_t>(iThreads, oFiles.size()) > 1)
+					oFileOptions.iChunkThreads = 1;
+
+				const bool bCopied = ParallelForEach(oFiles.size(), iThreads, [&](size_t i)
+				{
+					const auto &oJob = oFiles[i];
+
+					if (bResume && Path::Exists(oJob.sCopy.c_str()))
+					{
+						if (IsCompleteCopy(oJob.sOrig.c_str(), oJob.sCopy.c_str()))
+							return true;
+
+						std::error_code ecRemove;
+						fs::remove_all(oJob.sCopy, ecRemove);
+					}
+
+					return CopyFileWithMetadata(oJob.sOrig.c_str(), oJob.sCopy.c_str(),
+						oFileOptions);
+				});
+				if (!bCopied)
+					return false;
+
+				// Finally, the directory timestamps: those were changed by creating the contents,
+				// so subdirectories must be handled before their parents.
+				for (auto it = oDirs.rbegin(); it != oDirs.rend(); ++it)
+				{
+					if (!CopyDirectoryMetadata(it->sOrig, it->sCopy))
+						return false;
+				}
+
+				if (!oOptions.bVerify)
+					return true;
+
+				return ParallelForEach(oFiles.size(), iThreads, [&](size_t i)
+				{
+					return SameContent(oFiles[i].sOrig.c_str(), oFiles[i].sCopy.c_str());
+				});
+			}
+
+		}
+
+		bool CopyTree(const char8_t *szOrigDirPath, const char8_t *szCopyDirPath,
+			const CopyOptions &oOptions, bool bResume)
+		{
+			const auto sOrigRoot = Path::IncludeTrailingDelim(Path::Absolute(szOrigDirPath).c_str());
+			const auto sCopyRoot = Path::IncludeTrailingDelim(Path::Absolute(szCopyDirPath).c_str());
+
+			// the walk would find the copy inside the original and copy it again, endlessly.
+			if (IsSameOrInside(sCopyRoot.c_str(), sOrigRoot.c_str()))
+				return false;
+
+			std::error_code ec;
+			if (!fs::create_directory(sCopyRoot, ec) && (!bResume || !fs::is_directory(sCopyRoot)))
+				return false;
+
+			if (CopyTreeContents(sOrigRoot, sCopyRoot, oOptions, bResume))
+				return true;
+
+			// an interrupted resumable copy is kept for the next attempt.
+			if (!bResume)
+				fs::remove_all(sCopyRoot, ec);
+			return false;
+		}
+
+		bool MoveItem(const char8_t *szOrigPath, const char8_t *szNewPath,
+			const CopyOptions &oOptions, bool bReplace)
+		{
+			std::error_code ec;
+			fs::rename(szOrigPath, szNewPath, ec);
+			if (!ec)
+				return true;
+
+			if (ec != std::errc::cross_device_link)
+				return false;
+
+
+
+			// The destination is on a different file system: copy the item to a staging path
+			// next to the destination, then rename it. If this is interrupted, the next attempt
+			// reuses everything that was already copied completely.
+
+			const auto sStaging = Path::ExcludeTrailingDelim(szNewPath) + szStagingSuffix;
+			const auto oStatus  = fs::symlink_status(szOrigPath, ec);
+			if (ec)
+				return false;
+
+			switch (oStatus.type())
+			{
+			case fs::file_type::directory:
+				if (!bReplace && Path::Exists(szNewPath))
+					return false;
+
+				if (!CopyTree(szOrigPath, sStaging.c_str(), oOptions, true))
+					return false;
+
+				if (bReplace && Path::Exists(szNewPath))
+				{
+					fs::remove_all(szNewPath, ec);
+					if (ec)
+						return false;
+				}
+				break;
+
+			case fs::file_type::regular:
+				if (Path::Exists(sStaging.c_str()) && !IsCompleteCopy(szOrigPath, sStaging.c_str()))
+					fs::remove(sStaging, ec);
+
+				if (!Path::Exists(sStaging.c_str()) &&
+					!CopyFileWithMetadata(szOrigPath, sStaging.c_str(), oOptions))
+					return false;
+
+				if (oOptions.bVerify && !SameContent(szOrigPath, sStaging.c_str()))
+				{
+					fs::remove(sStaging, ec);
+					return false;
+				}
+				break;
+
+			default:
+				fs::remove(sStaging, ec);
+				if (!CopySpecial(szOrigPath, sStaging.c_str(),
+					oStatus.type() == fs::file_type::symlink ?
+					Directory::ItemType::Symlink : Directory::ItemType::Other))
+					return false;
+			}
+
+			fs::rename(sStaging, szNewPath, ec);
+			if (ec)
+				return false;
+
+			fs::remove_all(szOrigPath, ec);
+			return !ec;
+		}
+
+	}
+
+}
\ No newline at end of file
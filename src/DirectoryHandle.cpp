@@ -0,0 +1,415 @@
+#include <rlSystem/DirectoryHandle.hpp>
+
+#include "include/CopyEngine.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include "include/DirectoryWalker.hpp"
+#include "include/IncludeWindows.h"
+#include <rlSystem/WindowsUnicodeString.hpp>
+#else
+#include <cerrno>
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+
+
+namespace rlSystem
+{
+
+	namespace Directory
+	{
+
+		namespace
+		{
+
+#ifndef _WIN32
+
+			const char *ToOS(const char8_t *sz) { return reinterpret_cast<const char *>(sz); }
+
+			/// <summary>
+			/// Get a path to an item that's resolved relative to a directory descriptor, for
+			/// functions that only take paths.
+			/// </summary>
+			std::u8string FDPath(int iDirFD, const char8_t *szName)
+			{
+				const auto sFD = std::to_string(iDirFD);
+				return u8"/proc/self/fd/" +
+					std::u8string(reinterpret_cast<const char8_t *>(sFD.c_str())) + u8"/" + szName;
+			}
+
+			unsigned ToItemType(mode_t iMode)
+			{
+				if (S_ISREG(iMode))
+					return ItemType::File;
+				if (S_ISDIR(iMode))
+					return ItemType::Directory;
+				if (S_ISLNK(iMode))
+					return ItemType::Symlink;
+				return ItemType::Other;
+			}
+
+			/// <summary>Delete an item, including the contents of directories.</summary>
+			bool DeleteAt(int iDirFD, const char *szName)
+			{
+				if (unlinkat(iDirFD, szName, 0) == 0)
+					return true;
+				if (errno != EISDIR && errno != EPERM)
+					return false;
+
+				const int iSubdirFD = openat(iDirFD, szName,
+					O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+				if (iSubdirFD < 0)
+					return false;
+
+				DIR *pDir = fdopendir(iSubdirFD);
+				if (!pDir)
+				{
+					::close(iSubdirFD);
+					return false;
+				}
+
+				// the names are collected first, deleting entries while reading the directory
+				// could skip some of them.
+				std::vector<std::string> oNames;
+				while (const dirent *pEntry = readdir(pDir))
+				{
+					const char *sz = pEntry->d_name;
+					if (sz[0] == '.' && (sz[1] == 0 || (sz[1] == '.' && sz[2] == 0)))
+						continue;
+					oNames.emplace_back(sz);
+				}
+
+				bool bResult = true;
+				for (const auto &sName : oNames)
+				{
+					if (!DeleteAt(iSubdirFD, sName.c_str()))
+					{
+						bResult = false;
+						break;
+					}
+				}
+				closedir(pDir);
+
+				return bResult && unlinkat(iDirFD, szName, AT_REMOVEDIR) == 0;
+			}
+
+#endif
+
+		}
+
+
+
+		Handle::Handle(const char8_t *szDirPath)
+		{
+#ifdef _WIN32
+			if (Directory::Exists(szDirPath))
+				m_sPath = Path::IncludeTrailingDelim(Path::Absolute(szDirPath).c_str());
+#else
+			m_iFD = open(ToOS(szDirPath), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+			if (m_iFD >= 0)
+				m_sPath = Path::IncludeTrailingDelim(Path::Absolute(szDirPath).c_str());
+#endif
+		}
+
+		Handle::Handle(Handle &&other) noexcept :
+			m_sPath(std::move(other.m_sPath))
+#ifndef _WIN32
+			, m_iFD(std::exchange(other.m_iFD, -1))
+#endif
+		{
+			other.m_sPath.clear();
+		}
+
+		Handle &Handle::operator=(Handle &&other) noexcept
+		{
+			if (this != &other)
+			{
+				close();
+
+				m_sPath = std::move(other.m_sPath);
+				other.m_sPath.clear();
+#ifndef _WIN32
+				m_iFD = std::exchange(other.m_iFD, -1);
+#endif
+			}
+
+			return *this;
+		}
+
+		Handle::~Handle() { close(); }
+
+		bool Handle::valid() const noexcept
+		{
+#ifdef _WIN32
+			return !m_sPath.empty();
+#else
+			return m_iFD >= 0;
+#endif
+		}
+
+		void Handle::close() noexcept
+		{
+#ifndef _WIN32
+			if (m_iFD >= 0)
+				::close(m_iFD);
+			m_iFD = -1;
+#endif
+			m_sPath.clear();
+		}
+
+		bool Handle::Exists(const char8_t *szName, unsigned iTypes) const
+		{
+			if (!valid())
+				return false;
+
+#ifdef _WIN32
+			std::error_code ec;
+			const auto oStatus = fs::status(m_sPath + szName, ec);
+			if (ec)
+				return false;
+
+			switch (oStatus.type())
+			{
+			case fs::file_type::regular:   return iTypes & ItemType::File;
+			case fs::file_type::directory: return iTypes & ItemType::Directory;
+			case fs::file_type::not_found: return false;
+			default:                       return iTypes & ItemType::Other;
+			}
+#else
+			struct stat oStat;
+			if (fstatat(m_iFD, ToOS(szName), &oStat, 0) != 0)
+				return false;
+
+			return iTypes & ToItemType(oStat.st_mode);
+#endif
+		}
+
+		size_t Handle::GetSize(const char8_t *szName) const
+		{
+			if (!valid())
+				return 0;
+
+#ifdef _WIN32
+			return File::GetSize((m_sPath + szName).c_str());
+#else
+			struct stat oStat;
+			if (fstatat(m_iFD, ToOS(szName), &oStat, 0) != 0 || !S_ISREG(oStat.st_mode))
+				return 0;
+
+			return (size_t)oStat.st_size;
+#endif
+		}
+
+		bool Handle::Create(const char8_t *szName) const
+		{
+			if (!valid())
+				return false;
+
+#ifdef _WIN32
+			return CreateDirectoryW(String::ToOS((m_sPath + szName).c_str()).c_str(), NULL);
+#else
+			return mkdirat(m_iFD, ToOS(szName), 0777) == 0;
+#endif
+		}
+
+		bool Handle::Delete(const char8_t *szName) const
+		{
+			if (!valid())
+				return false;
+
+#ifdef _WIN32
+			return Path::Delete((m_sPath + szName).c_str());
+#else
+			return DeleteAt(m_iFD, ToOS(szName));
+#endif
+		}
+
+		bool Handle::Move(const char8_t *szOrigName, const char8_t *szNewName, bool bReplace) const
+		{
+			return Move(szOrigName, *this, szNewName, bReplace);
+		}
+
+		bool Handle::Move(const char8_t *szOrigName, const Handle &oNewDir,
+			const char8_t *szNewName, bool bReplace) const
+		{
+			if (!valid() || !oNewDir.valid())
+				return false;
+
+#ifndef _WIN32
+			if (renameat2(m_iFD, ToOS(szOrigName), oNewDir.m_iFD, ToOS(szNewName),
+				bReplace ? 0 : RENAME_NOREPLACE) == 0)
+				return true;
+			if (errno != EXDEV)
+				return false;
+#endif
+
+			// different file systems: this can't be atomic.
+			if (!bReplace && oNewDir.Exists(szNewName))
+				return false;
+
+#ifdef _WIN32
+			const auto sOrigPath = m_sPath + szOrigName;
+			const auto sNewPath  = oNewDir.m_sPath + szNewName;
+#else
+			// via the descriptors, so the items are found even if the directories were renamed.
+			const auto sOrigPath = FDPath(m_iFD, szOrigName);
+			const auto sNewPath  = FDPath(oNewDir.m_iFD, szNewName);
+#endif
+
+			try
+			{
+				return Internal::MoveItem(sOrigPath.c_str(), sNewPath.c_str(), {}, bReplace);
+			}
+			catch (...)
+			{
+				return false;
+			}
+		}
+
+		Handle Handle::Open(const char8_t *szName) const
+		{
+			Handle oResult;
+			if (!valid())
+				return oResult;
+
+#ifdef _WIN32
+			oResult = Handle((m_sPath + szName).c_str());
+#else
+			oResult.m_iFD = openat(m_iFD, ToOS(szName), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+			if (oResult.m_iFD >= 0)
+				oResult.m_sPath = Path::IncludeTrailingDelim(
+					Path::Absolute((m_sPath + szName).c_str()).c_str());
+#endif
+
+			return oResult;
+		}
+
+		FILE *Handle::OpenFile(const char8_t *szName, const char *szMode) const
+		{
+			if (!valid() || !szMode || !std::strchr("rwa", szMode[0]))
+				return nullptr;
+
+			const bool bUpdate    = std::strchr(szMode, '+');
+			const bool bExclusive = std::strchr(szMode, 'x');
+
+			std::string sMode(1, szMode[0]);
+			if (bUpdate)
+				sMode += '+';
+			sMode += 'b';
+
+#ifdef _WIN32
+			// the CRT creates the file exclusively itself.
+			if (bExclusive)
+				sMode += 'x';
+
+			return _wfopen(String::ToOS((m_sPath + szName).c_str()).c_str(),
+				String::ToOS(reinterpret_cast<const char8_t *>(sMode.c_str())).c_str());
+#else
+			int iFlags = bUpdate ? O_RDWR : (szMode[0] == 'r' ? O_RDONLY : O_WRONLY);
+			switch (szMode[0])
+			{
+			case 'w': iFlags |= O_CREAT | O_TRUNC;  break;
+			case 'a': iFlags |= O_CREAT | O_APPEND; break;
+			}
+			if (bExclusive)
+				iFlags |= O_EXCL;
+
+			const int iFD = openat(m_iFD, ToOS(szName), iFlags | O_CLOEXEC, 0666);
+			if (iFD < 0)
+				return nullptr;
+
+			// the mode without 'x', which fdopen doesn't need.
+			FILE *pFile = fdopen(iFD, sMode.c_str());
+			if (!pFile)
+				::close(iFD);
+			return pFile;
+#endif
+		}
+
+		bool Handle::Enumerate(
+			const std::function<bool(std::u8string_view sName, unsigned iType)> &fnCallback) const
+		{
+			if (!valid())
+				return false;
+
+#ifdef _WIN32
+			return Internal::Walk(m_sPath.c_str(), 0, false,
+				[&](Internal::WalkEntry &oEntry)
+				{
+					return fnCallback(oEntry.sName, oEntry.iType) ?
+						Internal::WalkAction::Continue : Internal::WalkAction::Stop;
+				});
+#else
+			// a new descriptor, so the read position of m_iFD isn't shared.
+			const int iFD = openat(m_iFD, ".", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+			if (iFD < 0)
+				return false;
+
+			DIR *pDir = fdopendir(iFD);
+			if (!pDir)
+			{
+				::close(iFD);
+				return false;
+			}
+
+			// readdir returns nullptr both at the end and on errors; only the latter set errno.
+			errno = 0;
+			bool bStopped = false;
+			while (const dirent *pEntry = readdir(pDir))
+			{
+				const char *sz = pEntry->d_name;
+				if (sz[0] == '.' && (sz[1] == 0 || (sz[1] == '.' && sz[2] == 0)))
+					continue;
+
+				unsigned iType;
+				switch (pEntry->d_type)
+				{
+				case DT_REG: iType = ItemType::File;      break;
+				case DT_DIR: iType = ItemType::Directory; break;
+				case DT_LNK: iType = ItemType::Symlink;   break;
+
+				case DT_UNKNOWN: // not all file systems report the type
+				{
+					struct stat oStat;
+					if (fstatat(iFD, sz, &oStat, AT_SYMLINK_NOFOLLOW) != 0)
+					{
+						errno = 0; // e.g. deleted in the meantime
+						continue;
+					}
+					iType = ToItemType(oStat.st_mode);
+					break;
+				}
+
+				default:
+					iType = ItemType::Other;
+				}
+
+				if (!fnCallback(reinterpret_cast<const char8_t *>(sz), iType))
+				{
+					bStopped = true;
+					break;
+				}
+				errno = 0;
+			}
+			const bool bReadError = !bStopped && errno != 0;
+
+			closedir(pDir);
+			return !bReadError;
+#endif
+		}
+
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,395 @@
+#include "include/DirectoryWalker.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#ifdef _WIN32
+#include "include/IncludeWindows.h"
+#include <rlSystem/WindowsUnicodeString.hpp>
+#else
+#include <cerrno>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+
+namespace rlSystem
+{
+
+	namespace Internal
+	{
+
+		namespace
+		{
+
+#ifdef _WIN32
+			Directory::FileTime ToFileTime(const FILETIME &ft)
+			{
+				// FILETIME: 100 ns intervals since 1601-01-01
+				constexpr int64_t iEpochDiff = 116444736000000000; // 1601-01-01 --> 1970-01-01
+
+				const int64_t iTicks =
+					(int64_t(ft.dwHighDateTime) << 32 | ft.dwLowDateTime) - iEpochDiff;
+				return Directory::FileTime(std::chrono::duration_cast<Directory::FileTime::duration>(
+					std::chrono::nanoseconds(iTicks * 100)));
+			}
+#else
+			Directory::FileTime ToFileTime(const struct timespec &ts)
+			{
+				return Directory::FileTime(std::chrono::duration_cast<Directory::FileTime::duration>(
+					std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec)));
+			}
+
+			unsigned ToItemType(mode_t iMode)
+			{
+				if (S_ISREG(iMode))
+					return Directory::ItemType::File;
+				if (S_ISDIR(iMode))
+					return Directory::ItemType::Directory;
+				if (S_ISLNK(iMode))
+					return Directory::ItemType::Symlink;
+				return Directory::ItemType::Other;
+			}
+#endif
+
+		}
+
+
+
+		class WalkerImpl final
+		{
+		public: // methods
+
+			WalkerImpl(unsigned iMaxDepth, bool bSorted, bool bStrict,
+				const WalkCallback &fnCallback) :
+				m_iMaxDepth(iMaxDepth), m_bSorted(bSorted), m_bStrict(bStrict),
+				m_fnCallback(fnCallback) {}
+
+			bool Run(const char8_t *szRoot)
+			{
+				m_sPath = Path::IncludeTrailingDelim(Path::Absolute(szRoot).c_str());
+				m_iRootLength = m_sPath.length();
+
+#ifdef _WIN32
+				m_sPathOS = String::ToOS(m_sPath.c_str());
+				if (!Directory::Exists(m_sPath.c_str()))
+					return false;
+
+				WalkDir(0);
+				return !m_bIncomplete;
+#else
+				const int iFD = open(reinterpret_cast<const char *>(m_sPath.c_str()),
+					O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+				if (iFD < 0)
+					return false;
+
+				WalkDir(iFD, 0);
+				return !m_bIncomplete;
+#endif
+			}
+
+
+		private: // methods
+
+			/// <summary>
+			/// Handle a subdirectory or an item that can't be read: it's skipped, unless the walk
+			/// is strict.
+			/// </summary>
+			/// <returns><c>false</c> if the walk should be stopped.</returns>
+			bool Unreadable()
+			{
+				if (!m_bStrict)
+					return true;
+
+				m_bIncomplete = true;
+				return false;
+			}
+
+#ifdef _WIN32
+
+			/// <returns><c>false</c> if the walk should be stopped.</returns>
+			bool WalkDir(unsigned iDepth)
+			{
+				WIN32_FIND_DATAW fd;
+				HANDLE hFind = FindFirstFileExW((m_sPathOS + L"*").c_str(), FindExInfoBasic, &fd,
+					FindExSearchNameMatch, NULL, FIND_FIRST_EX_LARGE_FETCH);
+				if (hFind == INVALID_HANDLE_VALUE)
+					return Unreadable();
+
+				bool bContinue = true;
+				if (!m_bSorted)
+				{
+					do
+					{
+						bContinue = ProcessEntry(fd, iDepth);
+					} while (bContinue && FindNextFileW(hFind, &fd));
+					if (bContinue && GetLastError() != ERROR_NO_MORE_FILES)
+						bContinue = Unreadable();
+					FindClose(hFind);
+				}
+				else
+				{
+					std::vector<std::pair<std::u8string, WIN32_FIND_DATAW>> oEntries;
+					do
+					{
+						oEntries.emplace_back(String::FromOS(fd.cFileName), fd);
+					} while (FindNextFileW(hFind, &fd));
+					const bool bComplete = GetLastError() == ERROR_NO_MORE_FILES;
+					FindClose(hFind);
+					if (!bComplete && !Unreadable())
+						return false;
+
+					std::sort(oEntries.begin(), oEntries.end(),
+						[](const auto &a, const auto &b) { return a.first < b.first; });
+
+					for (const auto &[sName, oData] : oEntries)
+					{
+						if (!ProcessEntry(oData, iDepth))
+						{
+							bContinue = false;
+							break;
+						}
+					}
+				}
+
+				return bContinue;
+			}
+
+			/// <returns><c>false</c> if the walk should be stopped.</returns>
+			bool ProcessEntry(const WIN32_FIND_DATAW &fd, unsigned iDepth)
+			{
+				if (wcscmp(fd.cFileName, L".") == 0 || wcscmp(fd.cFileName, L"..") == 0)
+					return true;
+
+				const size_t iPathLen   = m_sPath.length();
+				const size_t iPathLenOS = m_sPathOS.length();
+
+				const auto sName = String::FromOS(fd.cFileName);
+				m_sPath += sName;
+
+				WalkEntry oEntry;
+				oEntry.sPath         = m_sPath;
+				oEntry.sRelativePath = std::u8string_view(m_sPath).substr(m_iRootLength);
+				oEntry.sName         = sName;
+				oEntry.iDepth        = iDepth;
+				oEntry.bHidden       = fd.dwFileAttributes & FILE_ATTRIBUTE_HIDDEN;
+
+				if (fd.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT)
+					oEntry.iType = Directory::ItemType::Symlink;
+				else if (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+					oEntry.iType = Directory::ItemType::Directory;
+				else if (fd.dwFileAttributes & FILE_ATTRIBUTE_DEVICE)
+					oEntry.iType = Directory::ItemType::Other;
+				else
+					oEntry.iType = Directory::ItemType::File;
+
+				oEntry.m_bHasMetadata = true;
+				oEntry.m_iSize        = uint64_t(fd.nFileSizeHigh) << 32 | fd.nFileSizeLow;
+				oEntry.m_tModified    = ToFileTime(fd.ftLastWriteTime);
+
+				bool bContinue = true;
+
+				const auto eAction = m_fnCallback(oEntry);
+				if (eAction == WalkAction::Stop)
+					bContinue = false;
+				else if (eAction == WalkAction::Continue &&
+					oEntry.iType == Directory::ItemType::Directory && iDepth < m_iMaxDepth)
+				{
+					m_sPath += Path::Delimiter;
+					m_sPathOS += fd.cFileName;
+					m_sPathOS += L'\\';
+
+					bContinue = WalkDir(iDepth + 1);
+
+					m_sPathOS.resize(iPathLenOS);
+				}
+
+				m_sPath.resize(iPathLen);
+				return bContinue;
+			}
+
+#else
+
+			/// <summary>Walk a directory. Takes ownership of <c>iDirFD</c>.</summary>
+			/// <returns><c>false</c> if the walk should be stopped.</returns>
+			bool WalkDir(int iDirFD, unsigned iDepth)
+			{
+				DIR *pDir = fdopendir(iDirFD);
+				if (!pDir)
+				{
+					close(iDirFD);
+					return Unreadable();
+				}
+
+				bool bContinue = true;
+				if (!m_bSorted)
+				{
+					while (bContinue)
+					{
+						errno = 0;
+						const dirent *pEntry = readdir(pDir);
+						if (!pEntry)
+						{
+							if (errno != 0)
+								bContinue = Unreadable();
+							break;
+						}
+
+						bContinue = ProcessEntry(iDirFD, pEntry->d_name, pEntry->d_type, iDepth);
+					}
+				}
+				else
+				{
+					std::vector<std::pair<std::string, unsigned char>> oEntries;
+					for (;;)
+					{
+						errno = 0;
+						const dirent *pEntry = readdir(pDir);
+						if (!pEntry)
+							break;
+
+						oEntries.emplace_back(pEntry->d_name, pEntry->d_type);
+					}
+					if (errno != 0 && !Unreadable())
+					{
+						closedir(pDir);
+						return false;
+					}
+					std::sort(oEntries.begin(), oEntries.end());
+
+					for (const auto &[sName, iType] : oEntries)
+					{
+						if (!ProcessEntry(iDirFD, sName.c_str(), iType, iDepth))
+						{
+							bContinue = false;
+							break;
+						}
+					}
+				}
+
+				closedir(pDir);
+				return bContinue;
+			}
+
+			/// <returns><c>false</c> if the walk should be stopped.</returns>
+			bool ProcessEntry(int iDirFD, const char *szName, unsigned char iDirentType,
+				unsigned iDepth)
+			{
+				if (szName[0] == '.' && (szName[1] == 0 || (szName[1] == '.' && szName[2] == 0)))
+					return true;
+
+				WalkEntry oEntry;
+				oEntry.m_iDirFD = iDirFD;
+
+				switch (iDirentType)
+				{
+				case DT_REG: oEntry.iType = Directory::ItemType::File;      break;
+				case DT_DIR: oEntry.iType = Directory::ItemType::Directory; break;
+				case DT_LNK: oEntry.iType = Directory::ItemType::Symlink;   break;
+
+				case DT_UNKNOWN: // not all file systems report the type
+				{
+					struct stat oStat;
+					if (fstatat(iDirFD, szName, &oStat, AT_SYMLINK_NOFOLLOW) != 0)
+						return Unreadable();
+
+					oEntry.iType          = ToItemType(oStat.st_mode);
+					oEntry.m_bHasMetadata = true;
+					oEntry.m_iSize        = (uint64_t)oStat.st_size;
+					oEntry.m_tModified    = ToFileTime(oStat.st_mtim);
+					break;
+				}
+
+				default:
+					oEntry.iType = Directory::ItemType::Other;
+				}
+
+				const size_t iPathLen = m_sPath.length();
+				m_sPath += reinterpret_cast<const char8_t *>(szName);
+
+				oEntry.sPath         = m_sPath;
+				oEntry.sRelativePath = std::u8string_view(m_sPath).substr(m_iRootLength);
+				oEntry.sName         = std::u8string_view(m_sPath).substr(iPathLen);
+				oEntry.iDepth        = iDepth;
+				oEntry.bHidden       = szName[0] == '.';
+
+				bool bContinue = true;
+
+				const auto eAction = m_fnCallback(oEntry);
+				if (eAction == WalkAction::Stop)
+					bContinue = false;
+				else if (eAction == WalkAction::Continue &&
+					oEntry.iType == Directory::ItemType::Directory && iDepth < m_iMaxDepth)
+				{
+					const int iSubdirFD = openat(iDirFD, szName,
+						O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+					if (iSubdirFD >= 0)
+					{
+						m_sPath += Path::Delimiter;
+						bContinue = WalkDir(iSubdirFD, iDepth + 1);
+					}
+					else
+						bContinue = Unreadable();
+				}
+
+				m_sPath.resize(iPathLen);
+				return bContinue;
+			}
+
+#endif
+
+
+		private: // variables
+
+			const unsigned      m_iMaxDepth;
+			const bool          m_bSorted;
+			const bool          m_bStrict;
+			const WalkCallback &m_fnCallback;
+			bool                m_bIncomplete = false; // a strict walk failed
+
+			std::u8string m_sPath; // path of the current item
+			size_t        m_iRootLength = 0;
+#ifdef _WIN32
+			std::wstring  m_sPathOS;
+#endif
+
+		};
+
+
+
+		bool WalkEntry::FetchMetadata()
+		{
+			if (m_bHasMetadata)
+				return true;
+
+#ifdef _WIN32
+			return false; // always set by the walker
+#else
+			// the name is the last part of the path and zero-terminated.
+			struct stat oStat;
+			if (fstatat(m_iDirFD, reinterpret_cast<const char *>(sName.data()), &oStat,
+				AT_SYMLINK_NOFOLLOW) != 0)
+				return false;
+
+			m_bHasMetadata = true;
+			m_iSize        = (uint64_t)oStat.st_size;
+			m_tModified    = ToFileTime(oStat.st_mtim);
+			return true;
+#endif
+		}
+
+		bool Walk(const char8_t *szRoot, unsigned iMaxDepth, bool bSorted,
+			const WalkCallback &fnCallback, bool bStrict)
+		{
+			WalkerImpl oWalker(iMaxDepth, bSorted, bStrict, fnCallback);
+			return oWalker.Run(szRoot);
+		}
+
+	}
+
+}
\ No newline at end of file
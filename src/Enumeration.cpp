@@ -0,0 +1,452 @@
+#include <rlSystem/FileSystem.hpp>
+
+#include "include/DirectoryWalker.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+
+
+namespace rlSystem
+{
+
+	namespace Directory
+	{
+
+		namespace
+		{
+
+			using Internal::WalkAction;
+			using Internal::WalkEntry;
+
+			std::u8string_view GetNameView(const std::u8string &sPath)
+			{
+#ifdef _WIN32
+				const size_t iPos = sPath.find_last_of(u8"\\/");
+#else
+				const size_t iPos = sPath.rfind(Path::Delimiter);
+#endif
+				if (iPos == std::u8string::npos)
+					return sPath;
+				return std::u8string_view(sPath).substr(iPos + 1);
+			}
+
+			/// <summary>
+			/// The exclusion rules that apply to the entries of a walk: <c>Filter::pExclusions</c>
+			/// and the rules of the ignore files of all directories on the current path.
+			/// </summary>
+			class ExclusionScope final
+			{
+			public: // methods
+
+				/// <param name="szDirPath">The walked directory.</param>
+				/// <param name="iDepthOffset">
+				/// The depth of <c>szDirPath</c>'s items in the search. If it's 1,
+				/// <c>szDirPath</c> is a subdirectory of the searched directory.
+				/// </param>
+				ExclusionScope(const Filter &oFilter, const char8_t *szDirPath,
+					unsigned iDepthOffset) :
+					m_pBase(oFilter.pExclusions),
+					m_sIgnoreFileName(oFilter.sIgnoreFileName),
+					m_bCaseSensitive(!m_pBase || m_pBase->caseSensitive()),
+					m_iDepthOffset(iDepthOffset)
+				{
+					if (!active() || iDepthOffset == 0)
+						return;
+
+					// paths are checked relative to the searched directory.
+					const std::u8string sDirPath = Path::ExcludeTrailingDelim(szDirPath);
+					const auto sName = GetNameView(sDirPath);
+					m_sPrefix = sName;
+					m_sPrefix += Path::Delimiter;
+
+					if (!m_sIgnoreFileName.empty())
+					{
+						const auto sParent = std::u8string_view(sDirPath).substr(0,
+							sDirPath.length() - sName.length());
+						m_oLevels.emplace_back(m_bCaseSensitive).AddFile(
+							(std::u8string(sParent) + m_sIgnoreFileName).c_str());
+					}
+				}
+
+				bool active() const noexcept { return m_pBase || !m_sIgnoreFileName.empty(); }
+
+				/// <summary>
+				/// Is an entry excluded by the rules?<para/>
+				/// Must be called for every directory that's descended into.
+				/// </summary>
+				bool IsExcluded(const WalkEntry &oEntry)
+				{
+					std::u8string_view sPath = oEntry.sRelativePath;
+					if (!m_sPrefix.empty())
+					{
+						m_sPath.assign(m_sPrefix);
+						m_sPath += sPath;
+						sPath = m_sPath;
+					}
+					const bool bDirectory = oEntry.iType == ItemType::Directory;
+
+					if (!m_sIgnoreFileName.empty())
+					{
+						// m_oLevels[i] belongs to the directory containing the items at depth i.
+						const size_t iLevel = oEntry.iDepth + m_iDepthOffset;
+						if (m_oLevels.size() > iLevel + 1)
+							m_oLevels.erase(m_oLevels.begin() + (iLevel + 1), m_oLevels.end());
+						else if (m_oLevels.size() == iLevel)
+						{
+							// the first item of a directory.
+							const size_t iNameLen = oEntry.sName.length();
+							std::u8string sFilePath(
+								oEntry.sPath.substr(0, oEntry.sPath.length() - iNameLen));
+							sFilePath += m_sIgnoreFileName;
+
+							m_oLevels.emplace_back(m_bCaseSensitive).AddFile(sFilePath.c_str(),
+								sPath.substr(0, sPath.length() - iNameLen));
+						}
+
+						// the innermost directory's rules take precedence.
+						for (size_t i = m_oLevels.size(); i-- > 0;)
+						{
+							const auto eResult = m_oLevels[i].Check(sPath, bDirectory);
+							if (eResult != ExclusionRules::Result::None)
+								return eResult == ExclusionRules::Result::Excluded;
+						}
+					}
+
+					return m_pBase && m_pBase->IsExcluded(sPath, bDirectory);
+				}
+
+
+			private: // variables
+
+				const ExclusionRules *const m_pBase;
+				const std::u8string        &m_sIgnoreFileName;
+				const bool                  m_bCaseSensitive;
+				const unsigned              m_iDepthOffset;
+
+				std::u8string               m_sPrefix; // relative path of the walked directory
+				std::u8string               m_sPath;
+				std::vector<ExclusionRules> m_oLevels; // rules of the ignore files
+
+			};
+
+			/// <summary>Applies a <c>Filter</c> to the entries of a walk.</summary>
+			class FilterEvaluator final
+			{
+			public: // methods
+
+				/// <param name="szDirPath">The walked directory.</param>
+				/// <param name="iDepthOffset">
+				/// The depth of <c>szDirPath</c>'s items in the search.
+				/// </param>
+				FilterEvaluator(const Filter &oFilter, const char8_t *szDirPath,
+					unsigned iDepthOffset) :
+					m_oFilter(oFilter),
+					m_iDepthOffset(iDepthOffset),
+					m_oExclusions(oFilter, szDirPath, iDepthOffset),
+					m_bFilterSize(oFilter.iMinSize > 0 || oFilter.iMaxSize < UINT64_MAX),
+					m_bFilterTime(oFilter.tMinModified > FileTime::min() ||
+						oFilter.tMaxModified < FileTime::max())
+				{}
+
+				/// <summary>Check an entry.</summary>
+				/// <param name="oItem">
+				/// If the entry should be reported, this variable receives its data.
+				/// </param>
+				/// <param name="bReport">Receives whether the entry should be reported.</param>
+				/// <returns>
+				/// <c>WalkAction::SkipChildren</c> if the entry is a directory that's excluded
+				/// completely, <c>WalkAction::Continue</c> otherwise.
+				/// </returns>
+				WalkAction Evaluate(WalkEntry &oEntry, Item &oItem, bool &bReport)
+				{
+					bReport = false;
+
+					if (m_oFilter.eHidden == HiddenFilter::VisibleOnly && oEntry.bHidden)
+						return WalkAction::SkipChildren;
+
+					if (m_oExclusions.active() && m_oExclusions.IsExcluded(oEntry))
+						return WalkAction::SkipChildren;
+
+					if (!(oEntry.iType & m_oFilter.iTypes) ||
+						(m_oFilter.eHidden == HiddenFilter::HiddenOnly && !oEntry.bHidden))
+						return WalkAction::Continue;
+
+					size_t iPattern = PatternSet::NoMatch;
+					if (m_oFilter.pPatterns)
+					{
+						iPattern = m_oFilter.pPatterns->Match(oEntry.sName);
+						if (iPattern == PatternSet::NoMatch)
+							return WalkAction::Continue;
+					}
+
+					const bool bIsFile = oEntry.iType == ItemType::File;
+					if ((m_bFilterSize && bIsFile) || m_bFilterTime || m_oFilter.bFetchMetadata)
+					{
+						if (!oEntry.FetchMetadata())
+							return WalkAction::Continue;
+
+						if (bIsFile && (oEntry.size() < m_oFilter.iMinSize ||
+							oEntry.size() > m_oFilter.iMaxSize))
+							return WalkAction::Continue;
+
+						if (oEntry.modified() < m_oFilter.tMinModified ||
+							oEntry.modified() > m_oFilter.tMaxModified)
+							return WalkAction::Continue;
+
+						oItem.iSize     = oEntry.size();
+						oItem.tModified = oEntry.modified();
+					}
+					else
+					{
+						oItem.iSize     = 0;
+						oItem.tModified = {};
+					}
+
+					oItem.sPath    = oEntry.sPath;
+					oItem.iType    = oEntry.iType;
+					oItem.iDepth   = oEntry.iDepth + m_iDepthOffset;
+					oItem.iPattern = iPattern;
+
+					bReport = true;
+					return WalkAction::Continue;
+				}
+
+
+			private: // variables
+
+				const Filter  &m_oFilter;
+				const unsigned m_iDepthOffset;
+				ExclusionScope m_oExclusions;
+				const bool     m_bFilterSize;
+				const bool     m_bFilterTime;
+
+			};
+
+			/// <summary>Enumerate a (sub)directory.</summary>
+			/// <param name="iDepthOffset">The depth of <c>szDirPath</c>'s items in the search.</param>
+			bool EnumerateImpl(const char8_t *szDirPath, const Filter &oFilter,
+				unsigned iDepthOffset, bool bSorted,
+				const std::function<bool(const Item &oItem)> &fnCallback)
+			{
+				if (iDepthOffset > oFilter.iMaxDepth)
+					return true;
+
+				FilterEvaluator oEvaluator(oFilter, szDirPath, iDepthOffset);
+				Item oItem;
+
+				return Internal::Walk(szDirPath, oFilter.iMaxDepth - iDepthOffset, bSorted,
+					[&](WalkEntry &oEntry) -> WalkAction
+					{
+						bool bReport;
+						const auto eAction = oEvaluator.Evaluate(oEntry, oItem, bReport);
+
+						if (bReport && !fnCallback(oItem))
+							return WalkAction::Stop;
+						return eAction;
+					});
+			}
+
+		}
+
+
+
+		bool Enumerate(const char8_t *szDirPath, const Filter &oFilter,
+			const std::function<bool(const Item &oItem)> &fnCallback)
+		{
+			return EnumerateImpl(szDirPath, oFilter, 0, false, fnCallback);
+		}
+
+		std::vector<Item> Enumerate(const char8_t *szDirPath, const Filter &oFilter)
+		{
+			std::vector<Item> oResult;
+			Enumerate(szDirPath, oFilter, [&](const Item &oItem)
+			{
+				oResult.push_back(oItem);
+				return true;
+			});
+
+			return oResult;
+		}
+
+		bool EnumerateSorted(const char8_t *szDirPath, const Filter &oFilter,
+			const std::function<bool(const Item &oItem)> &fnCallback)
+		{
+			return EnumerateImpl(szDirPath, oFilter, 0, true, fnCallback);
+		}
+
+
+
+		TopItems::TopItems(size_t iCount, SortKey eKey, bool bDescending) :
+			m_iCount(iCount), m_eKey(eKey), m_bDescending(bDescending)
+		{
+			m_oHeap.reserve(std::min<size_t>(iCount, 4096));
+		}
+
+		bool TopItems::Add(const Item &oItem)
+		{
+			if (m_iCount == 0)
+				return false;
+
+			const auto fnLess = [this](const Item &a, const Item &b) { return Better(a, b); };
+
+			if (m_oHeap.size() < m_iCount)
+			{
+				m_oHeap.push_back(oItem);
+				std::push_heap(m_oHeap.begin(), m_oHeap.end(), fnLess);
+				return true;
+			}
+
+			// the heap's front is the worst item that's kept.
+			if (!Better(oItem, m_oHeap.front()))
+				return false;
+
+			std::pop_heap(m_oHeap.begin(), m_oHeap.end(), fnLess);
+			m_oHeap.back() = oItem;
+			std::push_heap(m_oHeap.begin(), m_oHeap.end(), fnLess);
+			return true;
+		}
+
+		void TopItems::Merge(TopItems &&oOther)
+		{
+			for (auto &oItem : oOther.m_oHeap)
+			{
+				Add(oItem);
+			}
+			oOther.m_oHeap.clear();
+		}
+
+		std::vector<Item> TopItems::Take()
+		{
+			const auto fnLess = [this](const Item &a, const Item &b) { return Better(a, b); };
+			std::sort_heap(m_oHeap.begin(), m_oHeap.end(), fnLess);
+
+			std::vector<Item> oResult;
+			oResult.swap(m_oHeap);
+			return oResult;
+		}
+
+		bool TopItems::Better(const Item &a, const Item &b) const
+		{
+			int iCompare = 0;
+			switch (m_eKey)
+			{
+			case SortKey::Name:
+				iCompare = GetNameView(a.sPath).compare(GetNameView(b.sPath));
+				break;
+
+			case SortKey::Size:
+				iCompare = a.iSize < b.iSize ? -1 : (a.iSize > b.iSize ? 1 : 0);
+				break;
+
+			case SortKey::Modified:
+				iCompare = a.tModified < b.tModified ? -1 : (a.tModified > b.tModified ? 1 : 0);
+				break;
+			}
+
+			if (m_bDescending)
+				iCompare = -iCompare;
+
+			// ties are broken by the path, so the result doesn't depend on the walk order.
+			if (iCompare == 0)
+				return a.sPath < b.sPath;
+			return iCompare < 0;
+		}
+
+		std::vector<Item> GetTop(
+			const char8_t *szDirPath,
+			const Filter  &oFilter,
+			      SortKey  eKey,
+			      size_t   iCount,
+			      bool     bDescending,
+			      unsigned iThreads
+		)
+		{
+			Filter oTopFilter = oFilter;
+			if (eKey != SortKey::Name)
+				oTopFilter.bFetchMetadata = true;
+
+			TopItems oTop(iCount, eKey, bDescending);
+
+			if (iThreads == 0)
+				iThreads = std::max(1u, std::thread::hardware_concurrency());
+
+			if (iThreads == 1 || oTopFilter.iMaxDepth == 0)
+			{
+				EnumerateImpl(szDirPath, oTopFilter, 0, false, [&](const Item &oItem)
+				{
+					oTop.Add(oItem);
+					return true;
+				});
+				return oTop.Take();
+			}
+
+
+
+			// The items directly inside the directory are handled here, every subdirectory is
+			// a separate partition with its own top list. The lists are merged afterwards.
+
+			std::vector<std::u8string> oSubdirs;
+			{
+				FilterEvaluator oEvaluator(oTopFilter, szDirPath, 0);
+				Item oItem;
+
+				const bool bOK = Internal::Walk(szDirPath, 0, false,
+					[&](WalkEntry &oEntry) -> WalkAction
+					{
+						bool bReport;
+						const auto eAction = oEvaluator.Evaluate(oEntry, oItem, bReport);
+						if (bReport)
+							oTop.Add(oItem);
+
+						if (oEntry.iType == ItemType::Directory && eAction == WalkAction::Continue)
+							oSubdirs.emplace_back(oEntry.sPath);
+						return WalkAction::SkipChildren;
+					});
+				if (!bOK)
+					return {};
+			}
+
+			std::atomic<size_t> iNextSubdir = 0;
+			std::mutex muxMerge;
+
+			const auto fnWorker = [&]
+			{
+				TopItems oPartial(iCount, eKey, bDescending);
+
+				for (size_t i = iNextSubdir++; i < oSubdirs.size(); i = iNextSubdir++)
+				{
+					EnumerateImpl(oSubdirs[i].c_str(), oTopFilter, 1, false, [&](const Item &oItem)
+					{
+						oPartial.Add(oItem);
+						return true;
+					});
+				}
+
+				std::unique_lock lock(muxMerge);
+				oTop.Merge(std::move(oPartial));
+			};
+
+			iThreads = (unsigned)std::min<size_t>(iThreads, oSubdirs.size());
+
+			std::vector<std::thread> oThreads;
+			oThreads.reserve(iThreads);
+			for (unsigned i = 1; i < iThreads; ++i)
+			{
+				oThreads.emplace_back(fnWorker);
+			}
+			fnWorker();
+
+			for (auto &oThread : oThreads)
+			{
+				oThread.join();
+			}
+
+			return oTop.Take();
+		}
+
+	}
+
+}
\ No newline at end of file
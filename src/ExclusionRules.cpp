@@ -0,0 +1,360 @@
+#include <rlSystem/ExclusionRules.hpp>
+
+#include <rlSystem/FileSystem.hpp>
+#include <rlSystem/UnicodeCaseFolding.hpp>
+
+#include <algorithm>
+
+
+
+namespace rlSystem
+{
+
+	namespace
+	{
+
+		bool IsContinuationByte(unsigned c) { return (c & 0xC0) == 0x80; }
+
+		/// <summary>Get the position of the character after the one at <c>s[i]</c>.</summary>
+		size_t NextCharacter(std::u8string_view s, size_t i) noexcept
+		{
+			++i;
+			while (i < s.length() && IsContinuationByte(s[i]))
+			{
+				++i;
+			}
+			return i;
+		}
+
+		/// <summary>Does a string contain glob syntax?</summary>
+		bool HasWildcards(std::u8string_view s) noexcept
+		{
+			return s.find_first_of(u8"*?[\\") != std::u8string_view::npos;
+		}
+
+		/// <summary>Match a bracket expression at <c>sGlob[i]</c> against <c>s[j]</c>.</summary>
+		/// <param name="iEnd">Receives the position after the closing bracket.</param>
+		/// <returns>
+		/// Does the character match? If the bracket isn't closed, <c>iEnd</c> is set to
+		/// <c>npos</c> and the <c>[</c> is to be treated as a literal.
+		/// </returns>
+		bool MatchClass(std::u8string_view sGlob, size_t i, std::u8string_view s, size_t j,
+			size_t &iEnd) noexcept
+		{
+			const char8_t c = s[j];
+
+			++i;
+			bool bNegated = false;
+			if (i < sGlob.length() && (sGlob[i] == u8'!' || sGlob[i] == u8'^'))
+			{
+				bNegated = true;
+				++i;
+			}
+
+			bool bMatch = false;
+			for (bool bFirst = true; i < sGlob.length() && (bFirst || sGlob[i] != u8']');
+				bFirst = false)
+			{
+				char8_t cLow = sGlob[i++];
+				if (cLow == u8'\\' && i < sGlob.length())
+					cLow = sGlob[i++];
+
+				char8_t cHigh = cLow;
+				if (i + 1 < sGlob.length() && sGlob[i] == u8'-' && sGlob[i + 1] != u8']')
+				{
+					i += 2;
+					cHigh = sGlob[i - 1];
+					if (cHigh == u8'\\' && i < sGlob.length())
+						cHigh = sGlob[i++];
+				}
+
+				// only ASCII characters are supported.
+				if (c < 0x80 && c >= cLow && c <= cHigh)
+					bMatch = true;
+			}
+
+			if (i >= sGlob.length())
+			{
+				iEnd = std::u8string_view::npos;
+				return false;
+			}
+
+			iEnd = i + 1;
+			return bMatch != bNegated;
+		}
+
+		/// <summary>Match a glob against a whole string (Git's wildmatch semantics).</summary>
+		bool MatchGlob(std::u8string_view sGlob, std::u8string_view s) noexcept
+		{
+			size_t i = 0; // in sGlob
+			size_t j = 0; // in s
+			while (i < sGlob.length())
+			{
+				switch (sGlob[i])
+				{
+				case u8'*':
+				{
+					const size_t iFirstStar = i;
+					while (i < sGlob.length() && sGlob[i] == u8'*')
+					{
+						++i;
+					}
+
+					// "**" as a whole path component also matches slashes.
+					const bool bAnyDepth = i - iFirstStar >= 2 &&
+						(iFirstStar == 0 || sGlob[iFirstStar - 1] == u8'/') &&
+						(i == sGlob.length() || sGlob[i] == u8'/');
+
+					if (bAnyDepth)
+					{
+						if (i == sGlob.length())
+							return true;
+
+						// "**/": any number of directories, including none.
+						const auto sRest = sGlob.substr(i + 1);
+						for (size_t k = j; ; ++k)
+						{
+							if (MatchGlob(sRest, s.substr(k)))
+								return true;
+
+							k = s.find(u8'/', k);
+							if (k == std::u8string_view::npos)
+								return false;
+						}
+					}
+
+					const auto sRest = sGlob.substr(i);
+					if (sRest.empty())
+						return s.find(u8'/', j) == std::u8string_view::npos;
+
+					for (size_t k = j; ; k = NextCharacter(s, k))
+					{
+						if (MatchGlob(sRest, s.substr(k)))
+							return true;
+
+						if (k == s.length() || s[k] == u8'/')
+							return false;
+					}
+				}
+
+				case u8'?':
+					if (j == s.length() || s[j] == u8'/')
+						return false;
+					j = NextCharacter(s, j);
+					++i;
+					break;
+
+				case u8'[':
+				{
+					if (j == s.length() || s[j] == u8'/')
+						return false;
+
+					size_t iEnd;
+					const bool bMatch = MatchClass(sGlob, i, s, j, iEnd);
+					if (iEnd != std::u8string_view::npos)
+					{
+						if (!bMatch)
+							return false;
+						j = NextCharacter(s, j);
+						i = iEnd;
+						break;
+					}
+
+					// not a bracket expression
+					[[fallthrough]];
+				}
+
+				default:
+				{
+					char8_t c = sGlob[i++];
+					if (c == u8'\\' && i < sGlob.length())
+						c = sGlob[i++];
+
+					if (j == s.length() || s[j] != c)
+						return false;
+					++j;
+					break;
+				}
+				}
+			}
+
+			return j == s.length();
+		}
+
+		/// <summary>
+		/// Bring a relative directory path into the form used in rules: <c>/</c> as delimiter,
+		/// no leading delimiter, a trailing one unless it's empty.
+		/// </summary>
+		std::u8string NormalizeBase(std::u8string_view sBase)
+		{
+			std::u8string sResult(sBase);
+#ifdef _WIN32
+			std::replace(sResult.begin(), sResult.end(), u8'\\', u8'/');
+#endif
+			const size_t iFirst = sResult.find_first_not_of(u8'/');
+			if (iFirst == std::u8string::npos)
+				return {};
+			sResult.erase(0, iFirst);
+
+			if (sResult.back() != u8'/')
+				sResult += u8'/';
+			return sResult;
+		}
+
+	}
+
+
+
+	ExclusionRules::ExclusionRules(bool bCaseSensitive) : m_bCaseSensitive(bCaseSensitive) {}
+
+	bool ExclusionRules::AddRule(std::u8string_view sRule, std::u8string_view sBase)
+	{
+		if (!sRule.empty() && sRule.back() == u8'\r')
+			sRule.remove_suffix(1);
+		if (sRule.empty() || sRule.front() == u8'#')
+			return false;
+
+		// trailing spaces are ignored unless they're escaped.
+		while (!sRule.empty() && sRule.back() == u8' ' &&
+			(sRule.length() < 2 || sRule[sRule.length() - 2] != u8'\\'))
+			sRule.remove_suffix(1);
+
+		Rule oRule{};
+		if (!sRule.empty() && sRule.front() == u8'!')
+		{
+			oRule.bNegated = true;
+			sRule.remove_prefix(1);
+		}
+		if (!sRule.empty() && sRule.back() == u8'/')
+		{
+			oRule.bDirOnly = true;
+			sRule.remove_suffix(1);
+		}
+
+		oRule.bAnchored = sRule.find(u8'/') != std::u8string_view::npos;
+		if (oRule.bAnchored && sRule.front() == u8'/')
+			sRule.remove_prefix(1);
+		if (sRule.empty())
+			return false;
+
+		if (m_bCaseSensitive)
+		{
+			oRule.sPattern = sRule;
+			oRule.sBase    = NormalizeBase(sBase);
+		}
+		else
+		{
+			oRule.sPattern = Unicode::FoldCase(sRule);
+			oRule.sBase    = Unicode::FoldCase(NormalizeBase(sBase));
+		}
+
+		if (!HasWildcards(oRule.sPattern))
+			oRule.eKind = RuleKind::Name;
+		else if (!oRule.bAnchored && oRule.sPattern.front() == u8'*' &&
+			!HasWildcards(std::u8string_view(oRule.sPattern).substr(1)))
+		{
+			oRule.eKind = RuleKind::Suffix;
+			oRule.sPattern.erase(0, 1);
+		}
+		else
+			oRule.eKind = RuleKind::Glob;
+
+		m_oRules.push_back(std::move(oRule));
+		return true;
+	}
+
+	size_t ExclusionRules::AddRules(std::u8string_view sText, std::u8string_view sBase)
+	{
+		if (sText.starts_with(u8"\uFEFF"))
+			sText.remove_prefix(3);
+
+		size_t iCount = 0;
+		while (!sText.empty())
+		{
+			const size_t iEnd = std::min(sText.find(u8'\n'), sText.length());
+			if (AddRule(sText.substr(0, iEnd), sBase))
+				++iCount;
+			sText.remove_prefix(std::min(iEnd + 1, sText.length()));
+		}
+
+		return iCount;
+	}
+
+	bool ExclusionRules::AddFile(const char8_t *szFilePath, std::u8string_view sBase)
+	{
+		std::u8string sText;
+		const bool bRead = File::Read(szFilePath, [&](const void *pData, size_t iSize)
+		{
+			sText.append(static_cast<const char8_t *>(pData), iSize);
+			return true;
+		});
+		if (!bRead)
+			return false;
+
+		AddRules(sText, sBase);
+		return true;
+	}
+
+	ExclusionRules::Result ExclusionRules::Check(std::u8string_view sPath, bool bDirectory) const
+	{
+		if (m_oRules.empty())
+			return Result::None;
+
+#ifdef _WIN32
+		Unicode::InlineString<char8_t> oSlashes;
+		if (sPath.find(u8'\\') != std::u8string_view::npos)
+		{
+			char8_t *p = oSlashes.reserve(sPath.length());
+			std::replace_copy(sPath.begin(), sPath.end(), p, u8'\\', u8'/');
+			oSlashes.setLength(sPath.length());
+			sPath = oSlashes.view();
+		}
+#endif
+
+		Unicode::InlineString<char8_t> oFolded;
+		if (!m_bCaseSensitive)
+		{
+			Unicode::FoldCase(sPath, oFolded);
+			sPath = oFolded.view();
+		}
+
+		while (!sPath.empty() && sPath.back() == u8'/')
+			sPath.remove_suffix(1);
+
+		const size_t iNamePos = sPath.rfind(u8'/');
+		const auto sName =
+			iNamePos == std::u8string_view::npos ? sPath : sPath.substr(iNamePos + 1);
+
+		// the last matching rule decides.
+		for (auto it = m_oRules.rbegin(); it != m_oRules.rend(); ++it)
+		{
+			const Rule &oRule = *it;
+			if ((oRule.bDirOnly && !bDirectory) || !sPath.starts_with(oRule.sBase))
+				continue;
+
+			const auto sSubject = oRule.bAnchored ? sPath.substr(oRule.sBase.length()) : sName;
+
+			bool bMatch = false;
+			switch (oRule.eKind)
+			{
+			case RuleKind::Name:
+				bMatch = sSubject == oRule.sPattern;
+				break;
+
+			case RuleKind::Suffix:
+				bMatch = sSubject.ends_with(oRule.sPattern);
+				break;
+
+			case RuleKind::Glob:
+				bMatch = MatchGlob(oRule.sPattern, sSubject);
+				break;
+			}
+
+			if (bMatch)
+				return oRule.bNegated ? Result::Included : Result::Excluded;
+		}
+
+		return Result::None;
+	}
+
+}
\ No newline at end of file
@@ -1,8 +1,16 @@
 #include <rlSystem/FileSystem.hpp>
 
+#include <rlSystem/TempFile.hpp>
+#include <rlSystem/UnicodeCaseFolding.hpp>
+
+#include "include/CopyEngine.hpp"
+
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <iterator>
+#include <memory>
+#include <optional>
 #include <regex>
 
 #ifdef _WIN32
@@ -10,6 +18,12 @@
 #include <rlSystem/WindowsUnicodeString.hpp>
 
 #include <ShlObj_core.h>
+#else
+#include "include/CaseFoldCache.hpp"
+
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
 #endif
 
 using namespace std::string_literals;
@@ -20,7 +34,9 @@ namespace fs = std::filesystem;
 namespace rlSystem
 {
 
+#ifdef _WIN32
 	namespace str = rlSystem::String;
+#endif
 
 
 
@@ -42,15 +58,15 @@ namespace rlSystem
 			return !Exists(szFilePath);
 		}
 
-		bool Move(const char8_t *szOrigFilePath, const char8_t *szNewFilePath)
+		bool Move(const char8_t *szOrigFilePath, const char8_t *szNewFilePath,
+			const CopyOptions &oOptions)
 		{
 			if (!Exists(szOrigFilePath))
 				return false;
 
 			try
 			{
-				fs::rename(szOrigFilePath, szNewFilePath);
-				return true;
+				return Internal::MoveItem(szOrigFilePath, szNewFilePath, oOptions);
 			}
 			catch (...)
 			{
@@ -58,15 +74,15 @@ namespace rlSystem
 			}
 		}
 
-		bool Copy(const char8_t *szOrigFilePath, const char8_t *szCopyFilePath)
+		bool Copy(const char8_t *szOrigFilePath, const char8_t *szCopyFilePath,
+			const CopyOptions &oOptions)
 		{
 			if (!Exists(szOrigFilePath))
 				return false;
 
 			try
 			{
-				fs::copy(szOrigFilePath, szCopyFilePath);
-				return true;
+				return Internal::CopyFileWithMetadata(szOrigFilePath, szCopyFilePath, oOptions);
 			}
 			catch (...)
 			{
@@ -76,9 +92,12 @@ namespace rlSystem
 
 		size_t GetSize(const char8_t *szFilePath)
 		{
+#ifdef _WIN32
+			str::OSBuffer oPath;
+#endif
 			std::ifstream file(
 #ifdef _WIN32
-				str::ToOS(szFilePath).c_str(),
+				str::ToOS(szFilePath, oPath),
 #else
 				reinterpret_cast<const char *>(szFilePath),
 #endif
@@ -90,14 +109,94 @@ namespace rlSystem
 				return 0;
 		}
 
+		bool Read(const char8_t *szFilePath,
+			const std::function<bool(const void *pData, size_t iSize)> &fnConsumer,
+			bool bNoCache)
+		{
+			constexpr size_t iBlockSize = 1024 * 1024;
+
+#ifdef _WIN32
+			// Unbuffered I/O requires sector-aligned buffers; VirtualAlloc returns whole pages.
+			str::OSBuffer oPath;
+			const HANDLE hFile = CreateFileW(str::ToOS(szFilePath, oPath), GENERIC_READ,
+				FILE_SHARE_READ, NULL, OPEN_EXISTING,
+				FILE_FLAG_SEQUENTIAL_SCAN | (bNoCache ? FILE_FLAG_NO_BUFFERING : 0), NULL);
+			if (hFile == INVALID_HANDLE_VALUE)
+				return false;
+
+			void *pBuf = VirtualAlloc(NULL, iBlockSize, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+			bool bResult = pBuf != nullptr;
+			while (bResult)
+			{
+				DWORD dwRead = 0;
+				if (!ReadFile(hFile, pBuf, (DWORD)iBlockSize, &dwRead, NULL))
+					bResult = false;
+				else if (dwRead == 0)
+					break;
+				else if (!fnConsumer(pBuf, dwRead))
+					bResult = false;
+			}
+
+			if (pBuf)
+				VirtualFree(pBuf, 0, MEM_RELEASE);
+			CloseHandle(hFile);
+			return bResult;
+#else
+			const int iFD = open(reinterpret_cast<const char *>(szFilePath), O_RDONLY | O_CLOEXEC);
+			if (iFD < 0)
+				return false;
+
+			posix_fadvise(iFD, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+			bool bResult = true;
+			{
+				std::optional<Internal::CacheDropper> oDropper;
+				if (bNoCache)
+					oDropper.emplace(iFD, -1, 0);
+
+				auto up_buf = std::make_unique<char[]>(iBlockSize);
+				off_t iOffset = 0;
+				while (true)
+				{
+					const ssize_t iRead = read(iFD, up_buf.get(), iBlockSize);
+					if (iRead == 0)
+						break;
+					if (iRead < 0)
+					{
+						if (errno == EINTR)
+							continue;
+						bResult = false;
+						break;
+					}
+
+					iOffset += iRead;
+					if (oDropper)
+						oDropper->Advance(iOffset);
+
+					if (!fnConsumer(up_buf.get(), (size_t)iRead))
+					{
+						bResult = false;
+						break;
+					}
+				}
+			}
+
+			close(iFD);
+			return bResult;
+#endif
+		}
+
 		bool IsReadonly(const char8_t *szFilePath)
 		{
 			if (!Exists(szFilePath))
 				return false;
 
+#ifdef _WIN32
+			str::OSBuffer oPath;
+#endif
 			std::ofstream file(
 #ifdef _WIN32
-				str::ToOS(szFilePath).c_str(),
+				str::ToOS(szFilePath, oPath),
 #else
 				reinterpret_cast<const char *>(szFilePath),
 #endif
@@ -133,15 +232,15 @@ namespace rlSystem
 			return !Exists(szDirPath);
 		}
 
-		bool Move(const char8_t *szOrigDirPath, const char8_t *szNewDirPath)
+		bool Move(const char8_t *szOrigDirPath, const char8_t *szNewDirPath,
+			const CopyOptions &oOptions)
 		{
 			if (!Exists(szOrigDirPath))
 				return false;
 
 			try
 			{
-				fs::rename(szOrigDirPath, szNewDirPath);
-				return true;
+				return Internal::MoveItem(szOrigDirPath, szNewDirPath, oOptions);
 			}
 			catch (...)
 			{
@@ -165,53 +264,251 @@ namespace rlSystem
 			}
 		}
 
-		std::vector<std::u8string> GetFiles(
-			const char8_t *szDirPath,
-			const char8_t *szRegexFilename,
-			      bool     bRegexCaseSensitive,
-				  bool     bRecursive
-		)
+		bool CopyTree(const char8_t *szOrigDirPath, const char8_t *szCopyDirPath,
+			const CopyOptions &oOptions)
 		{
-			const auto dirpath = fs::path(szDirPath);
-			const std::regex_constants::syntax_option_type flags =
-				bRegexCaseSensitive
-				? std::regex_constants::ECMAScript
-				: std::regex_constants::icase;
+			if (!Exists(szOrigDirPath))
+				return false;
 
-			std::regex pattern;
-			if (szRegexFilename && *szRegexFilename)
-				pattern = std::regex(reinterpret_cast<const char *>(szRegexFilename), flags);
-			else
-				pattern = std::regex(".*", flags);
+			try
+			{
+				return Internal::CopyTree(szOrigDirPath, szCopyDirPath, oOptions, false);
+			}
+			catch (...)
+			{
+				return false;
+			}
+		}
 
-			std::vector<std::u8string> oResult;
+		namespace
+		{
 
+			/// <summary>
+			/// Matches names against the regular expression of <c>GetFiles</c>/<c>GetDirectories</c>.
+			/// <para/>
+			/// Expressions that are a literal name, optionally preceded and/or followed by
+			/// <c>.*</c> (e.g. <c>.*\.txt</c>), are matched without <c>std::regex</c>.<para/>
+			/// If they're case-insensitive, the casefolded name is compared to the casefolded
+			/// literal; other expressions are casefolded outside of bracket expressions and escape
+			/// sequences and matched against the casefolded name.
+			/// </summary>
+			class NameFilter final
+			{
+			public: // methods
 
+				NameFilter(const char8_t *szRegex, bool bCaseSensitive) :
+					m_bCaseSensitive(bCaseSensitive)
+				{
+					std::u8string_view sRegex = szRegex ? szRegex : u8"";
+					if (sRegex.empty())
+						sRegex = u8".*";
+
+					std::u8string_view sLiteral = sRegex;
+					m_bAnyBefore = sLiteral.starts_with(u8".*");
+					if (m_bAnyBefore)
+						sLiteral.remove_prefix(2);
+					m_bAnyAfter = sLiteral.ends_with(u8".*");
+					if (m_bAnyAfter)
+						sLiteral.remove_suffix(2);
+
+					// "a\.*" (any number of periods) isn't a literal: ParseLiteral rejects "a\".
+					if (ParseLiteral(sLiteral, m_sLiteral))
+					{
+						m_bUseRegex = false;
+						if (!bCaseSensitive)
+							m_sLiteral = Unicode::FoldCase(m_sLiteral);
+					}
+					else if (bCaseSensitive)
+						m_oRegex = std::regex(reinterpret_cast<const char *>(szRegex));
+					else
+					{
+						// icase for the bracket expressions and escape sequences, which only
+						// support ASCII letters anyway.
+						const auto sFolded = FoldRegex(szRegex);
+						m_oRegex = std::regex(reinterpret_cast<const char *>(sFolded.c_str()),
+							std::regex_constants::icase);
+					}
+				}
+
+				bool matches(std::u8string_view sName) const
+				{
+					Unicode::InlineString<char8_t> oFolded;
+					if (!m_bCaseSensitive)
+					{
+						Unicode::FoldCase(sName, oFolded);
+						sName = oFolded.view();
+					}
+
+					if (m_bUseRegex)
+						return std::regex_match(
+							reinterpret_cast<const char *>(sName.data()),
+							reinterpret_cast<const char *>(sName.data() + sName.length()),
+							m_oRegex);
+
+					size_t iPos;
+					if (m_bAnyBefore && m_bAnyAfter)
+						iPos = sName.find(m_sLiteral);
+					else if (m_bAnyBefore)
+						iPos = sName.ends_with(m_sLiteral)
+							? sName.length() - m_sLiteral.length() : std::u8string_view::npos;
+					else if (m_bAnyAfter)
+						iPos = sName.starts_with(m_sLiteral) ? 0 : std::u8string_view::npos;
+					else
+						iPos = sName == m_sLiteral ? 0 : std::u8string_view::npos;
+
+					if (iPos == std::u8string_view::npos)
+						return false;
+
+					// "." doesn't match line breaks.
+					constexpr std::u8string_view sLineBreaks = u8"\r\n";
+					if (m_bAnyBefore && sName.substr(0, iPos).find_first_of(sLineBreaks) !=
+						std::u8string_view::npos)
+						return false;
+					if (m_bAnyAfter && sName.substr(iPos + m_sLiteral.length())
+						.find_first_of(sLineBreaks) != std::u8string_view::npos)
+						return false;
+
+					return true;
+				}
+
+
+			private: // static methods
+
+				/// <summary>
+				/// Get the literal text of a regular expression that has no special characters
+				/// (except escaped punctuation).
+				/// </summary>
+				static bool ParseLiteral(std::u8string_view sRegex, std::u8string &sLiteral)
+				{
+					constexpr std::u8string_view sSpecial = u8"^$\\.*+?()[]{}|";
+
+					sLiteral.clear();
+					for (size_t i = 0; i < sRegex.length(); ++i)
+					{
+						char8_t c = sRegex[i];
+						if (c == u8'\\')
+						{
+							if (++i == sRegex.length())
+								return false;
+
+							c = sRegex[i];
+							if (sSpecial.find(c) == std::u8string_view::npos && c != u8'/' &&
+								c != u8'-' && c != u8',')
+								return false; // a character class, a back reference etc.
+						}
+						else if (sSpecial.find(c) != std::u8string_view::npos)
+							return false;
+
+						sLiteral += c;
+					}
+
+					return true;
+				}
+
+				/// <summary>
+				/// Casefold the literal characters of a regular expression, i.e. everything except
+				/// bracket expressions and escape sequences (<c>\W</c> isn't <c>\w</c>).
+				/// </summary>
+				static std::u8string FoldRegex(std::u8string_view sRegex)
+				{
+					std::u8string sResult;
+					size_t iLiteral = 0; // start of the literal characters that weren't added yet
+					size_t i        = 0;
+					while (i < sRegex.length())
+					{
+						if (sRegex[i] != u8'\\' && sRegex[i] != u8'[')
+						{
+							++i;
+							continue;
+						}
+
+						sResult += Unicode::FoldCase(sRegex.substr(iLiteral, i - iLiteral));
+
+						// the escape sequence/bracket expression is added as it is.
+						size_t iEnd = i + 1;
+						if (sRegex[i] == u8'[')
+						{
+							while (iEnd < sRegex.length() && sRegex[iEnd] != u8']')
+							{
+								iEnd += sRegex[iEnd] == u8'\\' ? 2 : 1;
+							}
+							++iEnd;
+						}
+						else
+						{
+							++iEnd;
+							while (iEnd < sRegex.length() && (sRegex[iEnd] & 0xC0) == 0x80)
+							{
+								++iEnd; // a multibyte character
+							}
+						}
+						iEnd = std::min(iEnd, sRegex.length());
+
+						sResult += sRegex.substr(i, iEnd - i);
+						i = iLiteral = iEnd;
+					}
+					sResult += Unicode::FoldCase(sRegex.substr(iLiteral));
 
-			for (const auto &item : fs::directory_iterator(dirpath))
+					return sResult;
+				}
+
+
+			private: // variables
+
+				bool          m_bCaseSensitive;
+				bool          m_bUseRegex  = true;
+				bool          m_bAnyBefore = false; // a leading ".*"
+				bool          m_bAnyAfter  = false; // a trailing ".*"
+				std::u8string m_sLiteral;
+				std::regex    m_oRegex;
+
+			};
+
+			void CollectFiles(const fs::path &dirpath, const NameFilter &oFilter, bool bRecursive,
+				std::vector<std::u8string> &oResult)
 			{
-				if (item.is_directory())
+				for (const auto &item : fs::directory_iterator(dirpath))
 				{
-					if (bRecursive)
+					if (item.is_directory())
 					{
-						auto oResultSubdir =
-							GetFiles(item.path().u8string().c_str(), szRegexFilename,
-								bRegexCaseSensitive, true);
-						std::move(oResultSubdir.begin(), oResultSubdir.end(),
-							std::back_inserter(oResult));
+						if (bRecursive)
+							CollectFiles(item.path(), oFilter, true, oResult);
 					}
+					else if (oFilter.matches(item.path().filename().u8string()))
+						oResult.push_back(fs::absolute(item.path()).u8string());
 				}
-				else
+			}
+
+			void CollectDirectories(const fs::path &dirpath, const NameFilter &oFilter,
+				bool bRecursive, std::vector<std::u8string> &oResult)
+			{
+				for (const auto &item : fs::directory_iterator(dirpath))
 				{
-					const auto sFilename = item.path().filename().u8string();
+					if (!item.is_directory())
+						continue;
 
-					if (std::regex_match(
-						reinterpret_cast<const char *>(sFilename.c_str()), pattern))
+					if (oFilter.matches(item.path().filename().u8string()))
 						oResult.push_back(fs::absolute(item.path()).u8string());
 
+					if (bRecursive)
+						CollectDirectories(item.path(), oFilter, true, oResult);
 				}
 			}
 
+		}
+
+		std::vector<std::u8string> GetFiles(
+			const char8_t *szDirPath,
+			const char8_t *szRegexFilename,
+			      bool     bRegexCaseSensitive,
+			      bool     bRecursive
+		)
+		{
+			// the expression is only compiled once for all subdirectories.
+			const NameFilter oFilter(szRegexFilename, bRegexCaseSensitive);
+
+			std::vector<std::u8string> oResult;
+			CollectFiles(fs::path(szDirPath), oFilter, bRecursive, oResult);
 			return oResult;
 		}
 
@@ -219,45 +516,79 @@ namespace rlSystem
 			const char8_t *szDirPath,
 			const char8_t *szRegexDirname,
 			      bool     bRegexCaseSensitive,
-				  bool     bRecursive
+			      bool     bRecursive
 		)
 		{
-			const auto dirpath = fs::path(szDirPath);
-			const std::regex_constants::syntax_option_type flags =
-				bRegexCaseSensitive
-				? std::regex_constants::ECMAScript
-				: std::regex_constants::icase;
-
-			std::regex pattern;
-			if (szRegexDirname && *szRegexDirname)
-				pattern = std::regex(reinterpret_cast<const char *>(szRegexDirname), flags);
-			else
-				pattern = std::regex(".*", flags);
+			const NameFilter oFilter(szRegexDirname, bRegexCaseSensitive);
 
 			std::vector<std::u8string> oResult;
+			CollectDirectories(fs::path(szDirPath), oFilter, bRecursive, oResult);
+			return oResult;
+		}
 
+		namespace
+		{
 
-
-			for (const auto &item : fs::directory_iterator(dirpath))
+			std::vector<PatternMatch> GetByPattern(
+				const char8_t    *szDirPath,
+				const PatternSet &oPatterns,
+				      bool        bRecursive,
+				      bool        bDirectories
+			)
 			{
-				if (item.is_directory())
+				std::vector<PatternMatch> oResult;
+
+				std::error_code ec;
+				std::vector<fs::path> oPending = { fs::absolute(szDirPath, ec) };
+				if (ec)
+					return oResult;
+
+				while (!oPending.empty())
 				{
-					const auto sDirname = item.path().filename().u8string();
+					const auto dirpath = std::move(oPending.back());
+					oPending.pop_back();
 
-					if (std::regex_match(reinterpret_cast<const char *>(sDirname.c_str()), pattern))
-						oResult.push_back(fs::absolute(item.path()).u8string());
+					for (fs::directory_iterator it(dirpath, ec), itEnd; !ec && it != itEnd;
+						it.increment(ec))
+					{
+						const bool bIsDir = it->is_directory(ec);
 
-if (bRecursive)
-{
-	auto oResultSubdir =
-		GetDirectories(item.path().u8string().c_str(), szRegexDirname, bRegexCaseSensitive, true);
-	std::move(oResultSubdir.begin(), oResultSubdir.end(),
-		std::back_inserter(oResult));
-}
+						if (bIsDir == bDirectories)
+						{
+							const auto sName = it->path().filename().u8string();
+
+							const size_t iPattern = oPatterns.Match(sName);
+							if (iPattern != PatternSet::NoMatch)
+								oResult.push_back({ it->path().u8string(), iPattern });
+						}
+
+						if (bIsDir && bRecursive)
+							oPending.push_back(it->path());
+					}
+					ec.clear();
 				}
+
+				return oResult;
 			}
 
-			return oResult;
+		}
+
+		std::vector<PatternMatch> GetFiles(
+			const char8_t    *szDirPath,
+			const PatternSet &oPatterns,
+			      bool        bRecursive
+		)
+		{
+			return GetByPattern(szDirPath, oPatterns, bRecursive, false);
+		}
+
+		std::vector<PatternMatch> GetDirectories(
+			const char8_t    *szDirPath,
+			const PatternSet &oPatterns,
+			      bool        bRecursive
+		)
+		{
+			return GetByPattern(szDirPath, oPatterns, bRecursive, true);
 		}
 
 		bool IsReadonly(const char8_t *szDirPath)
@@ -265,42 +596,9 @@ if (bRecursive)
 			if (!Exists(szDirPath))
 				return false;
 
-			const auto sBasePath = Path::IncludeTrailingDelim(szDirPath) + u8"testfile_";
-
-			std::u8string sTestfilePath;
-			sTestfilePath.reserve(sBasePath.length() + sizeof(unsigned) * 2);
-
-			srand((unsigned)time(NULL));
-			do
-			{
-				unsigned iRand = (unsigned)rand();
-
-				sTestfilePath = sBasePath;
-
-				constexpr char8_t cHex[] = u8"0123456789ABCDEF";
-
-				for (int i = 0; i < 8; ++i)
-				{
-					sTestfilePath += cHex[iRand & 0xF];
-					iRand >>= 4;
-				}
-			} while (Path::Exists(sTestfilePath.c_str()));
-			
-			
-#ifdef _WIN32
-			std::ofstream file(str::ToOS(sTestfilePath.c_str()).c_str());
-#else
-			std::ofstream file(reinterpret_cast<const char *>(sTestfilePath.c_str()));
-#endif
-
-			bool bResult = !file;
-			if (file)
-			{
-				file.close();
-				File::Delete(sTestfilePath.c_str());
-			}
-
-			return bResult;
+			// the directory is writable if a file can be created in it.
+			const TempFile oProbe(szDirPath);
+			return !oProbe.valid();
 		}
 
 	}
@@ -338,15 +636,15 @@ if (bRecursive)
 			return !Exists(szPath);
 		}
 
-		bool Move(const char8_t *szOrigPath, const char8_t *szNewPath)
+		bool Move(const char8_t *szOrigPath, const char8_t *szNewPath,
+			const CopyOptions &oOptions)
 		{
 			if (!Exists(szOrigPath))
 				return false;
 
 			try
 			{
-				fs::rename(szOrigPath, szNewPath);
-				return true;
+				return Internal::MoveItem(szOrigPath, szNewPath, oOptions);
 			}
 			catch (...)
 			{
@@ -374,7 +672,8 @@ if (bRecursive)
 		{
 #ifdef _WIN32 // Windows: file attribute
 
-			const DWORD dwAttribs = GetFileAttributesW(str::ToOS(szPath).c_str());
+			str::OSBuffer oPath;
+			const DWORD dwAttribs = GetFileAttributesW(str::ToOS(szPath, oPath));
 			if (dwAttribs == INVALID_FILE_ATTRIBUTES)
 				return false;
 
@@ -390,9 +689,10 @@ if (bRecursive)
 		bool SetHidden(const char8_t *szPath, bool bHidden)
 		{
 #ifdef _WIN32 // Windows: set file attribute
-			const auto sPath = str::ToOS(szPath);
+			str::OSBuffer oPath;
+			const wchar_t *szPathOS = str::ToOS(szPath, oPath);
 
-			DWORD dwAttribs = GetFileAttributesW(sPath.c_str());
+			DWORD dwAttribs = GetFileAttributesW(szPathOS);
 			if (dwAttribs == INVALID_FILE_ATTRIBUTES)
 				return false;
 
@@ -401,7 +701,7 @@ if (bRecursive)
 			else
 				dwAttribs &= ~FILE_ATTRIBUTE_HIDDEN;
 
-			return SetFileAttributesW(sPath.c_str(), dwAttribs);
+			return SetFileAttributesW(szPathOS, dwAttribs);
 #elif defined(__linux__) // Linux: not possible, as file would have to be renamed to start with "."
 			return false;
 #else
@@ -415,7 +715,8 @@ if (bRecursive)
 
 		std::u8string Absolute(const char8_t *szPathRelative)
 		{
-			return fs::absolute(szPathRelative).u8string();
+			// On Windows, fs::absolute already resolves "." and ".."; elsewhere it doesn't.
+			return fs::absolute(szPathRelative).lexically_normal().u8string();
 		}
 
 		std::u8string GetParent(const char8_t *szPath)
@@ -429,7 +730,7 @@ if (bRecursive)
 				sPath.erase(sPath.length() - 1);
 
 			if (Exists(sPath.c_str()))
-				sPath = Absolute(sPath.c_str());
+				sPath = ExcludeTrailingDelim(Absolute(sPath.c_str()).c_str());
 
 			const auto path = fs::path(sPath);
 
@@ -507,12 +808,43 @@ if (bRecursive)
 
 		std::u8string GetCased(const char8_t *szPath)
 		{
-			if (!Exists(szPath))
+#ifndef _WIN32 // case-sensitive file system: look up every item case-insensitively
+			const auto sAbsPath = Absolute(szPath);
+			if (sAbsPath.empty() || sAbsPath[0] != Delimiter)
 				return {};
 
-#ifndef _WIN32 // Windows is the only case-insensitive OS
-			return sAbsPath;
+			auto &oCache = Internal::CaseFoldCache::Instance();
+
+			std::u8string sResult;
+			sResult.reserve(sAbsPath.length());
+			sResult += Delimiter;
+
+			std::u8string sItemName;
+			size_t iPos = 1;
+			while (iPos < sAbsPath.length())
+			{
+				size_t iEnd = sAbsPath.find(Delimiter, iPos);
+				if (iEnd == std::u8string::npos)
+					iEnd = sAbsPath.length();
+
+				if (iEnd > iPos)
+				{
+					if (!sResult.ends_with(Delimiter))
+						sResult += Delimiter;
+
+					const std::u8string_view sItem(sAbsPath.data() + iPos, iEnd - iPos);
+					if (!oCache.Resolve(sResult, sItem, sItemName))
+						return {};
+					sResult += sItemName;
+				}
+
+				iPos = iEnd + 1;
+			}
+
+			return sResult;
 #else
+			if (!Exists(szPath))
+				return {};
 
 			std::u8string sResult;
 			sResult.reserve(strlen(reinterpret_cast<const char *>(szPath)));
@@ -533,6 +865,11 @@ if (bRecursive)
 				sz      += 3;
 			}
 
+			// reused for every item, so short paths need no allocations.
+			std::u8string sItemPath;
+			str::OSBuffer oItemPath;
+			Unicode::InlineString<char8_t, 3 * MAX_PATH> oDisplayName;
+
 			while (*sz)
 			{
 				// skip additional slashes
@@ -549,24 +886,22 @@ if (bRecursive)
 						break;
 					++len;
 				}
-				auto up_szItemName = std::make_unique<char8_t[]>(len + 1);
-				for (size_t i = 0; i < len; ++i)
-				{
-					up_szItemName[i] = sz[i];
-				}
-				up_szItemName[len] = 0; // terminating zero
+				const std::u8string_view sItemName(sz, len);
 
 				sz += len;
 
-				if (u8"."s == up_szItemName.get() || u8".."s == up_szItemName.get())
-					sResult += up_szItemName.get();
+				if (sItemName == u8"." || sItemName == u8"..")
+					sResult += sItemName;
 				else
 				{
+					sItemPath.assign(sResult).append(sItemName);
+
 					SHFILEINFOW sfi{};
-					if (!SHGetFileInfoW(str::ToOS((sResult + up_szItemName.get()).c_str()).c_str(), 0,
+					if (!SHGetFileInfoW(str::ToOS(sItemPath.c_str(), oItemPath), 0,
 						&sfi, sizeof(sfi), SHGFI_DISPLAYNAME))
 						return {};
-					sResult += str::FromOS(sfi.szDisplayName);
+					sResult += Unicode::ToUTF8(
+						reinterpret_cast<const char16_t *>(sfi.szDisplayName), oDisplayName);
 				}
 				
 
@@ -576,20 +911,28 @@ if (bRecursive)
 
 			return sResult;
 
+#endif
+		}
+
+		void ClearCasingCache()
+		{
+#ifndef _WIN32
+			Internal::CaseFoldCache::Instance().Clear();
 #endif
 		}
 
 #ifdef _WIN32
 		std::u8string Expand(const char8_t *szPath)
 		{
-			const auto sPath = str::ToOS(szPath);
+			str::OSBuffer oPath;
+			const wchar_t *szPathOS = str::ToOS(szPath, oPath);
 
-			const DWORD dwSize = ExpandEnvironmentStringsW(sPath.c_str(), NULL, 0);
+			const DWORD dwSize = ExpandEnvironmentStringsW(szPathOS, NULL, 0);
 			if (dwSize <= 1)
 				return {};
 
 			str::OSString sResult(dwSize - 1, 0);
-			ExpandEnvironmentStringsW(sPath.c_str(), sResult.data(), dwSize);
+			ExpandEnvironmentStringsW(szPathOS, sResult.data(), dwSize);
 
 			return str::FromOS(sResult.c_str());
 		}
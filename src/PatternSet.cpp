@@ -0,0 +1,358 @@
+#include <rlSystem/PatternSet.hpp>
+
+#include <rlSystem/UnicodeCaseFolding.hpp>
+
+#include <algorithm>
+#include <bitset>
+
+
+
+namespace rlSystem
+{
+
+	namespace
+	{
+
+		constexpr size_t iWordBits = 64;
+
+		bool IsContinuationByte(unsigned c) { return (c & 0xC0) == 0x80; }
+
+		char8_t FoldASCII(char8_t c)
+		{
+			if (c >= u8'A' && c <= u8'Z')
+				return c + (u8'a' - u8'A');
+			return c;
+		}
+
+		enum class TokenType
+		{
+			Literal,
+			Any,
+			Class,
+			Star
+		};
+
+		struct Token
+		{
+			TokenType        eType;
+			std::bitset<256> oBytes;           // for Literal and Class: the accepted bytes
+			bool             bNegated = false; // for Class
+		};
+
+		/// <summary>Split a glob into tokens. Consecutive stars are merged.</summary>
+		std::vector<Token> Tokenize(std::u8string_view sGlob, bool bCaseSensitive)
+		{
+			std::vector<Token> oTokens;
+
+			for (size_t i = 0; i < sGlob.length(); ++i)
+			{
+				const char8_t c = sGlob[i];
+
+				switch (c)
+				{
+				case u8'*':
+					if (oTokens.empty() || oTokens.back().eType != TokenType::Star)
+						oTokens.push_back({ TokenType::Star });
+					continue;
+
+				case u8'?':
+					oTokens.push_back({ TokenType::Any });
+					continue;
+
+				case u8'[':
+				{
+					// find the closing bracket; a "]" right after "[" or "[!" is a member.
+					size_t iEnd = i + 1;
+					if (iEnd < sGlob.length() && sGlob[iEnd] == u8'!')
+						++iEnd;
+					if (iEnd < sGlob.length() && sGlob[iEnd] == u8']')
+						++iEnd;
+					while (iEnd < sGlob.length() && sGlob[iEnd] != u8']')
+						++iEnd;
+
+					if (iEnd >= sGlob.length())
+						break; // no closing bracket --> literal "["
+
+					Token oToken{ TokenType::Class };
+					size_t iPos = i + 1;
+					if (sGlob[iPos] == u8'!')
+					{
+						oToken.bNegated = true;
+						++iPos;
+					}
+
+					for (; iPos < iEnd; ++iPos)
+					{
+						unsigned iFirst = sGlob[iPos];
+						unsigned iLast  = iFirst;
+						if (iPos + 2 < iEnd && sGlob[iPos + 1] == u8'-')
+						{
+							iLast = sGlob[iPos + 2];
+							iPos += 2;
+						}
+
+						for (unsigned iChar = iFirst; iChar <= iLast && iChar < 0x80; ++iChar)
+						{
+							oToken.oBytes.set(iChar);
+							if (!bCaseSensitive)
+								oToken.oBytes.set(FoldASCII((char8_t)iChar));
+						}
+					}
+
+					oTokens.push_back(oToken);
+					i = iEnd;
+					continue;
+				}
+				}
+
+				if (!bCaseSensitive && c >= 0x80)
+				{
+					// fold the whole character; the folded one might have a different length.
+					size_t iEnd = i + 1;
+					while (iEnd < sGlob.length() && IsContinuationByte(sGlob[iEnd]))
+						++iEnd;
+
+					for (const char8_t cFolded : Unicode::FoldCase(sGlob.substr(i, iEnd - i)))
+					{
+						Token oToken{ TokenType::Literal };
+						oToken.oBytes.set(cFolded);
+						oTokens.push_back(oToken);
+					}
+					i = iEnd - 1;
+					continue;
+				}
+
+				Token oToken{ TokenType::Literal };
+				oToken.oBytes.set(bCaseSensitive ? c : FoldASCII(c));
+				oTokens.push_back(oToken);
+			}
+
+			return oTokens;
+		}
+
+		void SetBit(std::vector<uint64_t> &oWords, size_t iBit)
+		{
+			oWords[iBit / iWordBits] |= uint64_t(1) << (iBit % iWordBits);
+		}
+
+		bool TestBit(const std::vector<uint64_t> &oWords, size_t iBit)
+		{
+			return oWords[iBit / iWordBits] & (uint64_t(1) << (iBit % iWordBits));
+		}
+
+	}
+
+
+
+	PatternSet::PatternSet(bool bCaseSensitive) : m_bCaseSensitive(bCaseSensitive) {}
+
+	size_t PatternSet::AddExtension(const char8_t *szExtension)
+	{
+		std::u8string_view sExt = szExtension;
+		if (sExt.starts_with(u8'.'))
+			sExt.remove_prefix(1);
+
+		const size_t iIndex = m_iCount++;
+		auto sKey = Normalize(sExt);
+		m_iMaxExtensionLen = std::max(m_iMaxExtensionLen, sKey.length());
+		m_oExtensions.try_emplace(std::move(sKey), iIndex);
+
+		return iIndex;
+	}
+
+	size_t PatternSet::AddName(const char8_t *szName)
+	{
+		const size_t iIndex = m_iCount++;
+		m_oNames.try_emplace(Normalize(szName), iIndex);
+
+		return iIndex;
+	}
+
+	size_t PatternSet::AddGlob(const char8_t *szGlob)
+	{
+		const size_t iIndex = m_iCount++;
+		const auto oTokens = Tokenize(szGlob, m_bCaseSensitive);
+
+		const size_t iBase = AddState();
+		SetBit(m_oInitial, iBase);
+
+		for (size_t i = 0; i < oTokens.size(); ++i)
+		{
+			const auto &oToken = oTokens[i];
+			const size_t iState = AddState(); // reached once token i matched
+
+			switch (oToken.eType)
+			{
+			case TokenType::Literal:
+				for (unsigned c = 0; c < 256; ++c)
+				{
+					if (oToken.oBytes.test(c))
+						SetBit(m_oShift[c], iState);
+				}
+				break;
+
+			case TokenType::Any:
+			case TokenType::Class:
+			{
+				// one character = one lead byte followed by any number of continuation bytes.
+				const bool bAny = oToken.eType == TokenType::Any;
+				for (unsigned c = 0; c < 256; ++c)
+				{
+					if (IsContinuationByte(c))
+					{
+						if (bAny || oToken.bNegated)
+							SetBit(m_oLoop[c], iState);
+					}
+					else if (bAny || oToken.oBytes.test(c) != oToken.bNegated)
+						SetBit(m_oShift[c], iState);
+				}
+				break;
+			}
+
+			case TokenType::Star:
+				SetBit(m_oEpsilon, iState - 1);
+				for (unsigned c = 0; c < 256; ++c)
+				{
+					SetBit(m_oLoop[c], iState);
+				}
+				break;
+			}
+		}
+
+		const size_t iAccept = iBase + oTokens.size();
+		SetBit(m_oAccept, iAccept);
+		m_oGlobs.push_back({ iIndex, iAccept });
+
+		// the epsilon closure of a leading star must already be part of the initial states.
+		if (!oTokens.empty() && oTokens[0].eType == TokenType::Star)
+			SetBit(m_oInitial, iBase + 1);
+
+		return iIndex;
+	}
+
+	size_t PatternSet::Match(std::u8string_view sName) const
+	{
+		Unicode::InlineString<char8_t> oFolded;
+		if (!m_bCaseSensitive)
+		{
+			Unicode::FoldCase(sName, oFolded);
+			sName = oFolded.view();
+		}
+
+		size_t iResult = NoMatch;
+
+		if (!m_oNames.empty())
+		{
+			if (const auto it = m_oNames.find(sName); it != m_oNames.end())
+				iResult = it->second;
+		}
+
+		if (!m_oExtensions.empty())
+		{
+			const size_t iMinPos =
+				sName.length() > m_iMaxExtensionLen ? sName.length() - m_iMaxExtensionLen - 1 : 0;
+
+			for (size_t iPos = sName.length(); iPos-- > iMinPos;)
+			{
+				if (sName[iPos] != u8'.')
+					continue;
+
+				if (const auto it = m_oExtensions.find(sName.substr(iPos + 1));
+					it != m_oExtensions.end())
+					iResult = std::min(iResult, it->second);
+			}
+		}
+
+		if (!m_oGlobs.empty() && (iResult == NoMatch || m_oGlobs.front().iPattern < iResult))
+			iResult = std::min(iResult, MatchGlobs(sName));
+
+		return iResult;
+	}
+
+	std::u8string PatternSet::Normalize(std::u8string_view s) const
+	{
+		if (!m_bCaseSensitive)
+			return Unicode::FoldCase(s);
+
+		return std::u8string(s);
+	}
+
+	size_t PatternSet::MatchGlobs(std::u8string_view sName) const
+	{
+		const size_t iWords = m_oInitial.size();
+
+		// reused between calls so that matching doesn't allocate.
+		thread_local std::vector<Word> oState;
+		thread_local std::vector<Word> oNext;
+		oState.assign(m_oInitial.begin(), m_oInitial.end());
+		oNext.resize(iWords);
+
+		for (const char8_t c : sName)
+		{
+			const auto &oShift = m_oShift[c];
+			const auto &oLoop  = m_oLoop[c];
+
+			Word iCarry = 0;
+			Word iAny   = 0;
+			for (size_t i = 0; i < iWords; ++i)
+			{
+				const Word iShifted = (oState[i] << 1) | iCarry;
+				iCarry = oState[i] >> (iWordBits - 1);
+
+				oNext[i] = (iShifted & oShift[i]) | (oState[i] & oLoop[i]);
+			}
+
+			// epsilon transitions (leave a star's predecessor without consuming a byte)
+			iCarry = 0;
+			for (size_t i = 0; i < iWords; ++i)
+			{
+				const Word iEps = oNext[i] & m_oEpsilon[i];
+				oNext[i] |= (iEps << 1) | iCarry;
+				iCarry = iEps >> (iWordBits - 1);
+
+				iAny |= oNext[i];
+			}
+
+			if (!iAny)
+				return NoMatch;
+
+			oState.swap(oNext);
+		}
+
+		Word iAccepted = 0;
+		for (size_t i = 0; i < iWords; ++i)
+		{
+			iAccepted |= oState[i] & m_oAccept[i];
+		}
+		if (!iAccepted)
+			return NoMatch;
+
+		for (const auto &oGlob : m_oGlobs)
+		{
+			if (TestBit(oState, oGlob.iAcceptBit))
+				return oGlob.iPattern; // globs are stored in ascending pattern order
+		}
+
+		return NoMatch;
+	}
+
+	size_t PatternSet::AddState()
+	{
+		const size_t iState = m_iStates++;
+
+		if (iState % iWordBits == 0)
+		{
+			m_oInitial.push_back(0);
+			m_oEpsilon.push_back(0);
+			m_oAccept.push_back(0);
+			for (size_t c = 0; c < 256; ++c)
+			{
+				m_oShift[c].push_back(0);
+				m_oLoop[c].push_back(0);
+			}
+		}
+
+		return iState;
+	}
+
+}
\ No newline at end of file
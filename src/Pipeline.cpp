@@ -0,0 +1,402 @@
+#include <rlSystem/Pipeline.hpp>
+
+#include "include/ProcessSpawn.hpp"
+
+#include <algorithm>
+#include <memory>
+
+#ifdef _WIN32
+#include <rlSystem/WindowsUnicodeString.hpp>
+#else
+#include <cerrno>
+
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+
+
+namespace rlSystem
+{
+
+	namespace
+	{
+
+#ifdef _WIN32
+
+		/// <summary>
+		/// Pass the output of the last stage to the file and/or the callback.
+		/// </summary>
+		void ConsumeOutput(HANDLE hPipe, HANDLE hFile,
+			const std::function<void(std::string_view)> &fnOutput)
+		{
+			auto up_buf = std::make_unique<char[]>(Internal::iReadBufferSize);
+			DWORD dwRead = 0;
+			while (ReadFile(hPipe, up_buf.get(), (DWORD)Internal::iReadBufferSize, &dwRead,
+				NULL) && dwRead > 0)
+			{
+				if (hFile != INVALID_HANDLE_VALUE)
+				{
+					DWORD dwWritten = 0;
+					WriteFile(hFile, up_buf.get(), dwRead, &dwWritten, NULL);
+				}
+				fnOutput(std::string_view(up_buf.get(), dwRead));
+			}
+		}
+
+#else
+
+		/// <summary>Write a buffer completely.</summary>
+		bool WriteAll(int iFD, const char *pData, size_t iSize)
+		{
+			while (iSize > 0)
+			{
+				const ssize_t iWritten = write(iFD, pData, iSize);
+				if (iWritten < 0)
+				{
+					if (errno == EINTR)
+						continue;
+					return false;
+				}
+				pData += iWritten;
+				iSize -= (size_t)iWritten;
+			}
+			return true;
+		}
+
+		/// <summary>Read until a buffer is full or the end of the data is reached.</summary>
+		/// <returns>The number of bytes read.</returns>
+		size_t ReadAll(int iFD, char *pData, size_t iSize)
+		{
+			size_t iTotal = 0;
+			while (iTotal < iSize)
+			{
+				const ssize_t iRead = read(iFD, pData + iTotal, iSize - iTotal);
+				if (iRead < 0 && errno == EINTR)
+					continue;
+				if (iRead <= 0)
+					break;
+				iTotal += (size_t)iRead;
+			}
+			return iTotal;
+		}
+
+		/// <summary>
+		/// Pass the output of the last stage to the file and/or the callback, until the pipe is
+		/// closed by the writing side.
+		/// </summary>
+		void ConsumeOutput(int iFDPipe, int iFDFile,
+			const std::function<void(std::string_view)> &fnOutput)
+		{
+			auto up_buf = std::make_unique<char[]>(Internal::iReadBufferSize);
+
+			// tee duplicates the pipe's pages into a second pipe without copying them; the
+			// original data is then moved to the file via splice. Only the duplicate is copied
+			// to user space for the callback.
+			int iTee[2] = { -1, -1 };
+			if (iFDFile >= 0 && pipe2(iTee, O_CLOEXEC) == 0)
+			{
+				fcntl(iTee[1], F_SETPIPE_SZ, (int)Internal::iPipeSize);
+
+				while (true)
+				{
+					const ssize_t iTeed = tee(iFDPipe, iTee[1], Internal::iReadBufferSize, 0);
+					if (iTeed < 0 && errno == EINTR)
+						continue;
+					if (iTeed <= 0)
+					{
+						// EINVAL: not supported (e.g. by the file system of the output file).
+						if (iTeed < 0 && errno == EINVAL)
+							break;
+						close(iTee[0]);
+						close(iTee[1]);
+						return;
+					}
+
+					size_t iLeft = (size_t)iTeed;
+					while (iLeft > 0)
+					{
+						const ssize_t iMoved = splice(iFDPipe, nullptr, iFDFile, nullptr, iLeft,
+							SPLICE_F_MOVE);
+						if (iMoved < 0 && errno == EINTR)
+							continue;
+						if (iMoved <= 0)
+							break;
+						iLeft -= (size_t)iMoved;
+					}
+
+					// the file can't be written: drop what wasn't moved, the callback still gets
+					// it from the duplicate.
+					const bool bFileFailed = iLeft > 0;
+					while (iLeft > 0)
+					{
+						const size_t iRead = ReadAll(iFDPipe, up_buf.get(),
+							std::min(iLeft, Internal::iReadBufferSize));
+						if (iRead == 0)
+							break;
+						iLeft -= iRead;
+					}
+
+					// the duplicate is always consumed completely, so the next tee doesn't block.
+					size_t iDuplicate = (size_t)iTeed;
+					while (iDuplicate > 0)
+					{
+						const size_t iRead = ReadAll(iTee[0], up_buf.get(),
+							std::min(iDuplicate, Internal::iReadBufferSize));
+						if (iRead == 0)
+							break;
+						fnOutput(std::string_view(up_buf.get(), iRead));
+						iDuplicate -= iRead;
+					}
+
+					if (bFileFailed)
+					{
+						iFDFile = -1;
+						break;
+					}
+				}
+
+				close(iTee[0]);
+				close(iTee[1]);
+			}
+
+			while (true)
+			{
+				const ssize_t iRead = read(iFDPipe, up_buf.get(), Internal::iReadBufferSize);
+				if (iRead < 0 && errno == EINTR)
+					continue;
+				if (iRead <= 0)
+					break;
+
+				if (iFDFile >= 0)
+					WriteAll(iFDFile, up_buf.get(), (size_t)iRead);
+				fnOutput(std::string_view(up_buf.get(), (size_t)iRead));
+			}
+		}
+
+#endif
+
+	}
+
+
+
+	bool RunPipeline(const std::vector<PipelineStage> &oStages, const PipelineOptions &oOptions,
+		std::vector<int> *pExitCodes)
+	{
+		if (pExitCodes)
+			pExitCodes->clear();
+		if (oStages.empty())
+			return false;
+
+		const bool bCallback = (bool)oOptions.fnOutput;
+		bool bOK = true;
+
+#ifdef _WIN32
+		// Handles are only made inheritable while the stage that needs them is started:
+		// CreateProcess passes all inheritable handles, and a pipe only reports its end when
+		// all of its writing handles are closed.
+		const auto fnStart = [](Internal::Command &oCommand, const std::u8string &sCurrentDir,
+			HANDLE hIn, HANDLE hOut, PROCESS_INFORMATION &pi)
+		{
+			STARTUPINFOW si{};
+			si.cb         = sizeof(STARTUPINFOW);
+			si.dwFlags    = STARTF_USESTDHANDLES;
+			si.hStdInput  = hIn  ? hIn  : GetStdHandle(STD_INPUT_HANDLE);
+			si.hStdOutput = hOut ? hOut : GetStdHandle(STD_OUTPUT_HANDLE);
+			si.hStdError  = GetStdHandle(STD_ERROR_HANDLE);
+
+			for (HANDLE h : { hIn, hOut })
+			{
+				if (h)
+					SetHandleInformation(h, HANDLE_FLAG_INHERIT, HANDLE_FLAG_INHERIT);
+			}
+			const bool bResult = Internal::StartProcess(oCommand,
+				sCurrentDir.empty() ? nullptr : sCurrentDir.c_str(), 0, si, pi);
+			for (HANDLE h : { hIn, hOut })
+			{
+				if (h)
+					SetHandleInformation(h, HANDLE_FLAG_INHERIT, 0);
+			}
+			return bResult;
+		};
+
+		HANDLE hIn   = NULL; // stdin of the next stage
+		HANDLE hFile = INVALID_HANDLE_VALUE;
+
+		if (!oOptions.sInputFile.empty())
+		{
+			hIn = CreateFileW(String::ToOS(oOptions.sInputFile.c_str()).c_str(), GENERIC_READ,
+				FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+			if (hIn == INVALID_HANDLE_VALUE)
+				return false;
+		}
+		if (!oOptions.sOutputFile.empty())
+		{
+			hFile = CreateFileW(String::ToOS(oOptions.sOutputFile.c_str()).c_str(),
+				GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+			if (hFile == INVALID_HANDLE_VALUE)
+			{
+				if (hIn)
+					CloseHandle(hIn);
+				return false;
+			}
+		}
+
+		std::vector<HANDLE> oProcesses;
+		oProcesses.reserve(oStages.size());
+
+		for (size_t i = 0; i < oStages.size(); ++i)
+		{
+			const bool bLast = i + 1 == oStages.size();
+
+			HANDLE hOut    = NULL;
+			HANDLE hNextIn = NULL;
+			if (!bLast || bCallback)
+			{
+				if (!CreatePipe(&hNextIn, &hOut, NULL, (DWORD)Internal::iPipeSize))
+				{
+					bOK = false;
+					break;
+				}
+			}
+			else if (hFile != INVALID_HANDLE_VALUE)
+				hOut = hFile;
+
+			const auto &oStage = oStages[i];
+			Internal::Command oCommand(oStage.sAppPath.c_str(), oStage.sArgs.c_str());
+			PROCESS_INFORMATION pi{};
+			const bool bStarted = fnStart(oCommand, oStage.sCurrentDir, hIn, hOut, pi);
+
+			if (hIn)
+				CloseHandle(hIn);
+			if (hOut && hOut != hFile)
+				CloseHandle(hOut);
+			hIn = hNextIn;
+
+			if (!bStarted)
+			{
+				bOK = false;
+				break;
+			}
+			CloseHandle(pi.hThread);
+			oProcesses.push_back(pi.hProcess);
+		}
+
+		if (bOK && bCallback)
+			ConsumeOutput(hIn, hFile, oOptions.fnOutput);
+		if (hIn)
+			CloseHandle(hIn);
+
+		for (HANDLE hProcess : oProcesses)
+		{
+			const int iExitCode = Internal::WaitForProcess(hProcess);
+			if (pExitCodes)
+				pExitCodes->push_back(iExitCode);
+			CloseHandle(hProcess);
+		}
+
+		if (hFile != INVALID_HANDLE_VALUE)
+			CloseHandle(hFile);
+
+#else
+		int iFDIn   = -1; // stdin of the next stage
+		int iFDFile = -1;
+
+		if (!oOptions.sInputFile.empty())
+		{
+			iFDIn = open(reinterpret_cast<const char *>(oOptions.sInputFile.c_str()),
+				O_RDONLY | O_CLOEXEC);
+			if (iFDIn < 0)
+				return false;
+		}
+		if (!oOptions.sOutputFile.empty())
+		{
+			iFDFile = open(reinterpret_cast<const char *>(oOptions.sOutputFile.c_str()),
+				O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+			if (iFDFile < 0)
+			{
+				if (iFDIn >= 0)
+					close(iFDIn);
+				return false;
+			}
+		}
+
+		std::vector<pid_t> oPIDs;
+		oPIDs.reserve(oStages.size());
+
+		for (size_t i = 0; i < oStages.size(); ++i)
+		{
+			const bool bLast = i + 1 == oStages.size();
+
+			// O_CLOEXEC: each stage only keeps the ends that are duplicated to its stdin/stdout.
+			int iFDOut    = -1;
+			int iFDNextIn = -1;
+			if (!bLast || bCallback)
+			{
+				int iPipe[2];
+				if (pipe2(iPipe, O_CLOEXEC) != 0)
+				{
+					bOK = false;
+					break;
+				}
+				fcntl(iPipe[1], F_SETPIPE_SZ, (int)Internal::iPipeSize);
+				iFDNextIn = iPipe[0];
+				iFDOut    = iPipe[1];
+			}
+			else
+				iFDOut = iFDFile;
+
+			posix_spawn_file_actions_t oActions;
+			posix_spawn_file_actions_init(&oActions);
+			bool bStarted = true;
+			if (iFDIn >= 0)
+				bStarted = posix_spawn_file_actions_adddup2(&oActions, iFDIn, STDIN_FILENO) == 0;
+			if (bStarted && iFDOut >= 0)
+				bStarted = posix_spawn_file_actions_adddup2(&oActions, iFDOut, STDOUT_FILENO) == 0;
+
+			const auto &oStage = oStages[i];
+			pid_t pid = 0;
+			if (bStarted)
+			{
+				const Internal::Command oCommand(oStage.sAppPath.c_str(), oStage.sArgs.c_str());
+				bStarted = Internal::SpawnChild(oCommand,
+					oStage.sCurrentDir.empty() ? nullptr : oStage.sCurrentDir.c_str(),
+					oActions, pid);
+			}
+			posix_spawn_file_actions_destroy(&oActions);
+
+			// the previous stages get SIGPIPE/EOF if a later stage couldn't be started.
+			if (iFDIn >= 0)
+				close(iFDIn);
+			if (iFDOut >= 0 && iFDOut != iFDFile)
+				close(iFDOut);
+			iFDIn = iFDNextIn;
+
+			if (!bStarted)
+			{
+				bOK = false;
+				break;
+			}
+			oPIDs.push_back(pid);
+		}
+
+		if (bOK && bCallback)
+			ConsumeOutput(iFDIn, iFDFile, oOptions.fnOutput);
+		if (iFDIn >= 0)
+			close(iFDIn);
+
+		for (const pid_t pid : oPIDs)
+		{
+			const int iExitCode = Internal::WaitForChild(pid);
+			if (pExitCodes)
+				pExitCodes->push_back(iExitCode);
+		}
+
+		if (iFDFile >= 0)
+			close(iFDFile);
+#endif
+
+		return bOK;
+	}
+
+}
\ No newline at end of file
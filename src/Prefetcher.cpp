@@ -0,0 +1,144 @@
+#include <rlSystem/Prefetcher.hpp>
+
+#include <algorithm>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+
+namespace rlSystem
+{
+
+	namespace
+	{
+
+		/// <summary>Ask the OS to load a file into the cache.</summary>
+		/// <returns>The number of bytes that are loaded.</returns>
+		uint64_t PrefetchFile(const std::u8string &sPath, uint64_t iMaxBytes)
+		{
+#ifdef _WIN32
+			return 0;
+#else
+			const int iFD = open(reinterpret_cast<const char *>(sPath.c_str()), O_RDONLY | O_CLOEXEC);
+			if (iFD < 0)
+				return 0;
+
+			uint64_t iSize = 0;
+			struct stat oStat;
+			if (fstat(iFD, &oStat) == 0 && S_ISREG(oStat.st_mode))
+			{
+				iSize = std::min<uint64_t>((uint64_t)oStat.st_size, iMaxBytes);
+				if (posix_fadvise(iFD, 0, (off_t)iSize, POSIX_FADV_WILLNEED) != 0)
+					iSize = 0;
+			}
+
+			close(iFD);
+			return iSize;
+#endif
+		}
+
+	}
+
+
+
+	Prefetcher::Prefetcher(std::vector<std::u8string> oPaths, const PrefetchOptions &oOptions) :
+		m_oPaths(std::move(oPaths)),
+		m_oOptions(oOptions),
+		m_oSizes(m_oPaths.size()),
+		m_oIssueTimes(m_oPaths.size()),
+		m_iWindow(std::clamp(oOptions.iInitialWindow, std::max(oOptions.iMinWindow, 1u),
+			std::max(oOptions.iMaxWindow, 1u)))
+	{
+#ifndef _WIN32
+		if (!m_oPaths.empty())
+			m_oThread = std::thread(&Prefetcher::Run, this);
+#endif
+	}
+
+	Prefetcher::~Prefetcher()
+	{
+		{
+			std::unique_lock lock(m_mux);
+			m_bStop = true;
+		}
+		m_cv.notify_one();
+
+		if (m_oThread.joinable())
+			m_oThread.join();
+	}
+
+	const std::u8string *Prefetcher::Next()
+	{
+		std::unique_lock lock(m_mux);
+		if (m_iNext >= m_oPaths.size())
+			return nullptr;
+
+		const size_t i = m_iNext++;
+
+		if (i < m_iIssued)
+		{
+			m_iBytesInFlight -= m_oSizes[i];
+
+			// prefetched too early: the data might already be evicted again.
+			const auto tIssued = m_oIssueTimes[i];
+			if (m_oOptions.bAdaptive && tIssued != std::chrono::steady_clock::time_point{} &&
+				std::chrono::steady_clock::now() - tIssued > 2 * m_oOptions.tTargetLead)
+				m_iWindow = std::max({ m_iWindow * 3 / 4, m_oOptions.iMinWindow, 1u });
+		}
+		else
+		{
+			// the consumer caught up: the prefetcher is too far behind.
+			if (m_oOptions.bAdaptive)
+				m_iWindow = std::min(m_iWindow * 2, std::max(m_oOptions.iMaxWindow, 1u));
+
+			m_iIssued = m_iNext; // skip the files that are already consumed
+		}
+
+		lock.unlock();
+		m_cv.notify_one();
+
+		return &m_oPaths[i];
+	}
+
+	unsigned Prefetcher::window() const
+	{
+		std::unique_lock lock(m_mux);
+		return m_iWindow;
+	}
+
+	void Prefetcher::Run()
+	{
+		std::unique_lock lock(m_mux);
+
+		while (true)
+		{
+			m_cv.wait(lock, [this]
+			{
+				return m_bStop ||
+					(m_iIssued < m_oPaths.size() && m_iIssued < m_iNext + m_iWindow &&
+						(m_iBytesInFlight < m_oOptions.iMaxBytesInFlight || m_iIssued == m_iNext));
+			});
+			if (m_bStop)
+				return;
+
+			const size_t i = m_iIssued;
+
+			lock.unlock();
+			const uint64_t iSize = PrefetchFile(m_oPaths[i], m_oOptions.iMaxBytesInFlight);
+			lock.lock();
+
+			m_oSizes[i]      = iSize;
+			m_oIssueTimes[i] = std::chrono::steady_clock::now();
+			m_iIssued        = std::max(i + 1, m_iIssued);
+
+			// the consumer might have already passed this file.
+			if (i >= m_iNext)
+				m_iBytesInFlight += iSize;
+		}
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,234 @@
+#include <rlSystem/Process.hpp>
+
+#include "include/ProcessSpawn.hpp"
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <csignal>
+
+#include <poll.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+
+namespace rlSystem
+{
+
+	namespace Internal
+	{
+
+#ifdef _WIN32
+		Process ProcessAccess::Adopt(HANDLE hProcess,
+			std::chrono::steady_clock::time_point tpStart)
+		{
+			return Process((int)GetProcessId(hProcess), hProcess, tpStart);
+		}
+#else
+		Process ProcessAccess::Adopt(pid_t pid, std::chrono::steady_clock::time_point tpStart)
+		{
+			int iPidFD = -1;
+#ifdef SYS_pidfd_open
+			iPidFD = (int)syscall(SYS_pidfd_open, pid, 0); // always close-on-exec
+#endif
+			return Process(pid, iPidFD, tpStart);
+		}
+#endif
+
+	}
+
+
+
+	Process::Process(Process &&other) noexcept :
+		m_iID(std::exchange(other.m_iID, 0)),
+		m_hHandle(std::exchange(other.m_hHandle, Process().m_hHandle)),
+		m_bFinished(other.m_bFinished),
+		m_iExitCode(other.m_iExitCode),
+		m_tpStart(other.m_tpStart),
+		m_oUsage(other.m_oUsage)
+	{}
+
+	Process &Process::operator=(Process &&other) noexcept
+	{
+		if (this != &other)
+		{
+			reset();
+
+			m_iID       = std::exchange(other.m_iID, 0);
+			m_hHandle   = std::exchange(other.m_hHandle, Process().m_hHandle);
+			m_bFinished = other.m_bFinished;
+			m_iExitCode = other.m_iExitCode;
+			m_tpStart   = other.m_tpStart;
+			m_oUsage    = other.m_oUsage;
+		}
+
+		return *this;
+	}
+
+	Process::~Process() { reset(); }
+
+	bool Process::valid() const noexcept
+	{
+#ifdef _WIN32
+		return m_hHandle != nullptr;
+#else
+		return m_iID > 0;
+#endif
+	}
+
+	void Process::reset() noexcept
+	{
+#ifdef _WIN32
+		if (m_hHandle)
+			CloseHandle(m_hHandle);
+		m_hHandle = nullptr;
+#else
+		// the process must be reaped when it ends, or it stays a zombie.
+		if (m_iID > 0 && !m_bFinished)
+			Internal::ReapLater(m_iID, m_hHandle);
+		else if (m_hHandle >= 0)
+			close(m_hHandle);
+		m_hHandle = -1;
+#endif
+
+		m_iID       = 0;
+		m_bFinished = false;
+		m_iExitCode = -1;
+		m_oUsage    = {};
+	}
+
+	void Process::finish(int iExitCode) noexcept
+	{
+		m_bFinished    = true;
+		m_iExitCode    = iExitCode;
+		m_oUsage.tWall = std::chrono::steady_clock::now() - m_tpStart;
+	}
+
+	bool Process::TryWait(int *pExitCode)
+	{
+		if (!valid())
+			return false;
+
+		if (!m_bFinished)
+		{
+#ifdef _WIN32
+			if (WaitForSingleObject(m_hHandle, 0) != WAIT_OBJECT_0)
+				return false;
+
+			Internal::QueryUsage(m_hHandle, m_oUsage);
+			DWORD dwExitCode;
+			finish(GetExitCodeProcess(m_hHandle, &dwExitCode) ? (int)dwExitCode : -1);
+#else
+			// on error (ECHILD), the process was reaped elsewhere: it has ended, too.
+			int iExitCode = -1;
+			if (!Internal::ReapChild(m_iID, false, iExitCode, &m_oUsage))
+				return false;
+			finish(iExitCode);
+#endif
+		}
+
+		if (pExitCode)
+			*pExitCode = m_iExitCode;
+		return true;
+	}
+
+	bool Process::WaitFor(std::chrono::milliseconds tTimeout, int *pExitCode)
+	{
+		if (!valid())
+			return false;
+		if (TryWait(pExitCode))
+			return true;
+
+#ifdef _WIN32
+		const DWORD dwTimeout =
+			(DWORD)std::clamp<long long>(tTimeout.count(), 0, INFINITE - 1);
+		if (WaitForSingleObject(m_hHandle, dwTimeout) != WAIT_OBJECT_0)
+			return false;
+		return TryWait(pExitCode);
+#else
+		const auto tpDeadline = std::chrono::steady_clock::now() + tTimeout;
+
+		// without a pidfd, there's nothing to wait for but time.
+		auto tSleep = std::chrono::microseconds(100);
+
+		while (true)
+		{
+			const auto tLeft = std::chrono::duration_cast<std::chrono::milliseconds>(
+				tpDeadline - std::chrono::steady_clock::now());
+
+			if (m_hHandle >= 0)
+			{
+				pollfd oPoll{ m_hHandle, POLLIN, 0 };
+				const int iResult = poll(&oPoll, 1,
+					(int)std::clamp<long long>(tLeft.count() + 1, 0, 0x7FFFFFFF));
+				if (iResult < 0 && errno != EINTR)
+					return false;
+			}
+			else
+			{
+				std::this_thread::sleep_for(std::min<std::chrono::microseconds>(tSleep,
+					std::max<std::chrono::microseconds>(tLeft, std::chrono::microseconds(0))));
+				tSleep = std::min<std::chrono::microseconds>(tSleep * 2,
+					std::chrono::milliseconds(10));
+			}
+
+			if (TryWait(pExitCode))
+				return true;
+			if (std::chrono::steady_clock::now() >= tpDeadline)
+				return false;
+		}
+#endif
+	}
+
+	int Process::Wait()
+	{
+		if (!valid())
+			return -1;
+
+		if (!m_bFinished)
+		{
+#ifdef _WIN32
+			WaitForSingleObject(m_hHandle, INFINITE);
+			int iExitCode = -1;
+			TryWait(&iExitCode);
+#else
+			finish(Internal::WaitForChild(m_iID, &m_oUsage));
+#endif
+		}
+
+		return m_iExitCode;
+	}
+
+	bool Process::Kill()
+	{
+		if (!valid())
+			return false;
+		if (m_bFinished)
+			return true;
+
+#ifdef _WIN32
+		return TerminateProcess(m_hHandle, 1) || WaitForSingleObject(m_hHandle, 0) == WAIT_OBJECT_0;
+#else
+#ifdef SYS_pidfd_send_signal
+		if (m_hHandle >= 0)
+		{
+			if (syscall(SYS_pidfd_send_signal, m_hHandle, SIGKILL, nullptr, 0) == 0)
+				return true;
+			if (errno != ENOSYS)
+				return errno == ESRCH;
+		}
+#endif
+
+		// the process isn't reaped yet, so its ID can't have been reused.
+		if (kill(m_iID, SIGKILL) == 0)
+			return true;
+		return errno == ESRCH;
+#endif
+	}
+
+}
\ No newline at end of file
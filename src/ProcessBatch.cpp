@@ -0,0 +1,96 @@
+#include <rlSystem/ProcessBatch.hpp>
+
+#include <algorithm>
+#include <mutex>
+#include <numeric>
+#include <thread>
+
+
+
+namespace rlSystem
+{
+
+	namespace
+	{
+
+		void RunJob(const ProcessJob &oJob, ProcessJobResult &oResult)
+		{
+			const char8_t *szCurrentDir =
+				oJob.sCurrentDir.empty() ? nullptr : oJob.sCurrentDir.c_str();
+
+			const auto tpStart = std::chrono::steady_clock::now();
+			if (oJob.bCapture)
+				oResult.bStarted = RunConsoleApp(oJob.sAppPath.c_str(), oJob.sArgs.c_str(),
+					szCurrentDir, &oResult.iExitCode, oResult.oOutput, oJob.oCapture,
+					&oResult.oUsage);
+			else
+				oResult.bStarted = RunConsoleApp(oJob.sAppPath.c_str(), oJob.sArgs.c_str(),
+					szCurrentDir, &oResult.iExitCode, nullptr, nullptr, &oResult.oUsage);
+			oResult.tDuration = std::chrono::steady_clock::now() - tpStart;
+		}
+
+	}
+
+
+
+	std::vector<ProcessJobResult> RunBatch(const std::vector<ProcessJob> &oJobs,
+		const BatchOptions &oOptions)
+	{
+		std::vector<ProcessJobResult> oResults(oJobs.size());
+		if (oJobs.empty())
+			return oResults;
+
+		std::vector<size_t> oOrder(oJobs.size());
+		std::iota(oOrder.begin(), oOrder.end(), size_t(0));
+		std::stable_sort(oOrder.begin(), oOrder.end(),
+			[&](size_t a, size_t b) { return oJobs[a].iPriority > oJobs[b].iPriority; });
+
+		std::mutex mux;
+		size_t iNext    = 0; // index into oOrder
+		bool   bAborted = false;
+
+		// every worker waits for one child at a time, so at most iThreads children are running.
+		const auto fnWorker = [&]
+		{
+			std::unique_lock lock(mux);
+			while (!bAborted && iNext < oOrder.size())
+			{
+				const size_t iJob = oOrder[iNext++];
+
+				lock.unlock();
+				RunJob(oJobs[iJob], oResults[iJob]);
+				lock.lock();
+
+				if (oOptions.bFailFast && !oResults[iJob].succeeded())
+					bAborted = true;
+				if (oOptions.fnFinished)
+					oOptions.fnFinished(iJob, oResults[iJob]);
+			}
+		};
+
+		unsigned iThreads = oOptions.iMaxParallel;
+		if (iThreads == 0)
+			iThreads = std::max(std::thread::hardware_concurrency(), 1u);
+		iThreads = (unsigned)std::min<size_t>(iThreads, oJobs.size());
+
+		std::vector<std::thread> oThreads;
+		oThreads.reserve(iThreads - 1);
+		for (unsigned i = 1; i < iThreads; ++i)
+		{
+			oThreads.emplace_back(fnWorker);
+		}
+		fnWorker();
+		for (auto &oThread : oThreads)
+		{
+			oThread.join();
+		}
+
+		for (size_t i = iNext; i < oOrder.size(); ++i)
+		{
+			oResults[oOrder[i]].bCancelled = true;
+		}
+
+		return oResults;
+	}
+
+}
\ No newline at end of file
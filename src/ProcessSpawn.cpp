@@ -0,0 +1,851 @@
+#include "include/ProcessSpawn.hpp"
+
+#include <rlSystem/FileSystem.hpp>
+#include <rlSystem/WindowsUnicodeString.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char **environ;
+#else
+#include <psapi.h>
+#endif
+
+
+
+namespace rlSystem
+{
+
+#ifndef _WIN32
+	namespace
+	{
+
+		/// <summary>
+		/// Split a command line into arguments, following the quoting rules of POSIX shells:
+		/// <para/>
+		/// Arguments are separated by whitespace. Inside single quotes, all characters are
+		/// literal. Inside double quotes, a backslash only escapes <c>"</c>, <c>\</c>, <c>$</c>
+		/// and <c>`</c>. Elsewhere, a backslash escapes any character.<para/>
+		/// No other shell features (variables, globs, ...) are supported.
+		/// </summary>
+		std::vector<std::string> SplitArgs(std::string_view sArgs)
+		{
+			std::vector<std::string> oResult;
+
+			std::string sCurrent;
+			bool bInArg = false;
+			for (size_t i = 0; i < sArgs.length(); ++i)
+			{
+				const char c = sArgs[i];
+
+				switch (c)
+				{
+				case ' ':
+				case '\t':
+				case '\n':
+					if (bInArg)
+					{
+						oResult.push_back(std::move(sCurrent));
+						sCurrent.clear();
+						bInArg = false;
+					}
+					continue;
+
+				case '\'':
+				{
+					const size_t iEnd = sArgs.find('\'', i + 1);
+					const size_t iLen = (iEnd == std::string_view::npos ? sArgs.length() : iEnd) - i - 1;
+					sCurrent.append(sArgs.substr(i + 1, iLen));
+					i += iLen + 1;
+					break;
+				}
+
+				case '"':
+					for (++i; i < sArgs.length() && sArgs[i] != '"'; ++i)
+					{
+						if (sArgs[i] == '\\' && i + 1 < sArgs.length() &&
+							std::string_view("\"\\$`").find(sArgs[i + 1]) != std::string_view::npos)
+							++i;
+						sCurrent += sArgs[i];
+					}
+					break;
+
+				case '\\':
+					if (i + 1 < sArgs.length())
+						sCurrent += sArgs[++i];
+					break;
+
+				default:
+					sCurrent += c;
+				}
+
+				bInArg = true;
+			}
+
+			if (bInArg)
+				oResult.push_back(std::move(sCurrent));
+
+			return oResult;
+		}
+
+		/// <summary>Read the I/O counters of a process from <c>/proc/[pid]/io</c>.</summary>
+		void ReadIOCounters(pid_t pid, ResourceUsage &oUsage) noexcept
+		{
+			char szPath[32];
+			std::snprintf(szPath, sizeof(szPath), "/proc/%d/io", (int)pid);
+
+			const int iFD = open(szPath, O_RDONLY | O_CLOEXEC);
+			if (iFD < 0)
+				return;
+
+			char szData[512];
+			const ssize_t iRead = read(iFD, szData, sizeof(szData) - 1);
+			close(iFD);
+			if (iRead <= 0)
+				return;
+			szData[iRead] = 0;
+
+			const auto fnValue = [&](const char *szKey) -> uint64_t
+			{
+				const char *p = std::strstr(szData, szKey);
+				return p ? std::strtoull(p + std::strlen(szKey), nullptr, 10) : 0;
+			};
+			oUsage.iReadBytes         = fnValue("rchar: ");
+			oUsage.iWriteBytes        = fnValue("wchar: ");
+			oUsage.iStorageReadBytes  = fnValue("\nread_bytes: ");
+			oUsage.iStorageWriteBytes = fnValue("\nwrite_bytes: ");
+		}
+
+		/// <summary>
+		/// Blocks <c>SIGPIPE</c> for the current thread, so writing to a pipe whose reading side
+		/// is closed fails with <c>EPIPE</c> instead of terminating the process.
+		/// </summary>
+		class SIGPIPEBlocker final
+		{
+		public: // methods
+
+			SIGPIPEBlocker() noexcept
+			{
+				sigemptyset(&m_oSignals);
+				sigaddset(&m_oSignals, SIGPIPE);
+
+				sigset_t oPending;
+				sigpending(&oPending);
+				m_bWasPending = sigismember(&oPending, SIGPIPE) == 1;
+
+				pthread_sigmask(SIG_BLOCK, &m_oSignals, &m_oPrevious);
+			}
+
+			SIGPIPEBlocker(const SIGPIPEBlocker &) = delete;
+			SIGPIPEBlocker &operator=(const SIGPIPEBlocker &) = delete;
+
+			~SIGPIPEBlocker()
+			{
+				// discard a SIGPIPE raised while it was blocked.
+				sigset_t oPending;
+				sigpending(&oPending);
+				if (!m_bWasPending && sigismember(&oPending, SIGPIPE) == 1)
+				{
+					const timespec tTimeout{};
+					sigtimedwait(&m_oSignals, nullptr, &tTimeout);
+				}
+
+				pthread_sigmask(SIG_SETMASK, &m_oPrevious, nullptr);
+			}
+
+
+		private: // variables
+
+			sigset_t m_oSignals;
+			sigset_t m_oPrevious;
+			bool     m_bWasPending = false;
+
+		};
+
+		/// <summary>
+		/// Reaps the child processes nobody waits for, so they don't stay zombies.<para/>
+		/// A single thread serves all of them: it polls their pidfds, and checks the processes
+		/// without one periodically.
+		/// </summary>
+		class Reaper final
+		{
+		public: // static methods
+
+			/// <summary>The instance. It's never destroyed, as its thread never ends.</summary>
+			static Reaper &Instance()
+			{
+				static Reaper *const pInstance = new Reaper();
+				return *pInstance;
+			}
+
+
+		public: // methods
+
+			Reaper(const Reaper &) = delete;
+			Reaper &operator=(const Reaper &) = delete;
+
+			/// <summary>Take responsibility for reaping a child process.</summary>
+			/// <param name="iPidFD">
+			/// A pidfd of the process, or -1. Only owned by the reaper if the call succeeds.
+			/// </param>
+			void Add(pid_t pid, int iPidFD)
+			{
+				{
+					std::lock_guard oLock(m_mtx);
+					m_oChildren.push_back({ pid, iPidFD });
+
+					if (!m_bRunning)
+					{
+						try
+						{
+							std::thread(&Reaper::Run, this).detach();
+							m_bRunning = true;
+						}
+						catch (const std::system_error &)
+						{
+							// the process is reaped once the thread can be started.
+						}
+					}
+				}
+
+				// if the pipe is full, the thread is woken up anyway.
+				if (m_iWakeFDs[1] >= 0 && write(m_iWakeFDs[1], "", 1) < 0) {}
+			}
+
+
+		private: // types
+
+			struct Child
+			{
+				pid_t pid;
+				int   iPidFD;
+			};
+
+
+		private: // methods
+
+			Reaper() noexcept
+			{
+				if (pipe2(m_iWakeFDs, O_CLOEXEC | O_NONBLOCK) != 0)
+					m_iWakeFDs[0] = m_iWakeFDs[1] = -1;
+			}
+
+			void Run()
+			{
+				std::vector<pollfd> oPoll;
+				while (true)
+				{
+					oPoll.clear();
+					oPoll.push_back({ m_iWakeFDs[0], POLLIN, 0 }); // ignored if negative
+					bool bUnpollable = false;
+
+					{
+						std::lock_guard oLock(m_mtx);
+						std::erase_if(m_oChildren, [](const Child &oChild)
+						{
+							int iExitCode;
+							if (!Internal::ReapChild(oChild.pid, false, iExitCode, nullptr))
+								return false;
+
+							if (oChild.iPidFD >= 0)
+								close(oChild.iPidFD);
+							return true;
+						});
+
+						for (const auto &oChild : m_oChildren)
+						{
+							if (oChild.iPidFD >= 0)
+								oPoll.push_back({ oChild.iPidFD, POLLIN, 0 });
+							else
+								bUnpollable = true;
+						}
+					}
+
+					// without a pidfd (or a wake-up pipe), there's nothing to wait for but time.
+					const int iTimeout = bUnpollable || m_iWakeFDs[0] < 0 ? 100 : -1;
+					if (poll(oPoll.data(), oPoll.size(), iTimeout) > 0 &&
+						(oPoll[0].revents & POLLIN))
+					{
+						char cBuf[64];
+						while (read(m_iWakeFDs[0], cBuf, sizeof(cBuf)) > 0) {}
+					}
+				}
+			}
+
+
+		private: // variables
+
+			std::mutex         m_mtx;
+			std::vector<Child> m_oChildren;
+			bool               m_bRunning    = false;
+			int                m_iWakeFDs[2] = { -1, -1 }; // wakes the thread for new children
+
+		};
+
+	}
+#endif
+
+
+
+	namespace Internal
+	{
+
+		void CaptureSink::Write(const char *pData, size_t iSize)
+		{
+			if (m_iMaxSize)
+			{
+				const size_t iLeft = m_iMaxSize - m_iWritten;
+				if (iSize > iLeft)
+				{
+					iSize = iLeft;
+					m_bTruncated = true;
+				}
+			}
+			if (iSize == 0)
+				return;
+
+			m_iWritten += iSize;
+			if (m_fn)
+				m_fn(std::string_view(pData, iSize));
+			else
+				m_sBuffer.append(pData, iSize);
+		}
+
+#ifndef _WIN32
+
+		int DecodeWaitStatus(int iStatus) noexcept
+		{
+			if (WIFEXITED(iStatus))
+				return WEXITSTATUS(iStatus);
+			if (WIFSIGNALED(iStatus))
+				return 128 + WTERMSIG(iStatus);
+			return -1;
+		}
+
+		bool ReapChild(pid_t pid, bool bBlock, int &iExitCode, ResourceUsage *pUsage) noexcept
+		{
+			iExitCode = -1;
+			const int iBlock = bBlock ? 0 : WNOHANG;
+
+			if (!pUsage)
+			{
+				int iStatus = 0;
+				pid_t iResult;
+				do
+				{
+					iResult = waitpid(pid, &iStatus, iBlock);
+				} while (iResult < 0 && errno == EINTR);
+
+				if (iResult == 0)
+					return false;
+				if (iResult > 0)
+					iExitCode = DecodeWaitStatus(iStatus);
+				return true;
+			}
+
+			// The I/O counters are gone once the process is reaped, but they can still be read
+			// while it's a zombie: wait without reaping first.
+			siginfo_t oInfo{};
+			int iResult;
+			do
+			{
+				iResult = waitid(P_PID, (id_t)pid, &oInfo, WEXITED | WNOWAIT | iBlock);
+			} while (iResult < 0 && errno == EINTR);
+
+			if (iResult < 0)
+				return true;
+			if (oInfo.si_pid == 0)
+				return false; // still running
+
+			*pUsage = {};
+			ReadIOCounters(pid, *pUsage);
+
+			int iStatus = 0;
+			rusage oRUsage{};
+			pid_t iReaped;
+			do
+			{
+				iReaped = wait4(pid, &iStatus, 0, &oRUsage);
+			} while (iReaped < 0 && errno == EINTR);
+
+			if (iReaped < 0)
+				return true;
+
+			iExitCode = DecodeWaitStatus(iStatus);
+
+			const auto fnTime = [](const timeval &tv)
+			{
+				return std::chrono::seconds(tv.tv_sec) + std::chrono::microseconds(tv.tv_usec);
+			};
+			pUsage->tUser                       = fnTime(oRUsage.ru_utime);
+			pUsage->tSystem                     = fnTime(oRUsage.ru_stime);
+			pUsage->iPeakRSS                    = (uint64_t)oRUsage.ru_maxrss * 1024; // KiB
+			pUsage->iVoluntaryContextSwitches   = (uint64_t)oRUsage.ru_nvcsw;
+			pUsage->iInvoluntaryContextSwitches = (uint64_t)oRUsage.ru_nivcsw;
+
+			return true;
+		}
+
+		int WaitForChild(pid_t pid, ResourceUsage *pUsage) noexcept
+		{
+			int iExitCode = -1;
+			ReapChild(pid, true, iExitCode, pUsage);
+			return iExitCode;
+		}
+
+		void ReapLater(pid_t pid, int iPidFD) noexcept
+		{
+#ifdef SYS_pidfd_open
+			if (iPidFD < 0)
+				iPidFD = (int)syscall(SYS_pidfd_open, pid, 0); // always close-on-exec
+#endif
+
+			try
+			{
+				Reaper::Instance().Add(pid, iPidFD);
+			}
+			catch (...)
+			{
+				// out of memory: the process stays a zombie.
+				if (iPidFD >= 0)
+					close(iPidFD);
+			}
+		}
+
+		Command::Command(const char8_t *szAppPath, const char8_t *szArgs) :
+			m_szAppPath(szAppPath)
+		{
+			const auto oArgs = SplitArgs(szArgs ? reinterpret_cast<const char *>(szArgs) : "");
+
+			std::vector<std::u8string_view> oArgViews;
+			oArgViews.reserve(oArgs.size());
+			for (const auto &sArg : oArgs)
+			{
+				oArgViews.emplace_back(reinterpret_cast<const char8_t *>(sArg.data()),
+					sArg.length());
+			}
+
+			Init(oArgViews, {});
+		}
+
+		Command::Command(const char8_t *szAppPath, std::span<const std::u8string_view> oArgs,
+			std::span<const std::u8string_view> oEnvironment) :
+			m_szAppPath(szAppPath)
+		{
+			Init(oArgs, oEnvironment);
+		}
+
+		void Command::Init(std::span<const std::u8string_view> oArgs,
+			std::span<const std::u8string_view> oEnvironment)
+		{
+			const std::u8string_view sAppPath = m_szAppPath;
+
+			const size_t iArgvCount = 1 + oArgs.size() + 1;
+			const size_t iEnvpCount = oEnvironment.empty() ? 0 : oEnvironment.size() + 1;
+
+			size_t iStringBytes = sAppPath.length() + 1;
+			for (const auto &s : oArgs)
+				iStringBytes += s.length() + 1;
+			for (const auto &s : oEnvironment)
+				iStringBytes += s.length() + 1;
+
+			const size_t iPointers = iArgvCount + iEnvpCount;
+			m_up_Buffer = std::make_unique_for_overwrite<char *[]>(
+				iPointers + (iStringBytes + sizeof(char *) - 1) / sizeof(char *));
+
+			char **pPointer = m_up_Buffer.get();
+			char  *pString  = reinterpret_cast<char *>(m_up_Buffer.get() + iPointers);
+
+			const auto fnAdd = [&](std::u8string_view s)
+			{
+				*pPointer++ = pString;
+				std::memcpy(pString, s.data(), s.length());
+				pString += s.length();
+				*pString++ = 0;
+			};
+
+			m_pArgv = pPointer;
+			fnAdd(sAppPath);
+			for (const auto &s : oArgs)
+				fnAdd(s);
+			*pPointer++ = nullptr;
+
+			if (iEnvpCount)
+			{
+				m_pEnvp = pPointer;
+				for (const auto &s : oEnvironment)
+					fnAdd(s);
+				*pPointer++ = nullptr;
+			}
+		}
+
+		char *const *Command::envp() const noexcept { return m_pEnvp ? m_pEnvp : environ; }
+
+		bool SpawnChild(
+			const Command                    &oCommand,
+			const char8_t                    *szCurrentDir,
+			      posix_spawn_file_actions_t &oActions,
+			      pid_t                      &pid
+		)
+		{
+			// posix_spawn creates the child via clone(CLONE_VM | CLONE_VFORK): unlike fork, the
+			// page tables of the parent aren't copied, so the cost doesn't depend on its size.
+
+			const char *szFile = reinterpret_cast<const char *>(oCommand.appPath());
+
+			// the child changes its working directory before the executable is resolved.
+			std::u8string sAbsolutePath;
+			if (szCurrentDir && szFile[0] != '/' && std::strchr(szFile, '/'))
+			{
+				sAbsolutePath = Path::Absolute(oCommand.appPath());
+				szFile        = reinterpret_cast<const char *>(sAbsolutePath.c_str());
+			}
+
+			if (szCurrentDir && posix_spawn_file_actions_addchdir_np(&oActions,
+				reinterpret_cast<const char *>(szCurrentDir)) != 0)
+				return false;
+
+			// the child shouldn't inherit blocked or ignored signals (e.g. an ignored SIGPIPE).
+			posix_spawnattr_t oAttr;
+			posix_spawnattr_init(&oAttr);
+			sigset_t oSignals;
+			sigemptyset(&oSignals);
+			posix_spawnattr_setsigmask(&oAttr, &oSignals);
+			sigaddset(&oSignals, SIGPIPE);
+			posix_spawnattr_setsigdefault(&oAttr, &oSignals);
+			posix_spawnattr_setflags(&oAttr, POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF);
+
+			// without a slash, the executable is searched in PATH (like CreateProcess does).
+			const bool bOK = posix_spawnp(&pid, szFile, &oActions, &oAttr, oCommand.argv(),
+				oCommand.envp()) == 0;
+
+			posix_spawnattr_destroy(&oAttr);
+			return bOK;
+		}
+
+		void DrainPipes(const int *pFDs, CaptureSink *const *pSinks, size_t iCount,
+			int iInputFD, std::string_view sInput)
+		{
+			// the input pipe is the last entry.
+			std::vector<pollfd> oPoll(iCount + 1);
+			for (size_t i = 0; i < iCount; ++i)
+			{
+				oPoll[i].fd     = pFDs[i];
+				oPoll[i].events = POLLIN;
+			}
+			oPoll[iCount].fd     = iInputFD;
+			oPoll[iCount].events = POLLOUT;
+
+			// the child might exit (or close stdin) before it has read all of the input.
+			std::unique_ptr<SIGPIPEBlocker> up_oBlocker;
+			size_t iOpen = iCount;
+			if (iInputFD >= 0)
+			{
+				up_oBlocker = std::make_unique<SIGPIPEBlocker>();
+				fcntl(iInputFD, F_SETFL, fcntl(iInputFD, F_GETFL) | O_NONBLOCK);
+				++iOpen;
+			}
+
+			const auto fnCloseInput = [&]
+			{
+				close(oPoll[iCount].fd);
+				oPoll[iCount].fd = -1;
+				--iOpen;
+			};
+			if (iInputFD >= 0 && sInput.empty())
+				fnCloseInput();
+
+			auto up_buf = std::make_unique<char[]>(iReadBufferSize);
+			while (iOpen > 0)
+			{
+				if (poll(oPoll.data(), oPoll.size(), -1) < 0)
+				{
+					if (errno == EINTR)
+						continue;
+					break;
+				}
+
+				for (size_t i = 0; i < iCount; ++i)
+				{
+					auto &o = oPoll[i];
+					if (o.fd < 0 || o.revents == 0)
+						continue;
+
+					const ssize_t iRead = read(o.fd, up_buf.get(), iReadBufferSize);
+					if (iRead > 0)
+						pSinks[i]->Write(up_buf.get(), (size_t)iRead);
+					else if (iRead == 0 || (errno != EINTR && errno != EAGAIN))
+					{
+						close(o.fd);
+						o.fd = -1; // ignored by poll
+						--iOpen;
+					}
+				}
+
+				if (oPoll[iCount].fd >= 0 && oPoll[iCount].revents)
+				{
+					// non-blocking: might write only a part.
+					const ssize_t iWritten = write(oPoll[iCount].fd, sInput.data(),
+						std::min(sInput.length(), iReadBufferSize));
+					if (iWritten > 0)
+						sInput.remove_prefix((size_t)iWritten);
+					if ((iWritten < 0 && errno != EINTR && errno != EAGAIN) || sInput.empty())
+						fnCloseInput();
+				}
+			}
+
+			for (auto &o : oPoll)
+			{
+				if (o.fd >= 0)
+					close(o.fd);
+			}
+		}
+
+#else
+
+		namespace
+		{
+
+			/// <summary>
+			/// Append an argument, quoted so <c>CommandLineToArgvW</c> and the C runtime parse it
+			/// back unchanged.
+			/// </summary>
+			void AppendQuoted(std::u8string &sCmd, std::u8string_view sArg)
+			{
+				if (!sArg.empty() && sArg.find_first_of(u8" \t\n\v\"") == std::u8string_view::npos)
+				{
+					sCmd += sArg;
+					return;
+				}
+
+				// backslashes are only special before a quote.
+				sCmd += u8'"';
+				for (size_t i = 0; ; ++i)
+				{
+					size_t iBackslashes = 0;
+					while (i < sArg.length() && sArg[i] == u8'\\')
+					{
+						++iBackslashes;
+						++i;
+					}
+
+					if (i == sArg.length())
+					{
+						sCmd.append(iBackslashes * 2, u8'\\');
+						break;
+					}
+
+					if (sArg[i] == u8'"')
+						sCmd.append(iBackslashes * 2 + 1, u8'\\');
+					else
+						sCmd.append(iBackslashes, u8'\\');
+					sCmd += sArg[i];
+				}
+				sCmd += u8'"';
+			}
+
+			/// <summary>
+			/// Convert UTF-8 to UTF-16, including embedded null characters.<para/>
+			/// A UTF-16 string never has more code units than the UTF-8 string has bytes, so the
+			/// result is converted in a single call.
+			/// </summary>
+			std::wstring Widen(std::u8string_view s)
+			{
+				std::wstring sResult(s.length(), L'\0');
+				const int iLen = MultiByteToWideChar(CP_UTF8, 0,
+					reinterpret_cast<const char *>(s.data()), (int)s.length(),
+					sResult.data(), (int)sResult.length());
+				sResult.resize(iLen > 0 ? (size_t)iLen : 0);
+				return sResult;
+			}
+
+		}
+
+		Command::Command(const char8_t *szAppPath, const char8_t *szArgs) :
+			m_szAppPath(szAppPath)
+		{
+			const std::u8string_view sAppPath = szAppPath;
+			const std::u8string_view sArgs    = szArgs ? szArgs : u8"";
+
+			std::u8string sCmd;
+			sCmd.reserve(1 + sAppPath.length() + 1 + 1 + sArgs.length());
+			sCmd += u8'"';
+			sCmd += sAppPath;
+			sCmd += u8'"';
+			if (szArgs)
+			{
+				sCmd += u8' ';
+				sCmd += sArgs;
+			}
+
+			m_sCommandLine = Widen(sCmd);
+		}
+
+		Command::Command(const char8_t *szAppPath, std::span<const std::u8string_view> oArgs,
+			std::span<const std::u8string_view> oEnvironment) :
+			m_szAppPath(szAppPath)
+		{
+			Init(oArgs, oEnvironment);
+		}
+
+		void Command::Init(std::span<const std::u8string_view> oArgs,
+			std::span<const std::u8string_view> oEnvironment)
+		{
+			const std::u8string_view sAppPath = m_szAppPath;
+
+			// worst case: every character is a backslash before a quote, plus quotes and a space.
+			size_t iMaxLength = 1 + sAppPath.length() + 1;
+			for (const auto &sArg : oArgs)
+				iMaxLength += 1 + 2 * sArg.length() + 2;
+
+			std::u8string sCmd;
+			sCmd.reserve(iMaxLength);
+			sCmd += u8'"';
+			sCmd += sAppPath;
+			sCmd += u8'"';
+			for (const auto &sArg : oArgs)
+			{
+				sCmd += u8' ';
+				AppendQuoted(sCmd, sArg);
+			}
+			m_sCommandLine = Widen(sCmd);
+
+			if (!oEnvironment.empty())
+			{
+				// "NAME=value\0NAME=value\0\0"
+				size_t iLength = 1;
+				for (const auto &sVar : oEnvironment)
+					iLength += sVar.length() + 1;
+
+				std::u8string sBlock;
+				sBlock.reserve(iLength);
+				for (const auto &sVar : oEnvironment)
+				{
+					sBlock += sVar;
+					sBlock += u8'\0';
+				}
+				sBlock += u8'\0';
+				m_sEnvironment = Widen(sBlock);
+			}
+		}
+
+		bool StartProcess(
+			      Command             &oCommand,
+			const char8_t             *szCurrentDir,
+			      DWORD                dwCreationFlags,
+			      STARTUPINFOW        &si,
+			      PROCESS_INFORMATION &pi
+		)
+		{
+			void *pEnvironment = oCommand.environment();
+			if (pEnvironment)
+				dwCreationFlags |= CREATE_UNICODE_ENVIRONMENT;
+
+			return CreateProcessW(
+				NULL,                                            // lpApplicationName
+				oCommand.commandLine(),                          // lpCommandLine
+				NULL,                                            // lpProcessAttributes
+				NULL,                                            // lpThreadAttributes
+				TRUE,                                            // bInheritHandles
+				dwCreationFlags,                                 // dwCreationFlags,
+				pEnvironment,                                    // lpEnvironment
+				szCurrentDir ?                                   // lpCurrentDirectory
+				rlSystem::String::ToOS(szCurrentDir).c_str()
+				: 0,
+				&si,                                             // lpStartupInfo
+				&pi                                              // lpProcessInformation
+			);
+		}
+
+		void DrainPipe(HANDLE hPipe, CaptureSink &oSink)
+		{
+			auto up_buf = std::make_unique<char[]>(iReadBufferSize);
+			DWORD dwRead = 0;
+			while (ReadFile(hPipe, up_buf.get(), (DWORD)iReadBufferSize, &dwRead, NULL) &&
+				dwRead > 0)
+			{
+				oSink.Write(up_buf.get(), dwRead);
+			}
+		}
+
+		void FillPipe(HANDLE hPipe, std::string_view sData) noexcept
+		{
+			// fails with ERROR_NO_DATA/ERROR_BROKEN_PIPE once the child has closed its side.
+			while (!sData.empty())
+			{
+				DWORD dwWritten = 0;
+				const DWORD dwSize = (DWORD)std::min<size_t>(sData.length(), iReadBufferSize);
+				if (!WriteFile(hPipe, sData.data(), dwSize, &dwWritten, NULL))
+					break;
+				sData.remove_prefix(dwWritten);
+			}
+
+			CloseHandle(hPipe);
+		}
+
+		int WaitForProcess(HANDLE hProcess, ResourceUsage *pUsage) noexcept
+		{
+			WaitForSingleObject(hProcess, INFINITE);
+			if (pUsage)
+				QueryUsage(hProcess, *pUsage);
+
+			DWORD dwExitCode;
+			if (!GetExitCodeProcess(hProcess, &dwExitCode))
+				return 0;
+			return (int)dwExitCode;
+		}
+
+		void QueryUsage(HANDLE hProcess, ResourceUsage &oUsage) noexcept
+		{
+			oUsage = {};
+
+			// FILETIME: 100 ns units
+			const auto fnTime = [](const FILETIME &ft)
+			{
+				const uint64_t i = ((uint64_t)ft.dwHighDateTime << 32) | ft.dwLowDateTime;
+				return std::chrono::nanoseconds(i * 100);
+			};
+			FILETIME ftCreation, ftExit, ftKernel, ftUser;
+			if (GetProcessTimes(hProcess, &ftCreation, &ftExit, &ftKernel, &ftUser))
+			{
+				oUsage.tUser   = fnTime(ftUser);
+				oUsage.tSystem = fnTime(ftKernel);
+			}
+
+			PROCESS_MEMORY_COUNTERS oMemory{};
+			oMemory.cb = sizeof(oMemory);
+			if (GetProcessMemoryInfo(hProcess, &oMemory, sizeof(oMemory)))
+				oUsage.iPeakRSS = oMemory.PeakWorkingSetSize;
+
+			IO_COUNTERS oIO{};
+			if (GetProcessIoCounters(hProcess, &oIO))
+			{
+				oUsage.iReadBytes  = oIO.ReadTransferCount;
+				oUsage.iWriteBytes = oIO.WriteTransferCount;
+			}
+		}
+
+#endif
+
+	}
+
+}
\ No newline at end of file
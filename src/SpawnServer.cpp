@@ -0,0 +1,499 @@
+#include <rlSystem/AppExecution.hpp>
+
+#include "include/ProcessSpawn.hpp"
+
+#ifndef _WIN32
+#include <rlSystem/FileSystem.hpp>
+
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/prctl.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+
+
+namespace rlSystem
+{
+
+#ifndef _WIN32
+	namespace
+	{
+
+		// Protocol (SOCK_SEQPACKET, so every message arrives in one piece):
+		//
+		// client --> server, via the shared socket:
+		//     RequestHeader, followed by the executable, the arguments and the environment as
+		//     zero-terminated strings. Attached: the reply socket, stdin, stdout, stderr and
+		//     the working directory.
+		// server --> client, via the reply socket:
+		//     StartedReply, then ExitedReply once the process has ended.
+
+		struct RequestHeader
+		{
+			uint32_t iArgs;
+			uint32_t iEnvironment;
+		};
+
+		struct StartedReply
+		{
+			int32_t iError; // errno, or 0 if the process was started
+			int32_t iPID;
+		};
+
+		struct ExitedReply
+		{
+			int32_t       iExitCode;
+			ResourceUsage oUsage;
+		};
+
+		enum RequestFD
+		{
+			FD_Reply,
+			FD_StdIn,
+			FD_StdOut,
+			FD_StdErr,
+			FD_CurrentDir,
+
+			FD_Count
+		};
+
+		/// <summary>
+		/// The maximum size of a request.<para/>
+		/// Larger requests (e.g. huge environments) are started directly.
+		/// </summary>
+		constexpr size_t iMaxRequestSize = 128 * 1024;
+
+		std::mutex g_mux;
+		int        g_iSocket   = -1;
+		pid_t      g_pidServer = 0;
+
+
+
+		bool SendMessage(int iSocket, const void *pData, size_t iSize, const int *pFDs,
+			size_t iFDs) noexcept
+		{
+			iovec oIO{ const_cast<void *>(pData), iSize };
+
+			alignas(cmsghdr) char szControl[CMSG_SPACE(sizeof(int) * FD_Count)]{};
+			msghdr oMsg{};
+			oMsg.msg_iov    = &oIO;
+			oMsg.msg_iovlen = 1;
+			if (iFDs > 0)
+			{
+				oMsg.msg_control    = szControl;
+				oMsg.msg_controllen = CMSG_SPACE(sizeof(int) * iFDs);
+
+				cmsghdr *pHeader = CMSG_FIRSTHDR(&oMsg);
+				pHeader->cmsg_level = SOL_SOCKET;
+				pHeader->cmsg_type  = SCM_RIGHTS;
+				pHeader->cmsg_len   = CMSG_LEN(sizeof(int) * iFDs);
+				std::memcpy(CMSG_DATA(pHeader), pFDs, sizeof(int) * iFDs);
+			}
+
+			ssize_t iSent;
+			do
+			{
+				iSent = sendmsg(iSocket, &oMsg, MSG_NOSIGNAL);
+			} while (iSent < 0 && errno == EINTR);
+			return iSent == (ssize_t)iSize;
+		}
+
+		/// <summary>Receive a message and the attached file descriptors.</summary>
+		/// <param name="iFDs">Receives the number of file descriptors.</param>
+		/// <returns>The size of the message, 0 if the socket was closed, or -1 on error.</returns>
+		ssize_t ReceiveMessage(int iSocket, void *pData, size_t iSize, int *pFDs,
+			size_t &iFDs) noexcept
+		{
+			iFDs = 0;
+			iovec oIO{ pData, iSize };
+
+			alignas(cmsghdr) char szControl[CMSG_SPACE(sizeof(int) * FD_Count)]{};
+			msghdr oMsg{};
+			oMsg.msg_iov        = &oIO;
+			oMsg.msg_iovlen     = 1;
+			oMsg.msg_control    = szControl;
+			oMsg.msg_controllen = sizeof(szControl);
+
+			ssize_t iReceived;
+			do
+			{
+				iReceived = recvmsg(iSocket, &oMsg, MSG_CMSG_CLOEXEC);
+			} while (iReceived < 0 && errno == EINTR);
+			if (iReceived < 0)
+				return -1;
+
+			for (cmsghdr *p = CMSG_FIRSTHDR(&oMsg); p; p = CMSG_NXTHDR(&oMsg, p))
+			{
+				if (p->cmsg_level != SOL_SOCKET || p->cmsg_type != SCM_RIGHTS)
+					continue;
+
+				const size_t iCount = (p->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+				std::memcpy(pFDs + iFDs, CMSG_DATA(p), sizeof(int) * iCount);
+				iFDs += iCount;
+			}
+
+			// a truncated message must not be processed.
+			if (oMsg.msg_flags & (MSG_TRUNC | MSG_CTRUNC))
+			{
+				for (size_t i = 0; i < iFDs; ++i)
+					close(pFDs[i]);
+				iFDs  = 0;
+				errno = EMSGSIZE;
+				return -1;
+			}
+
+			return iReceived;
+		}
+
+
+
+		/// <summary>Start the process described by a request.</summary>
+		/// <returns>The PID, or 0 if the process couldn't be started.</returns>
+		pid_t HandleRequest(const char *pData, size_t iSize, const int *pFDs, int &iError)
+		{
+			iError = EINVAL;
+
+			RequestHeader oHeader;
+			if (iSize < sizeof(oHeader) || pData[iSize - 1] != 0)
+				return 0;
+			std::memcpy(&oHeader, pData, sizeof(oHeader));
+
+			// the executable, the arguments and the environment.
+			std::vector<std::u8string_view> oStrings;
+			for (size_t iPos = sizeof(oHeader); iPos < iSize;)
+			{
+				const std::u8string_view s(reinterpret_cast<const char8_t *>(pData + iPos));
+				oStrings.push_back(s);
+				iPos += s.length() + 1;
+			}
+			if (oStrings.size() != 1 + (size_t)oHeader.iArgs + oHeader.iEnvironment)
+				return 0;
+
+			const std::u8string sAppPath(oStrings[0]);
+			const std::span<const std::u8string_view> oArgs(oStrings.data() + 1, oHeader.iArgs);
+			const std::span<const std::u8string_view> oEnvironment(
+				oStrings.data() + 1 + oHeader.iArgs, oHeader.iEnvironment);
+			Internal::Command oCommand(sAppPath.c_str(), oArgs, oEnvironment);
+
+			// dup2 clears O_CLOEXEC on the child's copies.
+			posix_spawn_file_actions_t oActions;
+			posix_spawn_file_actions_init(&oActions);
+			bool bOK =
+				posix_spawn_file_actions_adddup2(&oActions, pFDs[FD_StdIn], STDIN_FILENO) == 0 &&
+				posix_spawn_file_actions_adddup2(&oActions, pFDs[FD_StdOut], STDOUT_FILENO) == 0 &&
+				posix_spawn_file_actions_adddup2(&oActions, pFDs[FD_StdErr], STDERR_FILENO) == 0 &&
+				posix_spawn_file_actions_addfchdir_np(&oActions, pFDs[FD_CurrentDir]) == 0;
+
+			pid_t pid = 0;
+			errno = 0;
+			if (bOK)
+				bOK = Internal::SpawnChild(oCommand, nullptr, oActions, pid);
+			iError = bOK ? 0 : (errno ? errno : ENOENT);
+			posix_spawn_file_actions_destroy(&oActions);
+
+			return bOK ? pid : 0;
+		}
+
+		/// <summary>The main loop of the spawn server.</summary>
+		[[noreturn]] void ServerMain(int iSocket)
+		{
+			// children are reaped via a signalfd, so SIGCHLD must be blocked (and not ignored).
+			signal(SIGCHLD, SIG_DFL);
+			signal(SIGPIPE, SIG_IGN);
+			sigset_t oSignals;
+			sigemptyset(&oSignals);
+			sigaddset(&oSignals, SIGCHLD);
+			sigprocmask(SIG_BLOCK, &oSignals, nullptr);
+			const int iSignalFD = signalfd(-1, &oSignals, SFD_NONBLOCK | SFD_CLOEXEC);
+			if (iSignalFD < 0)
+				_exit(1);
+
+			std::unordered_map<pid_t, int> oChildren; // PID --> reply socket
+			auto up_buf = std::make_unique<char[]>(iMaxRequestSize);
+			bool bOpen = true;
+
+			// when the client closes the socket, the server ends after the last child.
+			while (bOpen || !oChildren.empty())
+			{
+				pollfd oPoll[2] = { { iSignalFD, POLLIN, 0 }, { bOpen ? iSocket : -1, POLLIN, 0 } };
+				if (poll(oPoll, 2, -1) < 0)
+				{
+					if (errno == EINTR)
+						continue;
+					break;
+				}
+
+				if (oPoll[0].revents)
+				{
+					signalfd_siginfo oInfo;
+					while (read(iSignalFD, &oInfo, sizeof(oInfo)) > 0) {}
+
+					// signals are merged, so every child that has ended must be reaped.
+					while (true)
+					{
+						siginfo_t oChild{};
+						if (waitid(P_ALL, 0, &oChild, WEXITED | WNOHANG | WNOWAIT) != 0 ||
+							oChild.si_pid == 0)
+							break;
+
+						ExitedReply oReply{};
+						Internal::ReapChild(oChild.si_pid, true, oReply.iExitCode, &oReply.oUsage);
+
+						const auto it = oChildren.find(oChild.si_pid);
+						if (it != oChildren.end())
+						{
+							SendMessage(it->second, &oReply, sizeof(oReply), nullptr, 0);
+							close(it->second);
+							oChildren.erase(it);
+						}
+					}
+				}
+
+				if (oPoll[1].revents)
+				{
+					int iFDs[FD_Count];
+					size_t iFDCount = 0;
+					const ssize_t iSize =
+						ReceiveMessage(iSocket, up_buf.get(), iMaxRequestSize, iFDs, iFDCount);
+					if (iSize == 0 || (iSize < 0 && errno != EMSGSIZE))
+					{
+						bOpen = false;
+						close(iSocket);
+						continue;
+					}
+
+					StartedReply oReply{ EINVAL, 0 };
+					if (iSize > 0 && iFDCount == FD_Count)
+					{
+						int iError = 0;
+						const pid_t pid = HandleRequest(up_buf.get(), (size_t)iSize, iFDs, iError);
+						oReply = { iError, (int32_t)pid };
+					}
+
+					if (iFDCount > FD_Reply)
+					{
+						if (SendMessage(iFDs[FD_Reply], &oReply, sizeof(oReply), nullptr, 0) &&
+							oReply.iPID != 0)
+							oChildren.emplace(oReply.iPID, iFDs[FD_Reply]);
+						else
+							close(iFDs[FD_Reply]);
+					}
+
+					// otherwise, the pipes of the child would never report EOF.
+					for (size_t i = FD_Reply + 1; i < iFDCount; ++i)
+						close(iFDs[i]);
+				}
+			}
+
+			_exit(0);
+		}
+
+	}
+#endif
+
+
+
+	namespace SpawnServer
+	{
+
+		bool Start()
+		{
+#ifdef _WIN32
+			return false; // CreateProcess doesn't depend on the size of the parent anyway
+#else
+			std::unique_lock lock(g_mux);
+			if (g_iSocket >= 0)
+				return true;
+
+			int iSockets[2];
+			if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, iSockets) != 0)
+				return false;
+
+			// the kernel limits the size of a message to the send buffer. Capped at
+			// /proc/sys/net/core/wmem_max, which is fine.
+			const int iBufferSize = (int)iMaxRequestSize * 2;
+			setsockopt(iSockets[0], SOL_SOCKET, SO_SNDBUF, &iBufferSize, sizeof(iBufferSize));
+
+			const pid_t pidParent = getpid();
+			const pid_t pid = fork();
+			if (pid < 0)
+			{
+				close(iSockets[0]);
+				close(iSockets[1]);
+				return false;
+			}
+
+			if (pid == 0)
+			{
+				// the server shouldn't survive the current application.
+				prctl(PR_SET_PDEATHSIG, SIGKILL);
+				if (getppid() != pidParent)
+					_exit(0);
+
+				// drop everything inherited except for the standard streams and the socket.
+				close(iSockets[0]);
+				if (iSockets[1] != 3)
+				{
+					dup2(iSockets[1], 3);
+					fcntl(3, F_SETFD, FD_CLOEXEC);
+				}
+#ifdef SYS_close_range
+				if (syscall(SYS_close_range, 4u, ~0u, 0u) != 0)
+#endif
+				{
+					for (int i = 4; i < 1024; ++i)
+						close(i);
+				}
+
+				ServerMain(3);
+			}
+
+			close(iSockets[1]);
+			g_iSocket   = iSockets[0];
+			g_pidServer = pid;
+			return true;
+#endif
+		}
+
+		void Stop()
+		{
+#ifndef _WIN32
+			std::unique_lock lock(g_mux);
+			if (g_iSocket < 0)
+				return;
+
+			close(g_iSocket);
+			g_iSocket = -1;
+			const pid_t pid = g_pidServer;
+			lock.unlock();
+
+			while (waitpid(pid, nullptr, 0) < 0 && errno == EINTR) {}
+#endif
+		}
+
+		bool IsRunning()
+		{
+#ifdef _WIN32
+			return false;
+#else
+			std::unique_lock lock(g_mux);
+			return g_iSocket >= 0;
+#endif
+		}
+
+	}
+
+
+
+#ifndef _WIN32
+	namespace Internal
+	{
+
+		RemoteResult SpawnRemote(const Command &oCommand, const char8_t *szCurrentDir,
+			int iFDIn, int iFDOut, int iFDErr, RemoteChild &oChild)
+		{
+			oChild = {};
+
+			if (!SpawnServer::IsRunning())
+				return RemoteResult::Unavailable;
+
+			// the server has a different working directory.
+			const char8_t *szAppPath = oCommand.appPath();
+			std::u8string sAbsolutePath;
+			if (szAppPath[0] != '/' && std::strchr(reinterpret_cast<const char *>(szAppPath), '/'))
+			{
+				sAbsolutePath = Path::Absolute(szAppPath);
+				szAppPath     = sAbsolutePath.c_str();
+			}
+
+			RequestHeader oHeader{};
+			std::string sRequest(sizeof(oHeader), '\0');
+			sRequest.append(reinterpret_cast<const char *>(szAppPath)).push_back('\0');
+			for (auto pp = oCommand.argv() + 1; *pp; ++pp, ++oHeader.iArgs)
+				sRequest.append(*pp).push_back('\0');
+			for (auto pp = oCommand.envp(); *pp; ++pp, ++oHeader.iEnvironment)
+				sRequest.append(*pp).push_back('\0');
+			std::memcpy(sRequest.data(), &oHeader, sizeof(oHeader));
+			if (sRequest.size() > iMaxRequestSize)
+				return RemoteResult::Unavailable;
+
+			const int iDir = open(szCurrentDir ? reinterpret_cast<const char *>(szCurrentDir) : ".",
+				O_PATH | O_DIRECTORY | O_CLOEXEC);
+			if (iDir < 0)
+				return RemoteResult::Failed;
+
+			int iReply[2];
+			if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, iReply) != 0)
+			{
+				close(iDir);
+				return RemoteResult::Unavailable;
+			}
+
+			const int iFDs[FD_Count] = { iReply[1], iFDIn, iFDOut, iFDErr, iDir };
+			bool bSent;
+			{
+				std::unique_lock lock(g_mux);
+				bSent = g_iSocket >= 0 &&
+					SendMessage(g_iSocket, sRequest.data(), sRequest.size(), iFDs, FD_Count);
+			}
+			close(iReply[1]);
+			close(iDir);
+
+			StartedReply oStarted{};
+			if (!bSent || recv(iReply[0], &oStarted, sizeof(oStarted), 0) != sizeof(oStarted))
+			{
+				// the server has ended (or never got the request).
+				close(iReply[0]);
+				return RemoteResult::Unavailable;
+			}
+
+			if (oStarted.iError != 0)
+			{
+				close(iReply[0]);
+				errno = oStarted.iError;
+				return RemoteResult::Failed;
+			}
+
+			oChild.iReplyFD = iReply[0];
+			oChild.pid      = oStarted.iPID;
+			return RemoteResult::Started;
+		}
+
+		int WaitRemote(RemoteChild &oChild, ResourceUsage *pUsage) noexcept
+		{
+			ExitedReply oReply{};
+			ssize_t iReceived;
+			do
+			{
+				iReceived = recv(oChild.iReplyFD, &oReply, sizeof(oReply), 0);
+			} while (iReceived < 0 && errno == EINTR);
+
+			close(oChild.iReplyFD);
+			oChild = {};
+
+			if (iReceived != sizeof(oReply))
+				return -1;
+
+			if (pUsage)
+				*pUsage = oReply.oUsage;
+			return oReply.iExitCode;
+		}
+
+	}
+#endif
+
+}
\ No newline at end of file
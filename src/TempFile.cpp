@@ -0,0 +1,323 @@
+#include <rlSystem/TempFile.hpp>
+
+#include <rlSystem/FileSystem.hpp>
+
+#include <filesystem>
+#include <random>
+#include <thread>
+#include <utility>
+
+#ifdef _WIN32
+#include "include/IncludeWindows.h"
+#include <rlSystem/WindowsUnicodeString.hpp>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+
+
+namespace rlSystem
+{
+
+	namespace
+	{
+
+		/// <summary>How often a random name is tried before giving up.</summary>
+		constexpr unsigned iMaxAttempts = 100;
+
+		/// <summary>Create a random name. Thread-safe.</summary>
+		std::u8string RandomName()
+		{
+			thread_local std::mt19937_64 oRandom(
+				(uint64_t(std::random_device{}()) << 32) ^ std::random_device{}() ^
+				std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+			constexpr char8_t cHex[] = u8"0123456789ABCDEF";
+
+			std::u8string sResult = u8"rlSystem-";
+			uint64_t iRand = oRandom();
+			for (int i = 0; i < 16; ++i)
+			{
+				sResult += cHex[iRand & 0xF];
+				iRand >>= 4;
+			}
+
+			return sResult;
+		}
+
+		/// <summary>
+		/// Get the directory a temporary item is created in, with a trailing delimiter.
+		/// </summary>
+		/// <returns>If the directory can't be determined, an empty string.</returns>
+		std::u8string GetTempDirectory(const char8_t *szDirPath)
+		{
+			if (szDirPath)
+				return Path::IncludeTrailingDelim(Path::Absolute(szDirPath).c_str());
+
+			std::error_code ec;
+			const auto path = fs::temp_directory_path(ec);
+			if (ec)
+				return {};
+
+			return Path::IncludeTrailingDelim(path.u8string().c_str());
+		}
+
+#ifndef _WIN32
+		const char *ToOS(const char8_t *sz) { return reinterpret_cast<const char *>(sz); }
+#endif
+
+	}
+
+
+
+	TempFile::TempFile(const char8_t *szDirPath)
+	{
+		const auto sDir = GetTempDirectory(szDirPath);
+		if (sDir.empty())
+			return;
+
+#ifdef _WIN32
+		for (unsigned i = 0; i < iMaxAttempts && !m_pFile; ++i)
+		{
+			const auto sPath = sDir + RandomName();
+
+			// "x": fail if the file exists; "T": keep in the cache if possible
+			m_pFile = _wfopen(String::ToOS(sPath.c_str()).c_str(), L"w+bxT");
+			if (m_pFile)
+				m_sPath = sPath;
+			else if (errno != EEXIST)
+				break;
+		}
+#else
+		int iFD = open(ToOS(sDir.c_str()), O_TMPFILE | O_RDWR | O_CLOEXEC, 0600);
+
+		// O_TMPFILE isn't supported by all file systems (and older kernels)
+		if (iFD < 0 && (errno == EOPNOTSUPP || errno == EISDIR || errno == EINVAL))
+		{
+			for (unsigned i = 0; i < iMaxAttempts; ++i)
+			{
+				const auto sPath = sDir + RandomName();
+
+				iFD = open(ToOS(sPath.c_str()), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+				if (iFD >= 0)
+				{
+					m_sPath = sPath;
+					break;
+				}
+				if (errno != EEXIST)
+					break;
+			}
+		}
+
+		if (iFD < 0)
+			return;
+
+		m_pFile = fdopen(iFD, "w+b");
+		if (!m_pFile)
+		{
+			close(iFD);
+			if (!m_sPath.empty())
+				unlink(ToOS(m_sPath.c_str()));
+			m_sPath.clear();
+		}
+#endif
+	}
+
+	TempFile::TempFile(TempFile &&other) noexcept :
+		m_pFile(std::exchange(other.m_pFile, nullptr)), m_sPath(std::move(other.m_sPath))
+	{
+		other.m_sPath.clear();
+	}
+
+	TempFile &TempFile::operator=(TempFile &&other) noexcept
+	{
+		if (this != &other)
+		{
+			Discard();
+
+			m_pFile = std::exchange(other.m_pFile, nullptr);
+			m_sPath = std::move(other.m_sPath);
+			other.m_sPath.clear();
+		}
+
+		return *this;
+	}
+
+	TempFile::~TempFile() { Discard(); }
+
+	bool TempFile::Publish(const char8_t *szFilePath, bool bReplace)
+	{
+		if (!m_pFile || fflush(m_pFile) != 0)
+			return false;
+
+#ifdef _WIN32
+		// an open file can't be renamed.
+		fclose(m_pFile);
+		m_pFile = nullptr;
+
+		const DWORD dwFlags = bReplace ? MOVEFILE_REPLACE_EXISTING : 0;
+		if (!MoveFileExW(String::ToOS(m_sPath.c_str()).c_str(),
+			String::ToOS(szFilePath).c_str(), dwFlags))
+		{
+			m_pFile = _wfopen(String::ToOS(m_sPath.c_str()).c_str(), L"r+b");
+			if (m_pFile)
+				fseek(m_pFile, 0, SEEK_END);
+			return false;
+		}
+#else
+		if (m_sPath.empty())
+		{
+			// An anonymous file can only be linked into the file system via its /proc entry
+			// (or with AT_EMPTY_PATH, which requires CAP_DAC_READ_SEARCH).
+			const int iFD = fileno(m_pFile);
+			const auto sProcPath = "/proc/self/fd/" + std::to_string(iFD);
+
+			const auto fnLink = [&](const char *szPath)
+			{
+				if (linkat(AT_FDCWD, sProcPath.c_str(), AT_FDCWD, szPath, AT_SYMLINK_FOLLOW) == 0)
+					return true;
+				if (errno != ENOENT)
+					return false;
+				return linkat(iFD, "", AT_FDCWD, szPath, AT_EMPTY_PATH) == 0;
+			};
+
+			if (!bReplace)
+			{
+				if (!fnLink(ToOS(szFilePath)))
+					return false;
+			}
+			else
+			{
+				// linkat never replaces: link to a unique name next to the target, then rename.
+				bool bLinked = false;
+				std::u8string sStaging;
+				for (unsigned i = 0; i < iMaxAttempts && !bLinked; ++i)
+				{
+					sStaging = std::u8string(szFilePath) + u8"." + RandomName();
+					bLinked = fnLink(ToOS(sStaging.c_str()));
+					if (!bLinked && errno != EEXIST)
+						return false;
+				}
+				if (!bLinked)
+					return false;
+
+				if (rename(ToOS(sStaging.c_str()), ToOS(szFilePath)) != 0)
+				{
+					unlink(ToOS(sStaging.c_str()));
+					return false;
+				}
+			}
+		}
+		else
+		{
+			const int iResult = renameat2(AT_FDCWD, ToOS(m_sPath.c_str()), AT_FDCWD,
+				ToOS(szFilePath), bReplace ? 0 : RENAME_NOREPLACE);
+			if (iResult != 0)
+			{
+				// RENAME_NOREPLACE isn't supported by all file systems; link + unlink also
+				// never replaces.
+				if (bReplace || errno != EINVAL ||
+					link(ToOS(m_sPath.c_str()), ToOS(szFilePath)) != 0)
+					return false;
+				unlink(ToOS(m_sPath.c_str()));
+			}
+		}
+
+		fclose(m_pFile);
+		m_pFile = nullptr;
+#endif
+
+		m_sPath.clear();
+		return true;
+	}
+
+	void TempFile::Discard() noexcept
+	{
+		if (m_pFile)
+			fclose(m_pFile);
+		m_pFile = nullptr;
+
+		if (!m_sPath.empty())
+		{
+			std::error_code ec;
+			fs::remove(m_sPath, ec);
+			m_sPath.clear();
+		}
+	}
+
+
+
+	TempDirectory::TempDirectory(const char8_t *szParentDirPath)
+	{
+		const auto sDir = GetTempDirectory(szParentDirPath);
+		if (sDir.empty())
+			return;
+
+		for (unsigned i = 0; i < iMaxAttempts; ++i)
+		{
+			auto sPath = sDir + RandomName();
+
+#ifdef _WIN32
+			if (CreateDirectoryW(String::ToOS(sPath.c_str()).c_str(), NULL))
+#else
+			if (mkdir(ToOS(sPath.c_str()), 0700) == 0)
+#endif
+			{
+				m_sPath = std::move(sPath);
+				break;
+			}
+
+#ifdef _WIN32
+			if (GetLastError() != ERROR_ALREADY_EXISTS)
+#else
+			if (errno != EEXIST)
+#endif
+				break;
+		}
+	}
+
+	TempDirectory::TempDirectory(TempDirectory &&other) noexcept :
+		m_sPath(std::move(other.m_sPath))
+	{
+		other.m_sPath.clear();
+	}
+
+	TempDirectory &TempDirectory::operator=(TempDirectory &&other) noexcept
+	{
+		if (this != &other)
+		{
+			Discard();
+
+			m_sPath = std::move(other.m_sPath);
+			other.m_sPath.clear();
+		}
+
+		return *this;
+	}
+
+	TempDirectory::~TempDirectory() { Discard(); }
+
+	std::u8string TempDirectory::Release() noexcept
+	{
+		std::u8string sResult;
+		sResult.swap(m_sPath);
+		return sResult;
+	}
+
+	void TempDirectory::Discard() noexcept
+	{
+		if (m_sPath.empty())
+			return;
+
+		std::error_code ec;
+		fs::remove_all(m_sPath, ec);
+		m_sPath.clear();
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,456 @@
+#include <rlSystem/UnicodeCaseFolding.hpp>
+
+#include "include/CaseFoldingTable.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RLSYSTEM_CASEFOLD_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define RLSYSTEM_CASEFOLD_NEON
+#include <arm_neon.h>
+#endif
+
+
+
+namespace rlSystem
+{
+
+	namespace Unicode
+	{
+
+		namespace
+		{
+
+			/// <summary>
+			/// Invalid bytes are decoded to this value plus the byte, so they only equal themselves
+			/// and are ordered after all code points.
+			/// </summary>
+			constexpr char32_t cInvalid = 0x110000;
+
+			/// <summary>The number of folded bytes that are hashed at once.</summary>
+			constexpr size_t iHashChunk = 256;
+
+			inline char8_t FoldASCII(uint8_t c) noexcept
+			{
+				return (char8_t)(c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c);
+			}
+
+			/// <summary>
+			/// Decode the non-ASCII UTF-8 sequence at <c>p[i]</c>.<para/>
+			/// If the sequence is ill-formed, only its first byte is consumed and returned as
+			/// <c>cInvalid + byte</c>.
+			/// </summary>
+			inline char32_t Decode(const uint8_t *p, size_t iLength, size_t &i) noexcept
+			{
+				const uint8_t c = p[i];
+
+				// the number of continuation bytes and the range of the first one.
+				unsigned iFollowing;
+				uint8_t  cMin = 0x80;
+				uint8_t  cMax = 0xBF;
+				if (c >= 0xC2 && c <= 0xDF)
+					iFollowing = 1;
+				else if (c >= 0xE0 && c <= 0xEF)
+				{
+					iFollowing = 2;
+					if (c == 0xE0)
+						cMin = 0xA0; // overlong
+					else if (c == 0xED)
+						cMax = 0x9F; // surrogates
+				}
+				else if (c >= 0xF0 && c <= 0xF4)
+				{
+					iFollowing = 3;
+					if (c == 0xF0)
+						cMin = 0x90; // overlong
+					else if (c == 0xF4)
+						cMax = 0x8F; // above U+10FFFF
+				}
+				else
+				{
+					++i;
+					return cInvalid + c;
+				}
+
+				char32_t iCodePoint = c & (0x3F >> iFollowing);
+				for (unsigned iByte = 1; iByte <= iFollowing; ++iByte)
+				{
+					const size_t  j     = i + iByte;
+					const uint8_t cNext = j < iLength ? p[j] : 0;
+					if (cNext < cMin || cNext > cMax)
+					{
+						++i;
+						return cInvalid + c;
+					}
+
+					iCodePoint = (iCodePoint << 6) | (cNext & 0x3F);
+					cMin = 0x80;
+					cMax = 0xBF;
+				}
+
+				i += 1 + iFollowing;
+				return iCodePoint;
+			}
+
+			inline void Encode(char32_t iCodePoint, char8_t *pDest, size_t &iDest) noexcept
+			{
+				if (iCodePoint < 0x80) // e.g. the Kelvin sign folds to "k"
+					pDest[iDest++] = (char8_t)iCodePoint;
+				else if (iCodePoint < 0x800)
+				{
+					pDest[iDest++] = (char8_t)(0xC0 | (iCodePoint >> 6));
+					pDest[iDest++] = (char8_t)(0x80 | (iCodePoint & 0x3F));
+				}
+				else if (iCodePoint < 0x10000)
+				{
+					pDest[iDest++] = (char8_t)(0xE0 | (iCodePoint >> 12));
+					pDest[iDest++] = (char8_t)(0x80 | ((iCodePoint >> 6) & 0x3F));
+					pDest[iDest++] = (char8_t)(0x80 | (iCodePoint & 0x3F));
+				}
+				else
+				{
+					pDest[iDest++] = (char8_t)(0xF0 | (iCodePoint >> 18));
+					pDest[iDest++] = (char8_t)(0x80 | ((iCodePoint >> 12) & 0x3F));
+					pDest[iDest++] = (char8_t)(0x80 | ((iCodePoint >> 6) & 0x3F));
+					pDest[iDest++] = (char8_t)(0x80 | (iCodePoint & 0x3F));
+				}
+			}
+
+			/// <summary>Decode and fold the character at <c>p[i]</c>.</summary>
+			inline char32_t NextFolded(const uint8_t *p, size_t iLength, size_t &i) noexcept
+			{
+				if (p[i] < 0x80)
+					return FoldASCII(p[i++]);
+
+				return FoldCase(Decode(p, iLength, i));
+			}
+
+			/// <summary>
+			/// Fold the non-ASCII character at <c>p[i]</c> and append it to <c>pDest</c>.
+			/// Characters without folding (and invalid bytes) are copied unchanged.
+			/// </summary>
+			inline void FoldCharacter(const uint8_t *p, size_t iLength, size_t &i, char8_t *pDest,
+				size_t &iDest) noexcept
+			{
+				const size_t   iStart  = i;
+				const char32_t c       = Decode(p, iLength, i);
+				const char32_t cFolded = FoldCase(c);
+
+				if (cFolded == c)
+				{
+					for (size_t j = iStart; j < i; ++j)
+					{
+						pDest[iDest++] = (char8_t)p[j];
+					}
+				}
+				else
+					Encode(cFolded, pDest, iDest);
+			}
+
+#if defined(RLSYSTEM_CASEFOLD_SSE2)
+			inline __m128i FoldASCII(__m128i v) noexcept
+			{
+				// bytes >= 0x80 are negative, so they're never in range.
+				const __m128i vUpper = _mm_and_si128(
+					_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)),
+					_mm_cmplt_epi8(v, _mm_set1_epi8('Z' + 1)));
+				return _mm_or_si128(v, _mm_and_si128(vUpper, _mm_set1_epi8(0x20)));
+			}
+#elif defined(RLSYSTEM_CASEFOLD_NEON)
+			inline uint8x16_t FoldASCII(uint8x16_t v) noexcept
+			{
+				const uint8x16_t vUpper =
+					vandq_u8(vcgeq_u8(v, vdupq_n_u8('A')), vcleq_u8(v, vdupq_n_u8('Z')));
+				return vorrq_u8(v, vandq_u8(vUpper, vdupq_n_u8(0x20)));
+			}
+#endif
+
+			/// <summary>
+			/// Fold a block of 16 UTF-8 code units, as far as they're ASCII.<para/>
+			/// Always writes 16 code units to <c>pDest</c>; the ones after the ASCII prefix are
+			/// garbage and overwritten later.
+			/// </summary>
+			/// <returns>The length of the ASCII prefix.</returns>
+			inline size_t FoldASCIIBlock(const uint8_t *p, char8_t *pDest) noexcept
+			{
+#if defined(RLSYSTEM_CASEFOLD_SSE2)
+				const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(pDest), FoldASCII(v));
+
+				const unsigned iMask = (unsigned)_mm_movemask_epi8(v); // the high bits
+				return iMask == 0 ? 16 : (size_t)std::countr_zero(iMask);
+#elif defined(RLSYSTEM_CASEFOLD_NEON)
+				const uint8x16_t v = vld1q_u8(p);
+				vst1q_u8(reinterpret_cast<uint8_t *>(pDest), FoldASCII(v));
+
+				if (vmaxvq_u8(v) < 0x80)
+					return 16;
+				size_t i = 0;
+				while (p[i] < 0x80)
+					++i;
+				return i;
+#else
+				size_t i = 0;
+				for (; i < 16 && p[i] < 0x80; ++i)
+					pDest[i] = FoldASCII(p[i]);
+				return i;
+#endif
+			}
+
+			/// <summary>Compare two blocks of 16 UTF-8 code units.</summary>
+			/// <returns>
+			/// The length of the common prefix that consists of ASCII characters that are equal
+			/// after folding.
+			/// </returns>
+			inline size_t EqualASCIIPrefix(const uint8_t *p1, const uint8_t *p2) noexcept
+			{
+#if defined(RLSYSTEM_CASEFOLD_SSE2)
+				const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p1));
+				const __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p2));
+
+				const unsigned iEqual =
+					(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(FoldASCII(v1), FoldASCII(v2)));
+				const unsigned iASCII = ~(unsigned)_mm_movemask_epi8(_mm_or_si128(v1, v2));
+				return (size_t)std::countr_one(iEqual & iASCII & 0xFFFF);
+#elif defined(RLSYSTEM_CASEFOLD_NEON)
+				const uint8x16_t v1 = vld1q_u8(p1);
+				const uint8x16_t v2 = vld1q_u8(p2);
+
+				const uint8x16_t vEqual = vceqq_u8(FoldASCII(v1), FoldASCII(v2));
+				const uint8x16_t vASCII = vcltq_u8(vorrq_u8(v1, v2), vdupq_n_u8(0x80));
+				if (vminvq_u8(vandq_u8(vEqual, vASCII)) == 0xFF)
+					return 16;
+#endif
+#if !defined(RLSYSTEM_CASEFOLD_SSE2)
+				size_t i = 0;
+				while (i < 16 && (p1[i] | p2[i]) < 0x80 && FoldASCII(p1[i]) == FoldASCII(p2[i]))
+					++i;
+				return i;
+#endif
+			}
+
+			/// <summary>
+			/// Fold characters from <c>p[i]</c> on until either the input ends or at least
+			/// <c>iDestLimit</c> code units were written.<para/>
+			/// <c>pDest</c> must have room for <c>iDestLimit + 20</c> code units (or
+			/// <c>MaxFoldedLength</c> of the whole input).
+			/// </summary>
+			/// <returns>The number of code units written.</returns>
+			size_t FoldRange(const uint8_t *p, size_t iLength, size_t &i, char8_t *pDest,
+				size_t iDestLimit) noexcept
+			{
+				size_t iDest = 0;
+				while (i < iLength && iDest < iDestLimit)
+				{
+					if (iLength - i >= 16)
+					{
+						const size_t iASCII = FoldASCIIBlock(p + i, pDest + iDest);
+						i     += iASCII;
+						iDest += iASCII;
+						if (iASCII == 16)
+							continue;
+					}
+					else
+					{
+						// the end of the input.
+						while (i < iLength && p[i] < 0x80)
+							pDest[iDest++] = FoldASCII(p[i++]);
+						if (i == iLength)
+							break;
+					}
+
+					FoldCharacter(p, iLength, i, pDest, iDest);
+				}
+
+				return iDest;
+			}
+
+			struct Mismatch
+			{
+				bool     bEnd1; // did the first string end?
+				bool     bEnd2; // did the second string end?
+				char32_t c1;    // if neither ended: the differing folded characters
+				char32_t c2;
+			};
+
+			/// <summary>Skip the common casefolded prefix of two strings.</summary>
+			Mismatch FindMismatch(std::u8string_view s1, std::u8string_view s2) noexcept
+			{
+				const auto p1 = reinterpret_cast<const uint8_t *>(s1.data());
+				const auto p2 = reinterpret_cast<const uint8_t *>(s2.data());
+				const size_t iLength1 = s1.length();
+				const size_t iLength2 = s2.length();
+
+				size_t i1 = 0;
+				size_t i2 = 0;
+				while (true)
+				{
+					while (true)
+					{
+						const size_t iAvailable = std::min(iLength1 - i1, iLength2 - i2);
+						if (iAvailable >= 16)
+						{
+							const size_t iEqual = EqualASCIIPrefix(p1 + i1, p2 + i2);
+							i1 += iEqual;
+							i2 += iEqual;
+							if (iEqual == 16)
+								continue;
+						}
+						else if (iLength1 - i1 == iLength2 - i2 && iLength1 >= 16 && iLength2 >= 16)
+						{
+							// the rest of both strings, as the second part of the last block.
+							// (If the first part isn't plain ASCII, the characters are compared
+							// one by one instead.)
+							const size_t iOverlap = 16 - iAvailable;
+							const size_t iEqual   =
+								EqualASCIIPrefix(p1 + iLength1 - 16, p2 + iLength2 - 16);
+							if (iEqual > iOverlap)
+							{
+								i1 += iEqual - iOverlap;
+								i2 += iEqual - iOverlap;
+							}
+						}
+						break;
+					}
+
+					if (i1 == iLength1 || i2 == iLength2)
+						return { i1 == iLength1, i2 == iLength2, 0, 0 };
+
+					const char32_t c1 = NextFolded(p1, iLength1, i1);
+					const char32_t c2 = NextFolded(p2, iLength2, i2);
+					if (c1 != c2)
+						return { false, false, c1, c2 };
+				}
+			}
+
+		}
+
+
+
+		char32_t FoldCase(char32_t c) noexcept
+		{
+			if (c < 0x80)
+				return FoldASCII((uint8_t)c);
+
+			const auto itEnd = std::end(Internal::oCaseFoldRanges);
+			const auto it    = std::lower_bound(std::begin(Internal::oCaseFoldRanges), itEnd, c,
+				[](const Internal::CaseFoldRange &oRange, char32_t cValue)
+				{
+					return oRange.cLast < cValue;
+				});
+			if (it == itEnd || c < it->cFirst || (c - it->cFirst) % it->iStride != 0)
+				return c;
+
+			return (char32_t)((int32_t)c + it->iDelta);
+		}
+
+		size_t FoldCase(std::u8string_view s, char8_t *pDest) noexcept
+		{
+			size_t i = 0;
+			return FoldRange(reinterpret_cast<const uint8_t *>(s.data()), s.length(), i, pDest,
+				SIZE_MAX);
+		}
+
+		std::u8string FoldCase(std::u8string_view s)
+		{
+			std::u8string sResult(MaxFoldedLength(s.length()), 0);
+			sResult.resize(FoldCase(s, sResult.data()));
+			return sResult;
+		}
+
+		int CompareNoCase(std::u8string_view s1, std::u8string_view s2) noexcept
+		{
+			const auto oMismatch = FindMismatch(s1, s2);
+			if (oMismatch.bEnd1 || oMismatch.bEnd2)
+				return (int)!oMismatch.bEnd1 - (int)!oMismatch.bEnd2;
+
+			return oMismatch.c1 < oMismatch.c2 ? -1 : 1;
+		}
+
+		bool EqualNoCase(std::u8string_view s1, std::u8string_view s2) noexcept
+		{
+			const auto oMismatch = FindMismatch(s1, s2);
+			return oMismatch.bEnd1 && oMismatch.bEnd2;
+		}
+
+		bool StartsWithNoCase(std::u8string_view s, std::u8string_view sPrefix) noexcept
+		{
+			return FindMismatch(s, sPrefix).bEnd2;
+		}
+
+		size_t HashNoCase(std::u8string_view s) noexcept
+		{
+			// The folded string is hashed in chunks of a fixed size, so the result only depends
+			// on the folded string, not on how the input was split into blocks.
+			const auto p = reinterpret_cast<const uint8_t *>(s.data());
+			const std::hash<std::u8string_view> fnHash;
+
+			char8_t szChunk[iHashChunk + 32];
+			size_t iChunk = 0;
+			size_t iHash  = 0;
+			size_t i      = 0;
+			while (i < s.length())
+			{
+				iChunk += FoldRange(p, s.length(), i, szChunk + iChunk, iHashChunk - iChunk);
+				if (iChunk >= iHashChunk)
+				{
+					iHash = (iHash ^ fnHash({ szChunk, iHashChunk })) * (size_t)0x100000001B3;
+					iChunk -= iHashChunk;
+					std::memmove(szChunk, szChunk + iHashChunk, iChunk);
+				}
+			}
+
+			return iHash ^ fnHash({ szChunk, iChunk });
+		}
+
+
+
+		namespace Reference
+		{
+
+			size_t FoldCase(std::u8string_view s, char8_t *pDest) noexcept
+			{
+				const auto p = reinterpret_cast<const uint8_t *>(s.data());
+
+				size_t iDest = 0;
+				for (size_t i = 0; i < s.length();)
+				{
+					if (p[i] < 0x80)
+						pDest[iDest++] = FoldASCII(p[i++]);
+					else
+						FoldCharacter(p, s.length(), i, pDest, iDest);
+				}
+
+				return iDest;
+			}
+
+			int CompareNoCase(std::u8string_view s1, std::u8string_view s2) noexcept
+			{
+				const auto p1 = reinterpret_cast<const uint8_t *>(s1.data());
+				const auto p2 = reinterpret_cast<const uint8_t *>(s2.data());
+
+				size_t i1 = 0;
+				size_t i2 = 0;
+				while (i1 < s1.length() && i2 < s2.length())
+				{
+					const char32_t c1 = NextFolded(p1, s1.length(), i1);
+					const char32_t c2 = NextFolded(p2, s2.length(), i2);
+					if (c1 != c2)
+						return c1 < c2 ? -1 : 1;
+				}
+
+				return (int)(i1 < s1.length()) - (int)(i2 < s2.length());
+			}
+
+		}
+
+	}
+
+}
\ No newline at end of file
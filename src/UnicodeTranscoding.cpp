@@ -0,0 +1,345 @@
+#include <rlSystem/UnicodeTranscoding.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RLSYSTEM_TRANSCODE_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define RLSYSTEM_TRANSCODE_NEON
+#include <arm_neon.h>
+#endif
+
+
+
+namespace rlSystem
+{
+
+	namespace Unicode
+	{
+
+		namespace
+		{
+
+			constexpr char16_t cReplacement = 0xFFFD;
+
+			/// <summary>
+			/// Decode a non-ASCII UTF-8 sequence at <c>p[i]</c> and append it to <c>pDest</c>.
+			/// <para/>
+			/// Ill-formed sequences are replaced once per maximal subpart (Unicode 15, 3.9).
+			/// </summary>
+			/// <returns>Was the sequence valid?</returns>
+			inline bool DecodeUTF8(const uint8_t *p, size_t iLength, size_t &i, char16_t *pDest,
+				size_t &iDest) noexcept
+			{
+				const uint8_t c = p[i];
+
+				// the number of continuation bytes and the range of the first one.
+				unsigned iFollowing;
+				uint8_t  cMin = 0x80;
+				uint8_t  cMax = 0xBF;
+				if (c >= 0xC2 && c <= 0xDF)
+					iFollowing = 1;
+				else if (c >= 0xE0 && c <= 0xEF)
+				{
+					iFollowing = 2;
+					if (c == 0xE0)
+						cMin = 0xA0; // overlong
+					else if (c == 0xED)
+						cMax = 0x9F; // surrogates
+				}
+				else if (c >= 0xF0 && c <= 0xF4)
+				{
+					iFollowing = 3;
+					if (c == 0xF0)
+						cMin = 0x90; // overlong
+					else if (c == 0xF4)
+						cMax = 0x8F; // above U+10FFFF
+				}
+				else
+				{
+					// a continuation byte without a lead byte, or a byte that never occurs.
+					pDest[iDest++] = cReplacement;
+					++i;
+					return false;
+				}
+
+				uint32_t iCodePoint = c & (0x3F >> iFollowing);
+				size_t j = i + 1;
+				for (unsigned iByte = 0; iByte < iFollowing; ++iByte, ++j)
+				{
+					const uint8_t cNext = j < iLength ? p[j] : 0;
+					if (cNext < cMin || cNext > cMax)
+					{
+						// the bytes read so far are the maximal subpart.
+						pDest[iDest++] = cReplacement;
+						i = j;
+						return false;
+					}
+
+					iCodePoint = (iCodePoint << 6) | (cNext & 0x3F);
+					cMin = 0x80;
+					cMax = 0xBF;
+				}
+				i = j;
+
+				if (iCodePoint < 0x10000)
+					pDest[iDest++] = (char16_t)iCodePoint;
+				else
+				{
+					iCodePoint -= 0x10000;
+					pDest[iDest++] = (char16_t)(0xD800 + (iCodePoint >> 10));
+					pDest[iDest++] = (char16_t)(0xDC00 + (iCodePoint & 0x3FF));
+				}
+				return true;
+			}
+
+			/// <summary>
+			/// Encode a non-ASCII UTF-16 character at <c>p[i]</c> and append it to <c>pDest</c>.
+			/// </summary>
+			/// <returns>Was the character valid (i.e. not an unpaired surrogate)?</returns>
+			inline bool EncodeUTF8(const char16_t *p, size_t iLength, size_t &i, char8_t *pDest,
+				size_t &iDest) noexcept
+			{
+				uint32_t iCodePoint = p[i++];
+				bool bValid = true;
+
+				if (iCodePoint >= 0xD800 && iCodePoint <= 0xDFFF)
+				{
+					if (iCodePoint <= 0xDBFF && i < iLength && p[i] >= 0xDC00 && p[i] <= 0xDFFF)
+						iCodePoint = 0x10000 + ((iCodePoint - 0xD800) << 10) + (p[i++] - 0xDC00);
+					else
+					{
+						iCodePoint = cReplacement;
+						bValid     = false;
+					}
+				}
+
+				if (iCodePoint < 0x800)
+				{
+					pDest[iDest++] = (char8_t)(0xC0 | (iCodePoint >> 6));
+					pDest[iDest++] = (char8_t)(0x80 | (iCodePoint & 0x3F));
+				}
+				else if (iCodePoint < 0x10000)
+				{
+					pDest[iDest++] = (char8_t)(0xE0 | (iCodePoint >> 12));
+					pDest[iDest++] = (char8_t)(0x80 | ((iCodePoint >> 6) & 0x3F));
+					pDest[iDest++] = (char8_t)(0x80 | (iCodePoint & 0x3F));
+				}
+				else
+				{
+					pDest[iDest++] = (char8_t)(0xF0 | (iCodePoint >> 18));
+					pDest[iDest++] = (char8_t)(0x80 | ((iCodePoint >> 12) & 0x3F));
+					pDest[iDest++] = (char8_t)(0x80 | ((iCodePoint >> 6) & 0x3F));
+					pDest[iDest++] = (char8_t)(0x80 | (iCodePoint & 0x3F));
+				}
+				return bValid;
+			}
+
+			/// <summary>
+			/// Convert a block of 16 UTF-8 code units, as far as they're ASCII.<para/>
+			/// Always writes 16 code units to <c>pDest</c>; the ones after the ASCII prefix are
+			/// garbage and overwritten later. This is safe because the output never gets ahead of
+			/// the input.
+			/// </summary>
+			/// <returns>The length of the ASCII prefix.</returns>
+			inline size_t WidenASCII(const uint8_t *p, char16_t *pDest) noexcept
+			{
+#if defined(RLSYSTEM_TRANSCODE_SSE2)
+				const __m128i v     = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+				const __m128i vZero = _mm_setzero_si128();
+				const auto pDestV   = reinterpret_cast<__m128i *>(pDest);
+				_mm_storeu_si128(pDestV,     _mm_unpacklo_epi8(v, vZero));
+				_mm_storeu_si128(pDestV + 1, _mm_unpackhi_epi8(v, vZero));
+
+				const unsigned iMask = (unsigned)_mm_movemask_epi8(v); // the high bits
+				return iMask == 0 ? 16 : (size_t)std::countr_zero(iMask);
+#elif defined(RLSYSTEM_TRANSCODE_NEON)
+				const uint8x16_t v = vld1q_u8(p);
+				vst1q_u16(reinterpret_cast<uint16_t *>(pDest), vmovl_u8(vget_low_u8(v)));
+				vst1q_u16(reinterpret_cast<uint16_t *>(pDest + 8), vmovl_high_u8(v));
+
+				if (vmaxvq_u8(v) < 0x80)
+					return 16;
+				size_t i = 0;
+				while (p[i] < 0x80)
+					++i;
+				return i;
+#else
+				size_t i = 0;
+				for (; i < 16 && p[i] < 0x80; ++i)
+					pDest[i] = p[i];
+				return i;
+#endif
+			}
+
+			/// <summary>
+			/// Convert a block of 8 UTF-16 code units, as far as they're ASCII.<para/>
+			/// Always writes 8 code units to <c>pDest</c>, like <c>WidenASCII</c>.
+			/// </summary>
+			/// <returns>The length of the ASCII prefix.</returns>
+			inline size_t NarrowASCII(const char16_t *p, char8_t *pDest) noexcept
+			{
+#if defined(RLSYSTEM_TRANSCODE_SSE2)
+				const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+				_mm_storel_epi64(reinterpret_cast<__m128i *>(pDest), _mm_packus_epi16(v, v));
+
+				// 2 bits per code unit.
+				const __m128i vHigh  = _mm_and_si128(v, _mm_set1_epi16((short)0xFF80));
+				const __m128i vASCII = _mm_cmpeq_epi16(vHigh, _mm_setzero_si128());
+				const unsigned iMask = ~(unsigned)_mm_movemask_epi8(vASCII) & 0xFFFF;
+				return iMask == 0 ? 8 : (size_t)std::countr_zero(iMask) / 2;
+#elif defined(RLSYSTEM_TRANSCODE_NEON)
+				const uint16x8_t v = vld1q_u16(reinterpret_cast<const uint16_t *>(p));
+				vst1_u8(reinterpret_cast<uint8_t *>(pDest), vmovn_u16(v));
+
+				if (vmaxvq_u16(v) < 0x80)
+					return 8;
+				size_t i = 0;
+				while (p[i] < 0x80)
+					++i;
+				return i;
+#else
+				size_t i = 0;
+				for (; i < 8 && p[i] < 0x80; ++i)
+					pDest[i] = (char8_t)p[i];
+				return i;
+#endif
+			}
+
+		}
+
+
+
+		size_t UTF8ToUTF16(std::u8string_view sUTF8, char16_t *pDest, bool *pValid) noexcept
+		{
+			const auto p = reinterpret_cast<const uint8_t *>(sUTF8.data());
+			const size_t iLength = sUTF8.length();
+
+			bool bValid = true;
+			size_t i = 0;
+			size_t iDest = 0;
+			while (i < iLength)
+			{
+				// ASCII runs, a block at a time.
+				while (iLength - i >= 16)
+				{
+					const size_t iASCII = WidenASCII(p + i, pDest + iDest);
+					i     += iASCII;
+					iDest += iASCII;
+					if (iASCII < 16)
+						break;
+				}
+
+				// the rest of the block (or the end of the string).
+				const size_t iBlockEnd = std::min(i + 16, iLength);
+				while (i < iBlockEnd)
+				{
+					if (p[i] < 0x80)
+						pDest[iDest++] = p[i++];
+					else
+						bValid &= DecodeUTF8(p, iLength, i, pDest, iDest);
+				}
+			}
+
+			if (pValid)
+				*pValid = bValid;
+			return iDest;
+		}
+
+		size_t UTF16ToUTF8(std::u16string_view sUTF16, char8_t *pDest, bool *pValid) noexcept
+		{
+			const char16_t *p = sUTF16.data();
+			const size_t iLength = sUTF16.length();
+
+			bool bValid = true;
+			size_t i = 0;
+			size_t iDest = 0;
+			while (i < iLength)
+			{
+				while (iLength - i >= 8)
+				{
+					const size_t iASCII = NarrowASCII(p + i, pDest + iDest);
+					i     += iASCII;
+					iDest += iASCII;
+					if (iASCII < 8)
+						break;
+				}
+
+				const size_t iBlockEnd = std::min(i + 8, iLength);
+				while (i < iBlockEnd)
+				{
+					if (p[i] < 0x80)
+						pDest[iDest++] = (char8_t)p[i++];
+					else
+						bValid &= EncodeUTF8(p, iLength, i, pDest, iDest);
+				}
+			}
+
+			if (pValid)
+				*pValid = bValid;
+			return iDest;
+		}
+
+		std::u16string ToUTF16(std::u8string_view sUTF8)
+		{
+			std::u16string sResult(MaxUTF16Length(sUTF8.length()), 0);
+			sResult.resize(UTF8ToUTF16(sUTF8, sResult.data()));
+			return sResult;
+		}
+
+		std::u8string ToUTF8(std::u16string_view sUTF16)
+		{
+			std::u8string sResult(MaxUTF8Length(sUTF16.length()), 0);
+			sResult.resize(UTF16ToUTF8(sUTF16, sResult.data()));
+			return sResult;
+		}
+
+
+
+		namespace Reference
+		{
+
+			size_t UTF8ToUTF16(std::u8string_view sUTF8, char16_t *pDest, bool *pValid) noexcept
+			{
+				const auto p = reinterpret_cast<const uint8_t *>(sUTF8.data());
+
+				bool bValid = true;
+				size_t iDest = 0;
+				for (size_t i = 0; i < sUTF8.length();)
+				{
+					if (p[i] < 0x80)
+						pDest[iDest++] = p[i++];
+					else
+						bValid &= DecodeUTF8(p, sUTF8.length(), i, pDest, iDest);
+				}
+
+				if (pValid)
+					*pValid = bValid;
+				return iDest;
+			}
+
+			size_t UTF16ToUTF8(std::u16string_view sUTF16, char8_t *pDest, bool *pValid) noexcept
+			{
+				bool bValid = true;
+				size_t iDest = 0;
+				for (size_t i = 0; i < sUTF16.length();)
+				{
+					if (sUTF16[i] < 0x80)
+						pDest[iDest++] = (char8_t)sUTF16[i++];
+					else
+						bValid &= EncodeUTF8(sUTF16.data(), sUTF16.length(), i, pDest, iDest);
+				}
+
+				if (pValid)
+					*pValid = bValid;
+				return iDest;
+			}
+
+		}
+
+	}
+
+}
\ No newline at end of file
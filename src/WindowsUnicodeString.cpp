@@ -3,6 +3,7 @@
 #include <rlSystem/WindowsUnicodeString.hpp>
 
 #include <locale>
+#include <string_view>
 
 namespace
 {
@@ -23,79 +24,42 @@ namespace
 	};
 }
 
-#include "include/IncludeWindows.h"
-
 namespace rlSystem
 {
 
 	namespace String
 	{
 
+		// both are UTF-16 on Windows.
+		static_assert(sizeof(OSChar) == sizeof(char16_t));
+
 		OSString ToOS(const char8_t *szUTF8) noexcept
 		{
-			const int sizeOrig = (int)strlen(reinterpret_cast<const char *>(szUTF8)) + 1;
-
-			const auto len = MultiByteToWideChar(
-				CP_UTF8,                                // CodePage
-				MB_PRECOMPOSED,                         // dwFlags
-				reinterpret_cast<const char *>(szUTF8), // lpMultiByteStr
-				sizeOrig,                               // cbMultiByte
-				nullptr,                                // lpWideCharStr
-				0                                       // cchWideChar
-			);
-
-			if (len <= 1)
-				return OSString{};
-
-
-
-			OSString sResult((size_t)len - 1, 0);
-
-			MultiByteToWideChar(
-				CP_UTF8,                                // CodePage
-				MB_PRECOMPOSED,                         // dwFlags
-				reinterpret_cast<const char *>(szUTF8), // lpMultiByteStr
-				sizeOrig,                               // cbMultiByte
-				sResult.data(),                         // lpWideCharStr
-				(int)sResult.length() + 1               // cchWideChar
-			);
+			const std::u8string_view sUTF8(szUTF8);
 
+			// a single pass into a buffer of the maximum size.
+			OSString sResult(Unicode::MaxUTF16Length(sUTF8.length()), 0);
+			auto pDest = reinterpret_cast<char16_t *>(sResult.data());
+			sResult.resize(Unicode::UTF8ToUTF16(sUTF8, pDest));
 			return sResult;
 		}
 
-		std::u8string FromOS(const OSChar *szOS) noexcept
+		const OSChar *ToOS(const char8_t *szUTF8, OSBuffer &oBuffer) noexcept
 		{
-			const int sizeOrig = (int)wcslen(szOS) + 1;
-
-			const auto len = WideCharToMultiByte(
-				CP_UTF8,  // CodePage
-				0,        // dwFlags
-				szOS,     // lpWideCharStr
-				sizeOrig, // cchWideChar
-				nullptr,  // lpMultiByteStr
-				0,        // cbMultiByte
-				NULL,     // lpDefaultChar
-				NULL      // lpUsedDefaultChar
-			);
-
-			if (len <= 1)
-				return std::u8string{};
-
+			const std::u8string_view sUTF8(szUTF8);
 
+			auto pDest = reinterpret_cast<char16_t *>(oBuffer.reserve(
+				Unicode::MaxUTF16Length(sUTF8.length())));
+			oBuffer.setLength(Unicode::UTF8ToUTF16(sUTF8, pDest));
+			return oBuffer.c_str();
+		}
 
-			std::u8string sResult((size_t)len - 1, 0);
-
-			WideCharToMultiByte(
-				CP_UTF8,                                  // CodePage
-				0,                                        // dwFlags
-				szOS,                                     // lpWideCharStr
-				sizeOrig,                                 // cchWideChar
-				reinterpret_cast<char *>(sResult.data()), // lpMultiByteStr
-				(int)sResult.length() + 1,                // cbMultiByte
-				NULL,                                     // lpDefaultChar
-				NULL                                      // lpUsedDefaultChar
-			);
+		std::u8string FromOS(const OSChar *szOS) noexcept
+		{
+			const std::u16string_view sOS(reinterpret_cast<const char16_t *>(szOS));
 
+			std::u8string sResult(Unicode::MaxUTF8Length(sOS.length()), 0);
+			sResult.resize(Unicode::UTF16ToUTF8(sOS, sResult.data()));
 			return sResult;
 		}
 
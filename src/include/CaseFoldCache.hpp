@@ -0,0 +1,104 @@
+#ifndef RLSYSTEM_CASEFOLDCACHE
+#define RLSYSTEM_CASEFOLDCACHE
+
+#ifndef _WIN32
+
+
+
+
+
+#include <rlSystem/UnicodeCaseFolding.hpp>
+
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/stat.h>
+
+
+
+namespace rlSystem
+{
+
+	namespace Internal
+	{
+
+		/// <summary>
+		/// Case-insensitive name lookup for case-sensitive file systems.<para/>
+		/// For every directory that is queried, a table that maps the casefolded names of all
+		/// items to their actual names is built on first use. The table is kept in memory and
+		/// rebuilt once the directory's modification time changes.
+		/// </summary>
+		class CaseFoldCache final
+		{
+		public: // static methods
+
+			static CaseFoldCache &Instance();
+
+
+		public: // methods
+
+			/// <summary>Find the actual name of an item, ignoring the case.</summary>
+			/// <param name="sDir">The absolute path of the directory, with trailing delimiter.</param>
+			/// <param name="sName">The name of the item to look up.</param>
+			/// <param name="sResult">Receives the actual name of the item.</param>
+			/// <returns>
+			/// Was a matching item found?<para/>
+			/// If multiple items match, the one with the exact casing is preferred. Otherwise, the
+			/// (binary) smallest name is picked.
+			/// </returns>
+			bool Resolve(const std::u8string &sDir, std::u8string_view sName, std::u8string &sResult);
+
+			/// <summary>Drop all cached tables.</summary>
+			void Clear();
+
+
+		private: // types
+
+			struct DirTable
+			{
+				struct timespec tsModified;
+				struct timespec tsBuilt;
+				dev_t           iDevice;
+				ino_t           iInode;
+
+				// name (compared casefolded) --> actual names (sorted)
+				std::unordered_map<std::u8string, std::vector<std::u8string>,
+					Unicode::NoCaseHash, Unicode::NoCaseEqual> oItems;
+			};
+
+
+		private: // methods
+
+			CaseFoldCache() = default;
+
+			std::shared_ptr<const DirTable> Build(const std::u8string &sDir,
+				const struct stat &oStat);
+
+			/// <param name="bRebuildIfRecent">
+			/// Rebuild the table if it might be outdated despite an unchanged modification time.
+			/// </param>
+			std::shared_ptr<const DirTable> Get(const std::u8string &sDir, bool bRebuildIfRecent);
+
+
+		private: // variables
+
+			std::shared_mutex m_mux;
+			std::unordered_map<std::u8string, std::shared_ptr<const DirTable>> m_oDirs;
+
+		};
+
+	}
+
+}
+
+
+
+
+
+#endif // _WIN32
+
+#endif // RLSYSTEM_CASEFOLDCACHE
\ No newline at end of file
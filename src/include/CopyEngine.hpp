@@ -0,0 +1,129 @@
+#ifndef RLSYSTEM_COPYENGINE
+#define RLSYSTEM_COPYENGINE
+
+
+
+
+
+#include <rlSystem/FileSystem.hpp>
+
+#ifndef _WIN32
+#include <sys/types.h>
+#endif
+
+
+
+namespace rlSystem
+{
+
+	namespace Internal
+	{
+
+#ifndef _WIN32
+
+		/// <summary>
+		/// Keeps streamed data out of the page cache: the pages behind the cursor are dropped
+		/// (<c>posix_fadvise(POSIX_FADV_DONTNEED)</c>). For written data, the writeback is paced
+		/// with <c>sync_file_range</c>, since dirty pages can't be dropped.<para/>
+		/// The rest is dropped on destruction.
+		/// </summary>
+		class CacheDropper final
+		{
+		public: // static variables
+
+			/// <summary>The data is dropped in steps of this many bytes.</summary>
+			static constexpr off_t iWindow = 8 * 1024 * 1024;
+
+
+		public: // methods
+
+			/// <param name="iFDRead">The file that's read, or <c>-1</c>.</param>
+			/// <param name="iFDWrite">The file that's written, or <c>-1</c>.</param>
+			/// <param name="iOffset">The offset the I/O starts at.</param>
+			CacheDropper(int iFDRead, int iFDWrite, off_t iOffset) noexcept;
+			~CacheDropper();
+
+			CacheDropper(const CacheDropper &) = delete;
+			CacheDropper &operator=(const CacheDropper &) = delete;
+
+			/// <summary>Report that all data up to <c>iOffset</c> was processed.</summary>
+			void Advance(off_t iOffset) noexcept;
+
+
+		private: // variables
+
+			const int m_iFDRead;
+			const int m_iFDWrite;
+			off_t     m_iDropped; // written data before this offset was dropped
+			off_t     m_iMark;    // start of the current window
+			off_t     m_iCurrent;
+
+		};
+
+#endif
+
+		/// <summary>
+		/// Copy a single file, including its permissions, owner (if allowed) and timestamps.
+		/// <para/>
+		/// The data is streamed; it's never completely loaded into memory. On Linux, only the data
+		/// extents of sparse files are copied, so the copy has the same holes.
+		/// </summary>
+		/// <param name="szCopyFilePath">
+		/// The path of the copy. If a file already exists at this path, the function fails.
+		/// </param>
+		/// <returns>
+		/// Was the file copied successfully?<para/>
+		/// If not, a partially written copy is deleted.
+		/// </returns>
+		bool CopyFileWithMetadata(const char8_t *szOrigFilePath, const char8_t *szCopyFilePath,
+			const CopyOptions &oOptions);
+
+		/// <summary>
+		/// Is a file a complete copy created by <c>CopyFileWithMetadata</c>, i.e. do size and
+		/// modification time match?<para/>
+		/// The modification time is set after all data was written, so an incomplete copy never
+		/// passes this test.
+		/// </summary>
+		bool IsCompleteCopy(const char8_t *szOrigFilePath, const char8_t *szCopyFilePath);
+
+		/// <summary>Do two files have the same content?</summary>
+		bool SameContent(const char8_t *szFilePath1, const char8_t *szFilePath2);
+
+		/// <summary>Copy a directory tree, using multiple threads for the files.</summary>
+		/// <param name="szCopyDirPath">
+		/// The path of the copy.<para/>
+		/// If <c>bResume</c> is <c>false</c>, nothing may exist at this path yet.<para/>
+		/// May not be inside the original directory.
+		/// </param>
+		/// <param name="bResume">
+		/// Continue an interrupted copy: files that already were copied completely are kept,
+		/// items that no longer exist in the original are deleted. If <c>false</c>, a failed copy
+		/// is deleted again.
+		/// </param>
+		/// <returns>
+		/// Was the complete tree copied successfully? Fails if any subdirectory or item can't be
+		/// read.
+		/// </returns>
+		bool CopyTree(const char8_t *szOrigDirPath, const char8_t *szCopyDirPath,
+			const CopyOptions &oOptions, bool bResume);
+
+		/// <summary>
+		/// Move a file or directory. If the destination is on a different file system, the item is
+		/// copied, (optionally) verified and then deleted.
+		/// </summary>
+		/// <param name="bReplace">
+		/// May a directory be moved onto an existing item? That item is deleted right before the
+		/// complete copy is renamed to its path. (Other items always replace the destination.)
+		/// </param>
+		bool MoveItem(const char8_t *szOrigPath, const char8_t *szNewPath,
+			const CopyOptions &oOptions, bool bReplace = false);
+
+	}
+
+}
+
+
+
+
+
+#endif // RLSYSTEM_COPYENGINE
\ No newline at end of file
@@ -0,0 +1,105 @@
+#ifndef RLSYSTEM_DIRECTORYWALKER
+#define RLSYSTEM_DIRECTORYWALKER
+
+
+
+
+
+#include <rlSystem/FileSystem.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+
+
+namespace rlSystem
+{
+
+	namespace Internal
+	{
+
+		enum class WalkAction
+		{
+			Continue,     // go on; for directories: descend into it
+			SkipChildren, // go on, but don't descend into this directory
+			Stop          // end the walk
+		};
+
+		/// <summary>An item found by <c>Walk</c>. Only valid during the callback.</summary>
+		class WalkEntry final
+		{
+		public: // variables
+
+			std::u8string_view sPath;         // absolute path
+			std::u8string_view sRelativePath; // relative to the root directory
+			std::u8string_view sName;
+			unsigned           iType;         // one of Directory::ItemType
+			unsigned           iDepth;        // 0 = directly in the root directory
+			bool               bHidden;
+
+
+		public: // methods
+
+			/// <summary>
+			/// Make sure <c>iSize</c> and <c>tModified</c> are set.<para/>
+			/// On Windows, they're always known; elsewhere, the first call queries them.
+			/// </summary>
+			/// <returns>Are <c>iSize</c> and <c>tModified</c> valid?</returns>
+			bool FetchMetadata();
+
+			uint64_t            size()     const noexcept { return m_iSize; }
+			Directory::FileTime modified() const noexcept { return m_tModified; }
+
+
+		private: // variables
+
+			friend class WalkerImpl;
+
+			bool                m_bHasMetadata = false;
+			uint64_t            m_iSize        = 0;
+			Directory::FileTime m_tModified    = {};
+#ifndef _WIN32
+			int                 m_iDirFD       = -1;
+#endif
+
+		};
+
+		using WalkCallback = std::function<WalkAction(WalkEntry &oEntry)>;
+
+		/// <summary>
+		/// Walk a directory tree depth-first.<para/>
+		/// Symbolic links (and, on Windows, other reparse points) are reported as
+		/// <c>ItemType::Symlink</c> and never followed.<para/>
+		/// Subdirectories that can't be read are skipped silently, unless the walk is strict.
+		/// </summary>
+		/// <param name="szRoot">The directory to walk.</param>
+		/// <param name="iMaxDepth">
+		/// The maximum depth of reported items. Directories at this depth are not descended into.
+		/// </param>
+		/// <param name="bSorted">
+		/// Should the items of every directory be reported in (binary) order of their names?
+		/// <para/>
+		/// This requires reading a whole directory before reporting its first item.
+		/// </param>
+		/// <param name="fnCallback">Called for every item.</param>
+		/// <param name="bStrict">
+		/// Should the walk fail if a subdirectory or an item can't be read?<para/>
+		/// Use this if the walk has to see everything, e.g. before deleting the original tree.
+		/// </param>
+		/// <returns>
+		/// Could the root directory be read? For a strict walk: could the whole tree be read?
+		/// </returns>
+		bool Walk(const char8_t *szRoot, unsigned iMaxDepth, bool bSorted,
+			const WalkCallback &fnCallback, bool bStrict = false);
+
+	}
+
+}
+
+
+
+
+
+#endif // RLSYSTEM_DIRECTORYWALKER
\ No newline at end of file
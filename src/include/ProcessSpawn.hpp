@@ -0,0 +1,272 @@
+#ifndef RLSYSTEM_PROCESSSPAWN
+#define RLSYSTEM_PROCESSSPAWN
+
+
+
+
+
+#include <rlSystem/AppExecution.hpp>
+#include <rlSystem/Process.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+
+#ifdef _WIN32
+#include "IncludeWindows.h"
+#else
+#include <spawn.h>
+#include <sys/types.h>
+#endif
+
+
+
+namespace rlSystem
+{
+
+	namespace Internal
+	{
+
+		/// <summary>The size of the pipes used for capturing output.</summary>
+		constexpr size_t iPipeSize = 1024 * 1024;
+
+		/// <summary>The size of the buffer used for reading captured output.</summary>
+		constexpr size_t iReadBufferSize = 64 * 1024;
+
+		/// <summary>Collects the output of one stream of a child process.</summary>
+		class CaptureSink final
+		{
+		public: // methods
+
+			CaptureSink(std::string &sBuffer, const std::function<void(std::string_view)> &fn,
+				size_t iMaxSize) :
+				m_sBuffer(sBuffer), m_fn(fn), m_iMaxSize(iMaxSize) {}
+
+			void Write(const char *pData, size_t iSize);
+
+			bool truncated() const noexcept { return m_bTruncated; }
+
+
+		private: // variables
+
+			std::string                                 &m_sBuffer;
+			const std::function<void(std::string_view)> &m_fn;
+			const size_t                                 m_iMaxSize;
+			size_t                                       m_iWritten   = 0;
+			bool                                         m_bTruncated = false;
+
+		};
+
+		/// <summary>
+		/// The executable, arguments and environment of a child process, in the form the OS
+		/// expects.
+		/// </summary>
+		class Command final
+		{
+		public: // methods
+
+			/// <summary>
+			/// Take the arguments as a single string. On Linux, it's split like a POSIX shell
+			/// would; on Windows, it's passed unchanged.
+			/// </summary>
+			Command(const char8_t *szAppPath, const char8_t *szArgs);
+
+			/// <summary>Take the arguments as a list, so they need no quoting or splitting.</summary>
+			/// <param name="oEnvironment">
+			/// <c>NAME=value</c> entries. If empty, the environment of the current process is
+			/// inherited.
+			/// </param>
+			Command(const char8_t *szAppPath, std::span<const std::u8string_view> oArgs,
+				std::span<const std::u8string_view> oEnvironment);
+
+			Command(const Command &) = delete;
+			Command &operator=(const Command &) = delete;
+
+			const char8_t *appPath() const noexcept { return m_szAppPath; }
+
+#ifdef _WIN32
+			/// <summary>The command line. Modifiable, as <c>CreateProcessW</c> requires.</summary>
+			wchar_t *commandLine() noexcept { return m_sCommandLine.data(); }
+
+			/// <summary>
+			/// The environment block for <c>CREATE_UNICODE_ENVIRONMENT</c>, or <c>nullptr</c> to
+			/// inherit the environment.
+			/// </summary>
+			void *environment() noexcept
+			{
+				return m_sEnvironment.empty() ? nullptr : m_sEnvironment.data();
+			}
+#else
+			/// <summary>The <c>nullptr</c>-terminated argument vector.</summary>
+			char *const *argv() const noexcept { return m_pArgv; }
+
+			/// <summary>The <c>nullptr</c>-terminated environment (<c>environ</c> if inherited).</summary>
+			char *const *envp() const noexcept;
+#endif
+
+
+		private: // methods
+
+			void Init(std::span<const std::u8string_view> oArgs,
+				std::span<const std::u8string_view> oEnvironment);
+
+
+		private: // variables
+
+			const char8_t *m_szAppPath;
+
+#ifdef _WIN32
+			std::wstring m_sCommandLine;
+			std::wstring m_sEnvironment;
+#else
+			// a single allocation: the argv and envp pointers, followed by the strings.
+			std::unique_ptr<char *[]> m_up_Buffer;
+			char                    **m_pArgv = nullptr;
+			char                    **m_pEnvp = nullptr;
+#endif
+
+		};
+
+		/// <summary>Creates <c>Process</c> objects for started child processes.</summary>
+		struct ProcessAccess final
+		{
+#ifdef _WIN32
+			/// <summary>Take ownership of a process handle.</summary>
+			static Process Adopt(HANDLE hProcess, std::chrono::steady_clock::time_point tpStart);
+#else
+			/// <summary>Take responsibility for waiting for a child process.</summary>
+			static Process Adopt(pid_t pid, std::chrono::steady_clock::time_point tpStart);
+#endif
+		};
+
+#ifndef _WIN32
+
+		/// <summary>
+		/// Convert a status returned by <c>waitpid</c> to an exit code.<para/>
+		/// If the process was terminated by a signal, the exit code is 128 + the signal number,
+		/// like in shells.
+		/// </summary>
+		int DecodeWaitStatus(int iStatus) noexcept;
+
+		/// <summary>Reap a child process that has ended.</summary>
+		/// <param name="bBlock">Wait until the process has ended?</param>
+		/// <param name="iExitCode">
+		/// Receives the exit code (see <c>DecodeWaitStatus</c>), or -1 on error.
+		/// </param>
+		/// <param name="pUsage">
+		/// If this value is not <c>nullptr</c>, it receives the resources used by the process
+		/// (except for the wall time).
+		/// </param>
+		/// <returns>Has the process ended (or can't be waited for)?</returns>
+		bool ReapChild(pid_t pid, bool bBlock, int &iExitCode, ResourceUsage *pUsage) noexcept;
+
+		/// <summary>Wait for a child process to end.</summary>
+		/// <param name="pUsage">See <c>ReapChild</c>.</param>
+		/// <returns>The exit code (see <c>DecodeWaitStatus</c>), or -1 on error.</returns>
+		int WaitForChild(pid_t pid, ResourceUsage *pUsage = nullptr) noexcept;
+
+		/// <summary>
+		/// Reap a child process in the background when it ends, without blocking the caller.
+		/// <para/>
+		/// All such processes are served by a single thread.
+		/// </summary>
+		/// <param name="iPidFD">A pidfd of the process, which is closed, or -1.</param>
+		void ReapLater(pid_t pid, int iPidFD = -1) noexcept;
+
+		/// <summary>Start a child process.</summary>
+		/// <param name="oActions">
+		/// The file actions for the child (e.g. redirections). Relative paths are resolved
+		/// before changing to <c>szCurrentDir</c>.
+		/// </param>
+		bool SpawnChild(
+			const Command                    &oCommand,
+			const char8_t                    *szCurrentDir,
+			      posix_spawn_file_actions_t &oActions,
+			      pid_t                      &pid
+		);
+
+		enum class RemoteResult
+		{
+			Started,
+			Failed,     // the spawn server couldn't start the process
+			Unavailable // the spawn server isn't running; start the process directly
+		};
+
+		/// <summary>A process started by the spawn server.</summary>
+		struct RemoteChild
+		{
+			int   iReplyFD = -1; // receives the exit status
+			pid_t pid      = 0;
+		};
+
+		/// <summary>Start a child process via the spawn server.</summary>
+		/// <param name="iFDIn">The file descriptor that becomes <c>stdin</c> of the child.</param>
+		/// <param name="iFDOut">The file descriptor that becomes <c>stdout</c> of the child.</param>
+		/// <param name="iFDErr">The file descriptor that becomes <c>stderr</c> of the child.</param>
+		RemoteResult SpawnRemote(const Command &oCommand, const char8_t *szCurrentDir,
+			int iFDIn, int iFDOut, int iFDErr, RemoteChild &oChild);
+
+		/// <summary>Wait for a child process started via <c>SpawnRemote</c> to end.</summary>
+		/// <param name="pUsage">See <c>ReapChild</c>.</param>
+		/// <returns>The exit code (see <c>DecodeWaitStatus</c>), or -1 on error.</returns>
+		int WaitRemote(RemoteChild &oChild, ResourceUsage *pUsage = nullptr) noexcept;
+
+		/// <summary>
+		/// Read from pipes until all of them are closed by the writing side.<para/>
+		/// The pipes are read alternately as data becomes available, so a writer is never blocked
+		/// because another pipe is full. Closes the file descriptors.
+		/// </summary>
+		/// <param name="iInputFD">
+		/// The writing side of the <c>stdin</c> pipe of the child, or -1. <c>sInput</c> is written
+		/// to it while the other pipes are read, then it's closed. Made non-blocking.
+		/// </param>
+		void DrainPipes(const int *pFDs, CaptureSink *const *pSinks, size_t iCount,
+			int iInputFD = -1, std::string_view sInput = {});
+
+#else
+
+		/// <summary>Start a child process.</summary>
+		bool StartProcess(
+			      Command             &oCommand,
+			const char8_t             *szCurrentDir,
+			      DWORD                dwCreationFlags,
+			      STARTUPINFOW        &si,
+			      PROCESS_INFORMATION &pi
+		);
+
+		/// <summary>Wait for a process to end.</summary>
+		/// <param name="pUsage">
+		/// If this value is not <c>nullptr</c>, it receives the resources used by the process
+		/// (except for the wall time).
+		/// </param>
+		/// <returns>The exit code, or 0 if it can't be determined.</returns>
+		int WaitForProcess(HANDLE hProcess, ResourceUsage *pUsage = nullptr) noexcept;
+
+		/// <summary>Read from a pipe until it's closed by the writing side.</summary>
+		void DrainPipe(HANDLE hPipe, CaptureSink &oSink);
+
+		/// <summary>
+		/// Write data to a pipe, then close it. Stops early if the reading side is closed.
+		/// </summary>
+		void FillPipe(HANDLE hPipe, std::string_view sData) noexcept;
+
+		/// <summary>
+		/// Get the resources used by a process that has ended (except for the wall time).
+		/// </summary>
+		void QueryUsage(HANDLE hProcess, ResourceUsage &oUsage) noexcept;
+
+#endif
+
+	}
+
+}
+
+
+
+
+
+#endif // RLSYSTEM_PROCESSSPAWN
\ No newline at end of file
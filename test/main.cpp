@@ -1,5 +1,26 @@
 #include <rlSystem/AppExecution.hpp>
+#include <rlSystem/DirectoryHandle.hpp>
+#include <rlSystem/ExclusionRules.hpp>
 #include <rlSystem/FileSystem.hpp>
+#include <rlSystem/Pipeline.hpp>
+#include <rlSystem/Prefetcher.hpp>
+#include <rlSystem/ProcessBatch.hpp>
+#include <rlSystem/TempFile.hpp>
+#include <rlSystem/UnicodeCaseFolding.hpp>
+#include <rlSystem/UnicodeTranscoding.hpp>
+
+#include <algorithm>
+#include <unordered_map>
+
+#ifndef _WIN32
+#include <csignal>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 int main(int argc, char* argv[])
 {
@@ -17,6 +38,166 @@ int main(int argc, char* argv[])
 	printf("Current directory: \"%s\"\n\n",
 		reinterpret_cast<const char *>(rlSystem::Path::CurrentDirectory().c_str()));
 
+	printf("Trying to convert between UTF-8 and UTF-16...\n");
+	{
+		namespace Unicode = rlSystem::Unicode;
+
+		// long enough for the vectorized ASCII blocks.
+		const std::u8string  s8  =
+			u8"C:/Users/Stra\u00DFe/\u20AC/\U0001D11E/0123456789abcdef\u00E4.txt";
+		const std::u16string s16 =
+			u"C:/Users/Stra\u00DFe/\u20AC/\U0001D11E/0123456789abcdef\u00E4.txt";
+		bool bValid = false;
+		char16_t sz16[64];
+		bool bOK = Unicode::ToUTF16(s8) == s16 && Unicode::ToUTF8(s16) == s8 &&
+			Unicode::UTF8ToUTF16(s8, sz16, &bValid) == s16.length() && bValid;
+
+		// ill-formed input: one U+FFFD per maximal subpart/unpaired surrogate.
+		const std::u8string sInvalid = { 0xC3, u8'a', 0xE0, 0x80, 0x80, 0xF0, 0x9F, 0x98,
+			0xED, 0xA0, 0x80, 0xFF };
+		bOK = bOK && Unicode::UTF8ToUTF16(sInvalid, sz16, &bValid) == 10 && !bValid &&
+			std::u16string_view(sz16, 10) ==
+				u"\uFFFDa\uFFFD\uFFFD\uFFFD\uFFFD\uFFFD\uFFFD\uFFFD\uFFFD";
+		const std::u16string sUnpaired = { u'a', 0xD800, u'b', 0xDC00 };
+		bOK = bOK && Unicode::ToUTF8(sUnpaired) == u8"a\uFFFDb\uFFFD";
+
+		// short strings are converted into the inline buffer, long ones spill to the heap.
+		Unicode::InlineString<char16_t> oInline;
+		const std::u8string sLong(600, u8'x');
+		bOK = bOK && std::u16string_view(Unicode::ToUTF16(s8, oInline)) == s16 &&
+			oInline.isInline() && oInline.length() == s16.length();
+		bOK = bOK && Unicode::ToUTF16(sLong, oInline) == std::u16string(600, u'x') &&
+			!oInline.isInline();
+		bOK = bOK && Unicode::ToUTF16(u8"", oInline)[0] == 0 && oInline.isInline();
+
+		Unicode::InlineString<char8_t, 16> oInline8;
+		bOK = bOK && Unicode::ToUTF8(u"\u00E4bc", oInline8) == std::u8string(u8"\u00E4bc") &&
+			oInline8.isInline() && Unicode::ToUTF8(s16, oInline8) == s8 && !oInline8.isInline();
+
+		// the vectorized code agrees with the reference for random input.
+		uint32_t iRandom = 12345;
+		const auto fnRandom = [&]
+		{
+			iRandom ^= iRandom << 13;
+			iRandom ^= iRandom >> 17;
+			iRandom ^= iRandom << 5;
+			return iRandom;
+		};
+		std::u16string s16Result(200, 0), s16Reference(200, 0);
+		std::u8string s8Result(600, 0), s8Reference(600, 0);
+		for (int iRound = 0; bOK && iRound < 5000; ++iRound)
+		{
+			std::u8string sBytes(fnRandom() % 100, 0);
+			std::u16string sUnits(fnRandom() % 100, 0);
+			for (auto &c : sBytes)
+				c = (char8_t)(fnRandom() % 8 ? fnRandom() % 0x80 : fnRandom() % 0x100);
+			for (auto &c : sUnits)
+				c = (char16_t)(fnRandom() % 8 ? fnRandom() % 0x80 : fnRandom() % 0x10000);
+
+			bool bValidResult = false, bValidReference = true;
+			const size_t i16 = Unicode::UTF8ToUTF16(sBytes, s16Result.data(), &bValidResult);
+			bOK = i16 == Unicode::Reference::UTF8ToUTF16(sBytes, s16Reference.data(),
+				&bValidReference) && bValidResult == bValidReference &&
+				s16Result.compare(0, i16, s16Reference, 0, i16) == 0;
+
+			const size_t i8 = Unicode::UTF16ToUTF8(sUnits, s8Result.data(), &bValidResult);
+			bOK = bOK && i8 == Unicode::Reference::UTF16ToUTF8(sUnits, s8Reference.data(),
+				&bValidReference) && bValidResult == bValidReference &&
+				s8Result.compare(0, i8, s8Reference, 0, i8) == 0;
+		}
+
+		if (!bOK)
+		{
+			printf("  FAIL.\n\n");
+			return 1;
+		}
+		else
+			printf("  SUCCESS.\n\n");
+	}
+
+	printf("Trying to compare strings case-insensitively...\n");
+	{
+		namespace Unicode = rlSystem::Unicode;
+
+		// simple case folding: one code point each, but not always the same length in UTF-8.
+		bool bOK = Unicode::FoldCase(u8"Stra\u1E9Ee/\u00C4\u00D6\u00DC/\u212A/\u023A/\u0130") ==
+			u8"stra\u00DFe/\u00E4\u00F6\u00FC/k/\u2C65/\u0130" &&
+			Unicode::FoldCase(U'\u03A3') == U'\u03C3' && Unicode::FoldCase(U'\u03C2') == U'\u03C3';
+
+		const std::u8string sPath  = u8"C:/Program Files/Common Files/\u00C4rger/Setup.EXE";
+		const std::u8string sOther = u8"c:/PROGRAM FILES/common files/\u00E4RGER/setup.exe";
+		bOK = bOK && Unicode::EqualNoCase(sPath, sOther) &&
+			Unicode::HashNoCase(sPath) == Unicode::HashNoCase(sOther) &&
+			!Unicode::EqualNoCase(sPath, u8"C:/Program Files/Common Files/\u00C4rger/Setup.EX") &&
+			Unicode::CompareNoCase(u8"abc/DEF", u8"ABC/deg") < 0 &&
+			Unicode::CompareNoCase(u8"abc/\u00E4", u8"ABC/Z") > 0 &&
+			Unicode::CompareNoCase(u8"abc", u8"ABCD") < 0 &&
+			Unicode::StartsWithNoCase(sPath, u8"c:/program files/COMMON") &&
+			!Unicode::StartsWithNoCase(u8"c:/program", sPath);
+
+		// hashed in chunks: equal strings of different lengths must still get the same hash.
+		std::u8string sKelvin, sK;
+		for (int i = 0; i < 300; ++i)
+		{
+			sKelvin += i % 7 ? u8"\u212A" : u8"ab";
+			sK      += i % 7 ? u8"k" : u8"AB";
+		}
+		bOK = bOK && Unicode::EqualNoCase(sKelvin, sK) &&
+			Unicode::HashNoCase(sKelvin) == Unicode::HashNoCase(sK);
+
+		std::unordered_map<std::u8string, int, Unicode::NoCaseHash, Unicode::NoCaseEqual> oMap;
+		oMap[sPath] = 1;
+		bOK = bOK && oMap.find(std::u8string_view(sOther)) != oMap.end() && oMap.size() == 1;
+
+		// the vectorized code agrees with the reference for random input, including invalid
+		// bytes and characters that change their length when folded.
+		const std::u8string_view oPieces[] = { u8"a", u8"B", u8"z", u8"Z", u8"/", u8"\u00C4",
+			u8"\u00E4", u8"\u212A", u8"k", u8"\u023A", u8"\u2C65", u8"\U00010400",
+			u8"\U00010428", u8"\u0130", u8"\xC3", u8"\xFF" };
+		uint32_t iRandom = 4711;
+		const auto fnRandom = [&]
+		{
+			iRandom ^= iRandom << 13;
+			iRandom ^= iRandom >> 17;
+			iRandom ^= iRandom << 5;
+			return iRandom;
+		};
+		const auto fnString = [&]
+		{
+			std::u8string s;
+			const size_t iPieces = fnRandom() % 60;
+			for (size_t i = 0; i < iPieces; ++i)
+				s += oPieces[fnRandom() % 8 ? fnRandom() % 5 : fnRandom() % std::size(oPieces)];
+			return s;
+		};
+		std::u8string sResult(200, 0), sReference(200, 0);
+		for (int iRound = 0; bOK && iRound < 5000; ++iRound)
+		{
+			const auto s1 = fnString();
+			const auto s2 = iRound % 2 ? fnString() : Unicode::FoldCase(s1);
+
+			const size_t iLength = Unicode::FoldCase(s1, sResult.data());
+			bOK = iLength == Unicode::Reference::FoldCase(s1, sReference.data()) &&
+				sResult.compare(0, iLength, sReference, 0, iLength) == 0;
+
+			const int iCompare = Unicode::CompareNoCase(s1, s2);
+			bOK = bOK && (iCompare > 0) - (iCompare < 0) ==
+				Unicode::Reference::CompareNoCase(s1, s2) &&
+				Unicode::EqualNoCase(s1, s2) == (iCompare == 0) &&
+				(iCompare != 0 || Unicode::HashNoCase(s1) == Unicode::HashNoCase(s2)) &&
+				Unicode::StartsWithNoCase(Unicode::FoldCase(s1) + s2, s1) &&
+				(!Unicode::StartsWithNoCase(s1, s2) || Unicode::CompareNoCase(s1, s2) >= 0);
+		}
+
+		if (!bOK)
+		{
+			printf("  FAIL.\n\n");
+			return 1;
+		}
+		else
+			printf("  SUCCESS.\n\n");
+	}
+
 	constexpr char8_t szTestDir[] = u8"testdir";
 
 	printf("Trying to create \"%s\"\n", reinterpret_cast<const char *>(szTestDir));
@@ -61,6 +242,809 @@ int main(int argc, char* argv[])
 	printf("Current directory: \"%s\"\n\n",
 		reinterpret_cast<const char *>(rlSystem::Path::CurrentDirectory().c_str()));
 
+	printf("Trying to get the actual casing of a path...\n");
+	if (!rlSystem::Directory::Create(u8"testdir/MixedCase") ||
+		!rlSystem::Path::GetCased(u8"testdir/mIXEDcASE").ends_with(u8"MixedCase"))
+	{
+		printf("  FAIL.\n\n");
+		return 1;
+	}
+	else
+		printf("  SUCCESS.\n\n");
+
+	printf("Trying to find directories by a case-insensitive name...\n");
+	if (!rlSystem::Directory::Create(u8"testdir/\u00C4rger") ||
+		!rlSystem::Path::GetCased(u8"testdir/\u00E4RGER").ends_with(u8"\u00C4rger") ||
+		rlSystem::Directory::GetDirectories(u8"testdir", u8"mixedCASE", false, false).size() != 1 ||
+		rlSystem::Directory::GetDirectories(u8"testdir", u8".*case", false, false).size() != 1 ||
+		rlSystem::Directory::GetDirectories(u8"testdir", u8"\u00E4r.*", false, false).size() != 1 ||
+		rlSystem::Directory::GetDirectories(u8"testdir", u8"mixedCASE", true, false).size() != 0 ||
+		rlSystem::Directory::GetDirectories(u8"testdir", u8"MIXED\\w+", false, false).size() != 1 ||
+		rlSystem::Directory::GetDirectories(u8"testdir", u8"\u00E4[r].*", false, false).size() != 1 ||
+		rlSystem::Directory::GetDirectories(u8"testdir", u8"\u00E4rger|x", false, false).size() != 1 ||
+		rlSystem::Directory::GetDirectories(u8"testdir", u8"\u00C4R[G]ER", false, false).size() != 1 ||
+		!rlSystem::Directory::Delete(u8"testdir/\u00C4rger"))
+	{
+		printf("  FAIL.\n\n");
+		return 1;
+	}
+	else
+		printf("  SUCCESS.\n\n");
+
+	printf("Trying to enumerate the subdirectories of \"%s\"...\n",
+		reinterpret_cast<const char *>(szTestDir));
+	{
+		rlSystem::Directory::Filter oFilter;
+		oFilter.iTypes    = rlSystem::Directory::ItemType::Directory;
+		oFilter.iMaxDepth = 0;
+		if (rlSystem::Directory::Enumerate(szTestDir, oFilter).size() != 2)
+		{
+			printf("  FAIL.\n\n");
+			return 1;
+		}
+		else
+			printf("  SUCCESS.\n\n");
+	}
+
+	printf("Trying to exclude subtrees by .gitignore-style rules...\n");
+	{
+		const auto fnWriteFile = [](const char *szPath, const char *szText)
+		{
+			FILE *pFile = fopen(szPath, "wb");
+			if (!pFile)
+				return false;
+			fputs(szText, pFile);
+			fclose(pFile);
+			return true;
+		};
+
+		rlSystem::ExclusionRules oRules;
+		oRules.AddRules(u8"# build output\n.git/\nnode_modules/\n/build/\n*.o\n!keep.o\n");
+
+		rlSystem::ExclusionRules oGlobs(false);
+		oGlobs.AddRules(u8"NODE_MODULES/\nlogs/**/*.LOG\n\\#*\n/doc/[a-c]?.txt\n");
+
+		rlSystem::Directory::Filter oFilter;
+		oFilter.iTypes          = rlSystem::Directory::ItemType::File |
+			rlSystem::Directory::ItemType::Directory;
+		oFilter.pExclusions     = &oRules;
+		oFilter.sIgnoreFileName = u8".gitignore";
+
+		std::vector<std::u8string> oFound;
+		const bool bOK =
+			rlSystem::Directory::Create(u8"testdir/Ignore/.git/objects") &&
+			rlSystem::Directory::Create(u8"testdir/Ignore/node_modules/pkg") &&
+			rlSystem::Directory::Create(u8"testdir/Ignore/build") &&
+			rlSystem::Directory::Create(u8"testdir/Ignore/src/build") &&
+			fnWriteFile("testdir/Ignore/.git/objects/data", "") &&
+			fnWriteFile("testdir/Ignore/node_modules/pkg/index.js", "") &&
+			fnWriteFile("testdir/Ignore/build/out.txt", "") &&
+			fnWriteFile("testdir/Ignore/readme.md", "") &&
+			fnWriteFile("testdir/Ignore/src/main.cpp", "") &&
+			fnWriteFile("testdir/Ignore/src/main.o", "") &&
+			fnWriteFile("testdir/Ignore/src/keep.o", "") &&
+			fnWriteFile("testdir/Ignore/src/.gitignore", "gen.cpp\n/main.cpp\n") &&
+			fnWriteFile("testdir/Ignore/src/build/gen.cpp", "") &&
+			fnWriteFile("testdir/Ignore/src/build/main.cpp", "") &&
+			rlSystem::Directory::Enumerate(u8"testdir/Ignore", oFilter,
+				[&](const rlSystem::Directory::Item &oItem)
+				{
+					auto sPath = oItem.sPath.substr(oItem.sPath.find(u8"Ignore") + 7);
+					std::replace(sPath.begin(), sPath.end(), u8'\\', u8'/');
+					oFound.push_back(std::move(sPath));
+					return true;
+				});
+		std::sort(oFound.begin(), oFound.end());
+
+		const std::vector<std::u8string> oExpected = { u8"readme.md", u8"src",
+			u8"src/.gitignore", u8"src/build", u8"src/build/main.cpp", u8"src/keep.o" };
+
+		if (!bOK || oFound != oExpected ||
+			!oGlobs.IsExcluded(u8"a/Node_Modules", true) ||
+			oGlobs.IsExcluded(u8"a/node_modules", false) ||
+			!oGlobs.IsExcluded(u8"logs/x.log", false) ||
+			!oGlobs.IsExcluded(u8"logs/a/b/X.Log", false) ||
+			oGlobs.IsExcluded(u8"src/logs/x.log", false) ||
+			!oGlobs.IsExcluded(u8"#autosave#", false) ||
+			!oGlobs.IsExcluded(u8"doc/b1.txt", false) ||
+			oGlobs.IsExcluded(u8"doc/d1.txt", false) ||
+			oGlobs.IsExcluded(u8"src/doc/b1.txt", false) ||
+			oRules.Check(u8"src/keep.o", false) != rlSystem::ExclusionRules::Result::Included ||
+			!rlSystem::Directory::Delete(u8"testdir/Ignore"))
+		{
+			printf("  FAIL.\n\n");
+			return 1;
+		}
+		else
+			printf("  SUCCESS.\n\n");
+	}
+
+	printf("Trying to move a directory tree...\n");
+	{
+		rlSystem::CopyOptions oOptions;
+		oOptions.bVerify = true;
+
+		FILE *pFile = nullptr;
+		if (rlSystem::Directory::Create(u8"testdir/MoveMe/Sub"))
+			pFile = fopen("testdir/MoveMe/Sub/data.txt", "wb");
+		if (pFile)
+		{
+			fputs("Hello Move()!", pFile);
+			fclose(pFile);
+		}
+
+		if (!pFile ||
+			!rlSystem::Directory::Move(u8"testdir/MoveMe", u8"testdir/Moved", oOptions) ||
+			rlSystem::Directory::Exists(u8"testdir/MoveMe") ||
+			rlSystem::File::GetSize(u8"testdir/Moved/Sub/data.txt") != 13)
+		{
+			printf("  FAIL.\n\n");
+			return 1;
+		}
+		else
+			printf("  SUCCESS.\n\n");
+	}
+
+#ifndef _WIN32
+	printf("Trying to move a partly unreadable tree to another file system...\n");
+	{
+		// in a child process, as root can read everything.
+		const pid_t iPid = fork();
+		if (iPid == 0)
+		{
+			if (geteuid() == 0 && (setgid(65534) != 0 || setuid(65534) != 0))
+				_exit(2);
+
+			char szOrig[] = "/tmp/rlSystemTest.XXXXXX";
+			char szDest[] = "/dev/shm/rlSystemTest.XXXXXX";
+			struct stat oOrigStat, oDestStat;
+			if (!mkdtemp(szOrig))
+				_exit(2);
+			if (!mkdtemp(szDest) || stat(szOrig, &oOrigStat) != 0 ||
+				stat(szDest, &oDestStat) != 0 || oOrigStat.st_dev == oDestStat.st_dev)
+			{
+				rmdir(szOrig);
+				_exit(3);
+			}
+
+			const auto sTree   = std::u8string(reinterpret_cast<const char8_t *>(szOrig)) +
+				u8"/Tree";
+			const auto sMoved  = std::u8string(reinterpret_cast<const char8_t *>(szDest)) +
+				u8"/Tree";
+			const auto sLocked = sTree + u8"/Locked";
+
+			FILE *pFile = nullptr;
+			if (rlSystem::Directory::Create((sTree + u8"/Sub").c_str()) &&
+				rlSystem::Directory::Create(sLocked.c_str()))
+				pFile = fopen(reinterpret_cast<const char *>((sTree + u8"/Sub/data.txt").c_str()),
+					"wb");
+			if (pFile)
+				fclose(pFile);
+
+			const bool bOK = pFile &&
+				chmod(reinterpret_cast<const char *>(sLocked.c_str()), 0) == 0 &&
+				!rlSystem::Directory::Move(sTree.c_str(), sMoved.c_str()) &&
+				rlSystem::File::Exists((sTree + u8"/Sub/data.txt").c_str()) &&
+				rlSystem::Directory::Exists(sLocked.c_str());
+
+			chmod(reinterpret_cast<const char *>(sLocked.c_str()), 0700);
+			rlSystem::Directory::Delete(reinterpret_cast<const char8_t *>(szOrig));
+			rlSystem::Directory::Delete(reinterpret_cast<const char8_t *>(szDest));
+			_exit(bOK ? 0 : 1);
+		}
+
+		int iStatus = 0;
+		if (iPid < 0 || waitpid(iPid, &iStatus, 0) != iPid || !WIFEXITED(iStatus) ||
+			(WEXITSTATUS(iStatus) != 0 && WEXITSTATUS(iStatus) != 3))
+		{
+			printf("  FAIL.\n\n");
+			return 1;
+		}
+		else if (WEXITSTATUS(iStatus) == 3)
+			printf("  SKIPPED (/tmp and /dev/shm are on the same file system).\n\n");
+		else
+			printf("  SUCCESS.\n\n");
+	}
+
+	printf("Trying to resume an interrupted move to another file system...\n");
+	{
+		char szOrig[] = "/tmp/rlSystemTest.XXXXXX";
+		char szDest[] = "/dev/shm/rlSystemTest.XXXXXX";
+		struct stat oOrigStat, oDestStat;
+		bool bOK = mkdtemp(szOrig) && mkdtemp(szDest) &&
+			stat(szOrig, &oOrigStat) == 0 && stat(szDest, &oDestStat) == 0;
+		const bool bSkipped = bOK && oOrigStat.st_dev == oDestStat.st_dev;
+
+		const auto sTree    = std::u8string(reinterpret_cast<const char8_t *>(szOrig)) + u8"/Tree";
+		const auto sMoved   = std::u8string(reinterpret_cast<const char8_t *>(szDest)) + u8"/Tree";
+		// what an interrupted attempt left, before "Deleted.txt" and "Gone" were deleted from
+		// the original.
+		const auto sStaging = sMoved + u8".rlSystem-move";
+
+		if (!bSkipped)
+		{
+			bOK = bOK &&
+				rlSystem::Directory::Create((sTree + u8"/Sub").c_str()) &&
+				rlSystem::Directory::Create((sStaging + u8"/Sub").c_str()) &&
+				rlSystem::Directory::Create((sStaging + u8"/Gone/Deeper").c_str());
+			for (const auto &sFile : { sTree + u8"/Sub/data.txt", sStaging + u8"/Sub/data.txt",
+				sStaging + u8"/Sub/Deleted.txt", sStaging + u8"/Gone/Deeper/data.txt" })
+			{
+				FILE *pFile = bOK ? fopen(reinterpret_cast<const char *>(sFile.c_str()), "wb") :
+					nullptr;
+				if (!pFile)
+				{
+					bOK = false;
+					break;
+				}
+				fputs(sFile.starts_with(sTree) ? "Hello Move()!" : "Hello", pFile);
+				fclose(pFile);
+			}
+
+			bOK = bOK &&
+				rlSystem::Directory::Move(sTree.c_str(), sMoved.c_str()) &&
+				!rlSystem::Directory::Exists(sTree.c_str()) &&
+				!rlSystem::Directory::Exists(sStaging.c_str()) &&
+				rlSystem::File::GetSize((sMoved + u8"/Sub/data.txt").c_str()) == 13 &&
+				!rlSystem::File::Exists((sMoved + u8"/Sub/Deleted.txt").c_str()) &&
+				!rlSystem::Directory::Exists((sMoved + u8"/Gone").c_str());
+		}
+
+		rlSystem::Directory::Delete(reinterpret_cast<const char8_t *>(szOrig));
+		rlSystem::Directory::Delete(reinterpret_cast<const char8_t *>(szDest));
+
+		if (!bOK)
+		{
+			printf("  FAIL.\n\n");
+			return 1;
+		}
+		else if (bSkipped)
+			printf("  SKIPPED (/tmp and /dev/shm are on the same file system).\n\n");
+		else
+			printf("  SUCCESS.\n\n");
+	}
+#endif
+
+	printf("Trying to copy a directory tree without polluting the cache...\n");
+	{
+		rlSystem::CopyOptions oOptions;
+		oOptions.bNoCache = true;
+
+		size_t iRead = 0;
+		if (!rlSystem::Directory::CopyTree(u8"testdir/Moved", u8"testdir/MovedCopy", oOptions) ||
+			!rlSystem::File::Read(u8"testdir/MovedCopy/Sub/data.txt",
+				[&](const void *, size_t iSize) { iRead += iSize; return true; }, true) ||
+			iRead != 13 ||
+			!rlSystem::Directory::Delete(u8"testdir/MovedCopy"))
+		{
+			printf("  FAIL.\n\n");
+			return 1;
+		}
+		else
+			printf("  SUCCESS.\n\n");
+	}
+
+	printf("Trying to copy a directory tree into itself...\n");
+	{
+		if (rlSystem::Directory::CopyTree(u8"testdir/Moved", u8"testdir/Moved/Sub/Copy") ||
+			rlSystem::Directory::Exists(u8"testdir/Moved/Sub/Copy"))
+		{
+			printf("  FAIL.\n\n");
+			return 1;
+		}
+		else
+			printf("  SUCCESS.\n\n");
+	}
+
+	printf("Trying to work relative to a directory handle...\n");
+	{
+		rlSystem::Directory::Handle oDir(szTestDir);
+		const auto oSubdir = oDir.Open(u8"Moved");
+
+		FILE *pFile = nullptr;
+		if (oSubdir && oSubdir.Create(u8"HandleDir"))
+			pFile = oSubdir.OpenFile(u8"HandleDir/new.txt", "wx");
+		if (pFile)
+		{
+			fputs("Handle", pFile);
+			fclose(pFile);
+		}
+
+		size_t iItems = 0;
+		if (!pFile ||
+			oSubdir.OpenFile(u8"HandleDir/new.txt", "wx") != nullptr ||
+			!oSubdir.Move(u8"HandleDir/new.txt", u8"renamed.txt", false) ||
+			oSubdir.GetSize(u8"renamed.txt") != 6 ||
+			!oSubdir.Exists(u8"HandleDir", rlSystem::Directory::ItemType::Directory) ||
+			oSubdir.Exists(u8"HandleDir", rlSystem::Directory::ItemType::File) ||
+			!oSubdir.Enumerate([&](std::u8string_view, unsigned) { ++iItems; return true; }) ||
+			iItems != 3 ||
+			!oDir.Delete(u8"Moved") ||
+			oDir.Exists(u8"Moved"))
+		{
+			printf("  FAIL.\n\n");
+			return 1;
+		}
+		else
+			printf("  SUCCESS.\n\n");
+	}
+
+#ifndef _WIN32
+	printf("Trying to move a directory to another file system relative to handles...\n");
+	{
+		char szOrig[] = "/tmp/rlSystemTest.XXXXXX";
+		char szDest[] = "/dev/shm/rlSystemTest.XXXXXX";
+		struct stat oOrigStat, oDestStat;
+		const bool bCreated = mkdtemp(szOrig) && mkdtemp(szDest);
+		if (!bCreated || stat(szOrig, &oOrigStat) != 0 || stat(szDest, &oDestStat) != 0 ||
+			oOrigStat.st_dev == oDestStat.st_dev)
+		{
+			rmdir(szOrig);
+			rmdir(szDest);
+			printf("  SKIPPED (/tmp and /dev/shm are on the same file system).\n\n");
+		}
+		else
+		{
+			const auto sOrig = std::u8string(reinterpret_cast<const char8_t *>(szOrig));
+			const auto sDest = std::u8string(reinterpret_cast<const char8_t *>(szDest));
+			const auto fnCreateFile = [](const rlSystem::Directory::Handle &oDir,
+				const char8_t *szName)
+			{
+				FILE *pFile = oDir.OpenFile(szName, "wx");
+				if (pFile)
+					fclose(pFile);
+				return pFile != nullptr;
+			};
+
+			bool bOK = rlSystem::Directory::Create((sOrig + u8"/Parent/Dir").c_str()) &&
+				rlSystem::Directory::Create((sOrig + u8"/Parent/Dir2").c_str()) &&
+				rlSystem::Directory::Create((sDest + u8"/Dir").c_str());
+
+			rlSystem::Directory::Handle oParent((sOrig + u8"/Parent").c_str());
+			rlSystem::Directory::Handle oDest(sDest.c_str());
+			bOK = bOK && fnCreateFile(oParent, u8"Dir/data.txt") &&
+				fnCreateFile(oDest, u8"Dir/old.txt");
+
+			// the handle's directory is renamed and another one takes its place.
+			bOK = bOK && rlSystem::Directory::Move((sOrig + u8"/Parent").c_str(),
+				(sOrig + u8"/Renamed").c_str()) &&
+				rlSystem::Directory::Create((sOrig + u8"/Parent/Dir").c_str()) &&
+				rlSystem::Directory::Create((sOrig + u8"/Parent/Dir2").c_str());
+
+			bOK = bOK &&
+				oParent.Move(u8"Dir", oDest, u8"Dir", true) &&
+				rlSystem::File::Exists((sDest + u8"/Dir/data.txt").c_str()) &&
+				!rlSystem::Path::Exists((sDest + u8"/Dir/old.txt").c_str()) &&
+				!rlSystem::Path::Exists((sOrig + u8"/Renamed/Dir").c_str()) &&
+				rlSystem::Directory::Exists((sOrig + u8"/Parent/Dir").c_str()) &&
+				!oParent.Move(u8"Dir2", oDest, u8"Dir", false) &&
+				rlSystem::Directory::Exists((sOrig + u8"/Renamed/Dir2").c_str());
+
+			rlSystem::Directory::Delete(sOrig.c_str());
+			rlSystem::Directory::Delete(sDest.c_str());
+			if (!bOK)
+			{
+				printf("  FAIL.\n\n");
+				return 1;
+			}
+			else
+				printf("  SUCCESS.\n\n");
+		}
+	}
+#endif
+
+	printf("Trying to create and publish temporary files...\n");
+	{
+		std::u8string sTempDir;
+		bool bOK = false;
+		{
+			rlSystem::TempDirectory oTempDir(szTestDir);
+			sTempDir = oTempDir.path();
+
+			rlSystem::TempFile oTemp(sTempDir.c_str());
+			const auto sPublished = sTempDir + u8"/published.txt";
+			if (oTemp && fputs("Temp", oTemp.file()) >= 0 &&
+				oTemp.Publish(sPublished.c_str()) && !oTemp.valid())
+			{
+				rlSystem::TempFile oTemp2(sTempDir.c_str());
+				bOK = rlSystem::File::GetSize(sPublished.c_str()) == 4 &&
+					oTemp2 && !oTemp2.Publish(sPublished.c_str()) &&
+					oTemp2.Publish(sPublished.c_str(), true) &&
+					rlSystem::File::GetSize(sPublished.c_str()) == 0;
+			}
+		}
+
+		if (!bOK || sTempDir.empty() || rlSystem::Path::Exists(sTempDir.c_str()) ||
+			rlSystem::Directory::IsReadonly(szTestDir))
+		{
+			printf("  FAIL.\n\n");
+			return 1;
+		}
+		else
+			printf("  SUCCESS.\n\n");
+	}
+
+#ifndef _WIN32
+	printf("Trying to copy a sparse file...\n");
+	{
+		// 64 MiB, only the first and the last byte are written.
+		FILE *pFile = fopen("testdir/sparse.bin", "wb");
+		if (pFile)
+		{
+			fputc('A', pFile);
+			fseek(pFile, 64 * 1024 * 1024 - 2, SEEK_CUR);
+			fputc('Z', pFile);
+			fclose(pFile);
+		}
+
+		struct stat oStatOrig {}, oStatCopy {};
+		if (!pFile ||
+			!rlSystem::File::Copy(u8"testdir/sparse.bin", u8"testdir/sparse_copy.bin") ||
+			stat("testdir/sparse.bin", &oStatOrig) != 0 ||
+			stat("testdir/sparse_copy.bin", &oStatCopy) != 0 ||
+			oStatCopy.st_size != oStatOrig.st_size ||
+			oStatCopy.st_blocks > oStatOrig.st_blocks)
+		{
+			printf("  FAIL.\n\n");
+			return 1;
+		}
+		else
+			printf("  SUCCESS.\n\n");
+	}
+#endif
+
+	printf("Trying to prefetch files in order...\n");
+	{
+		auto oFiles = rlSystem::Directory::GetFiles(szTestDir, nullptr, false, true);
+		const auto oExpected = oFiles;
+
+		rlSystem::PrefetchOptions oOptions;
+		oOptions.iInitialWindow = 1;
+		rlSystem::Prefetcher oPrefetcher(std::move(oFiles), oOptions);
+
+		size_t iConsumed = 0;
+		bool bOrdered = true;
+		while (const auto *pPath = oPrefetcher.Next())
+		{
+			bOrdered = bOrdered && iConsumed < oExpected.size() && *pPath == oExpected[iConsumed];
+			++iConsumed;
+		}
+
+		if (!bOrdered || iConsumed != oExpected.size() || oPrefetcher.Next() != nullptr)
+		{
+			printf("  FAIL.\n\n");
+			return 1;
+		}
+		else
+			printf("  SUCCESS.\n\n");
+	}
+
+#ifndef _WIN32
+	printf("Trying to run a console application with redirected output...\n");
+	{
+		int iResult = 0;
+		constexpr char8_t szScript[] =
+			u8"-c 'test -d MixedCase || exit 1; echo \"Hello RunConsoleApp()!\"; exit 3'";
+
+		if (!rlSystem::RunConsoleApp(u8"sh", szScript, szTestDir, &iResult,
+			u8"testdir/out.txt", u8"testdir/out.txt") ||
+			iResult != 3 ||
+			rlSystem::File::GetSize(u8"testdir/out.txt") != 23)
+		{
+			printf("  FAIL.\n\n");
+			return 1;
+		}
+		else
+			printf("  SUCCESS.\n\n");
+	}
+
+	printf("Trying to capture the output of a console application...\n");
+	{
+		// more output on both streams than fits into the pipes at once.
+		constexpr char8_t szScript[] =
+			u8"-c 'head -c 3000000 /dev/zero; head -c 3000000 /dev/zero >&2; printf end'";
+
+		int iResult = -1;
+		rlSystem::CapturedOutput oOutput;
+		rlSystem::CaptureOptions oOptions;
+		const bool bFull = rlSystem::RunConsoleApp(u8"sh", szScript, nullptr, &iResult, oOutput);
+		const bool bFullOK = bFull && iResult == 0 && !oOutput.bTruncated &&
+			oOutput.sStdOut.length() == 3000003 && oOutput.sStdOut.ends_with("end") &&
+			oOutput.sStdErr.length() == 3000000;
+
+		size_t iStdErr = 0;
+		oOptions.iMaxOutputSize = 1000;
+		oOptions.fnStdErr       = [&](std::string_view sData) { iStdErr += sData.length(); };
+		const bool bCapped = rlSystem::RunConsoleApp(u8"sh", szScript, nullptr, &iResult, oOutput,
+			oOptions);
+		const bool bCappedOK = bCapped && oOutput.bTruncated &&
+			oOutput.sStdOut.length() == 1000 && oOutput.sStdErr.empty() && iStdErr == 1000;
+
+		if (!bFullOK || !bCappedOK)
+		{
+			printf("  FAIL.\n\n");
+			return 1;
+		}
+		else
+			printf("  SUCCESS.\n\n");
+	}
+
+	printf("Trying to pass input to a console application...\n");
+	{
+		// more input than fits into the pipe, while the output is read.
+		const std::string sData(3000000, 'x');
+		rlSystem::InputSource oInput;
+		oInput.sData = sData;
+
+		int iResult = -1;
+		rlSystem::CapturedOutput oOutput;
+		bool bOK = rlSystem::RunConsoleApp(u8"cat", nullptr, nullptr, &iResult, oOutput, {},
+			nullptr, &oInput) && iResult == 0 && oOutput.sStdOut == sData;
+
+		// a child that doesn't read its input.
+		bOK = bOK && rlSystem::RunConsoleApp(u8"true", nullptr, nullptr, &iResult, nullptr,
+			nullptr, nullptr, &oInput) && iResult == 0;
+
+		rlSystem::InputSource oFileInput;
+		oFileInput.sFile = u8"testdir/out.txt";
+		bOK = bOK && rlSystem::RunConsoleApp(u8"wc", u8"-c", nullptr, &iResult, oOutput, {},
+			nullptr, &oFileInput) && oOutput.sStdOut == "23\n";
+
+		const int iFD = open("testdir/out.txt", O_RDONLY | O_CLOEXEC);
+		rlSystem::InputSource oFDInput;
+		oFDInput.hFile = iFD;
+		bOK = bOK && iFD >= 0 && rlSystem::RunConsoleApp(u8"head", u8"-c 5", nullptr, &iResult,
+			oOutput, {}, nullptr, &oFDInput) && oOutput.sStdOut == "Hello";
+		if (iFD >= 0)
+			close(iFD);
+
+		oFileInput.sFile = u8"testdir/does-not-exist.txt";
+		bOK = bOK && !rlSystem::RunConsoleApp(u8"cat", nullptr, nullptr, &iResult, oOutput, {},
+			nullptr, &oFileInput);
+
+		if (!bOK)
+		{
+			printf("  FAIL.\n\n");
+			return 1;
+		}
+		else
+			printf("  SUCCESS.\n\n");
+	}
+
+	printf("Trying to supervise a process...\n");
+	{
+		rlSystem::Process oSleep, oExit;
+		int iExitCode = -1;
+		bool bOK = rlSystem::RunApp(u8"sleep", u8"10", nullptr, oSleep) &&
+			rlSystem::RunApp(u8"sh", u8"-c 'exit 7'", nullptr, oExit) &&
+			oSleep.id() > 0 && oSleep.handle() >= 0;
+
+		// the pidfd becomes readable when the process has ended.
+		if (bOK)
+		{
+			pollfd oPoll{ oExit.handle(), POLLIN, 0 };
+			bOK = poll(&oPoll, 1, 5000) == 1 && oExit.TryWait(&iExitCode) && iExitCode == 7;
+		}
+
+		bOK = bOK && !oSleep.TryWait() &&
+			!oSleep.WaitFor(std::chrono::milliseconds(20)) &&
+			oSleep.Kill() &&
+			oSleep.WaitFor(std::chrono::seconds(5), &iExitCode) && iExitCode == 128 + SIGKILL &&
+			oSleep.Wait() == 128 + SIGKILL &&
+			oSleep.usage().tWall >= std::chrono::milliseconds(20) && oExit.usage().iPeakRSS > 0;
+
+		if (!bOK)
+		{
+			printf("  FAIL.\n\n");
+			return 1;
+		}
+		else
+			printf("  SUCCESS.\n\n");
+	}
+
+	printf("Trying to reap processes nobody waits for...\n");
+	{
+		const auto fnThreads = []
+		{
+			return rlSystem::Directory::GetDirectories(u8"/proc/self/task", nullptr, true, false)
+				.size();
+		};
+		const size_t iThreads = fnThreads();
+
+		bool bOK = true;
+		for (int i = 0; i < 20 && bOK; ++i)
+		{
+			rlSystem::Process oProcess;
+			bOK = rlSystem::RunApp(u8"sleep", u8"0.2", nullptr, false) &&
+				rlSystem::RunApp(u8"sleep", u8"0.2", nullptr, oProcess);
+		}
+
+		// a single thread reaps all of them.
+		bOK = bOK && fnThreads() <= iThreads + 1;
+
+		// once they've ended, none may remain a zombie.
+		usleep(300000);
+		const auto tpDeadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+		bool bZombie = bOK;
+		while (bZombie && std::chrono::steady_clock::now() < tpDeadline)
+		{
+			siginfo_t oInfo{};
+			bZombie = waitid(P_ALL, 0, &oInfo, WEXITED | WNOHANG | WNOWAIT) == 0 &&
+				oInfo.si_pid != 0;
+			if (bZombie)
+				usleep(10000);
+		}
+
+		if (!bOK || bZombie)
+		{
+			printf("  FAIL.\n\n");
+			return 1;
+		}
+		else
+			printf("  SUCCESS.\n\n");
+	}
+
+	printf("Trying to measure the resources used by a console application...\n");
+	{
+		rlSystem::ResourceUsage oUsage;
+		int iResult = -1;
+		constexpr char8_t szScript[] = u8"-c 'head -c 5000000 /dev/zero >/dev/null; "
+			u8"i=0; while [ $i -lt 20000 ]; do i=$((i+1)); done'";
+		const bool bOK = rlSystem::RunConsoleApp(u8"sh", szScript, nullptr, &iResult, nullptr,
+			nullptr, &oUsage);
+
+		if (!bOK || iResult != 0 ||
+			oUsage.iReadBytes < 5000000 || oUsage.iWriteBytes < 5000000 ||
+			oUsage.tUser + oUsage.tSystem == std::chrono::nanoseconds(0) ||
+			oUsage.tWall < oUsage.tUser || oUsage.iPeakRSS == 0)
+		{
+			printf("  FAIL.\n\n");
+			return 1;
+		}
+		else
+			printf("  SUCCESS.\n\n");
+	}
+
+	printf("Trying to pass an argument list and an environment...\n");
+	{
+		const std::u8string_view oArgs[] =
+		{
+			u8"-c", u8"test \"$1\" = 'a \"b\" \\' && test \"$FOO\" = bar && test -z \"$HOME\"",
+			u8"sh", u8"a \"b\" \\"
+		};
+		const std::u8string_view oEnvironment[] = { u8"FOO=bar" };
+
+		int iResult = -1;
+		if (!rlSystem::RunApp(u8"sh", oArgs, oEnvironment, nullptr, true, &iResult) ||
+			iResult != 0)
+		{
+			printf("  FAIL.\n\n");
+			return 1;
+		}
+		else
+			printf("  SUCCESS.\n\n");
+	}
+
+	printf("Trying to run a pipeline...\n");
+	{
+		const std::vector<rlSystem::PipelineStage> oStages =
+		{
+			{ u8"printf", u8"'b\\na\\nc\\n'" },
+			{ u8"sort" },
+			{ u8"tr", u8"a-z A-Z" }
+		};
+
+		std::string sOutput;
+		rlSystem::PipelineOptions oOptions;
+		oOptions.sOutputFile = u8"testdir/pipeline.txt";
+		oOptions.fnOutput    = [&](std::string_view sData) { sOutput += sData; };
+		std::vector<int> oExitCodes;
+		bool bOK = rlSystem::RunPipeline(oStages, oOptions, &oExitCodes) &&
+			sOutput == "A\nB\nC\n" && oExitCodes == std::vector<int>{ 0, 0, 0 } &&
+			rlSystem::File::GetSize(u8"testdir/pipeline.txt") == 6;
+
+		// the output of the first run as the input of a second one.
+		std::string sSecond;
+		rlSystem::PipelineOptions oOptions2;
+		oOptions2.sInputFile = u8"testdir/pipeline.txt";
+		oOptions2.fnOutput   = [&](std::string_view sData) { sSecond += sData; };
+		bOK = bOK && rlSystem::RunPipeline({ { u8"sort", u8"-r" }, { u8"head", u8"-n 1" } },
+			oOptions2) && sSecond == "C\n";
+
+		if (!bOK)
+		{
+			printf("  FAIL.\n\n");
+			return 1;
+		}
+		else
+			printf("  SUCCESS.\n\n");
+	}
+
+	printf("Trying to start processes via the spawn server...\n");
+	{
+		bool bOK = rlSystem::SpawnServer::Start() && rlSystem::SpawnServer::IsRunning();
+
+		int iResult = -1;
+		bOK = bOK && rlSystem::RunConsoleApp(u8"sh",
+			u8"-c 'test -d MixedCase || exit 1; echo \"Hello spawn server!\"; exit 4'",
+			szTestDir, &iResult, u8"testdir/server.txt", u8"testdir/server.txt") &&
+			iResult == 4 && rlSystem::File::GetSize(u8"testdir/server.txt") == 20;
+
+		rlSystem::CapturedOutput oOutput;
+		rlSystem::ResourceUsage oUsage;
+		bOK = bOK && rlSystem::RunConsoleApp(u8"sh", u8"-c 'head -c 3000000 /dev/zero; echo err >&2'",
+			nullptr, &iResult, oOutput, {}, &oUsage) &&
+			iResult == 0 && oOutput.sStdOut.length() == 3000000 && oOutput.sStdErr == "err\n" &&
+			oUsage.iWriteBytes >= 3000000 && oUsage.iPeakRSS > 0;
+
+		// the parent of the child is the server.
+		bOK = bOK && rlSystem::RunConsoleApp(u8"sh", u8"-c 'echo $PPID'", nullptr, &iResult,
+			oOutput) && oOutput.sStdOut != std::to_string(getpid()) + "\n";
+
+		rlSystem::InputSource oInput;
+		oInput.sData = "via the server";
+		bOK = bOK && rlSystem::RunConsoleApp(u8"cat", nullptr, nullptr, &iResult, oOutput, {},
+			nullptr, &oInput) && oOutput.sStdOut == oInput.sData;
+
+		const std::u8string_view oArgs[] = { u8"-c", u8"exit $FOO" };
+		const std::u8string_view oEnvironment[] = { u8"FOO=9" };
+		bOK = bOK && rlSystem::RunApp(u8"sh", oArgs, oEnvironment, nullptr, true, &iResult) &&
+			iResult == 9 &&
+			!rlSystem::RunApp(u8"rlSystem-does-not-exist", nullptr, nullptr, true);
+
+		rlSystem::SpawnServer::Stop();
+		if (!bOK || rlSystem::SpawnServer::IsRunning())
+		{
+			printf("  FAIL.\n\n");
+			return 1;
+		}
+		else
+			printf("  SUCCESS.\n\n");
+	}
+
+	printf("Trying to run a batch of console applications...\n");
+	{
+		std::vector<rlSystem::ProcessJob> oJobs(6);
+		for (size_t i = 0; i < oJobs.size(); ++i)
+		{
+			oJobs[i].sAppPath  = u8"sh";
+			oJobs[i].sArgs     = u8"-c 'echo " + std::u8string(1, char8_t(u8'0' + i)) +
+				u8"; exit " + std::u8string(1, char8_t(u8'0' + i)) + u8"'";
+			oJobs[i].iPriority = (int)i;
+		}
+
+		rlSystem::BatchOptions oOptions;
+		oOptions.iMaxParallel = 3;
+		auto oResults = rlSystem::RunBatch(oJobs, oOptions);
+		bool bOK = oResults.size() == oJobs.size();
+		for (size_t i = 0; bOK && i < oResults.size(); ++i)
+		{
+			bOK = oResults[i].bStarted && (size_t)oResults[i].iExitCode == i &&
+				oResults[i].oOutput.sStdOut == std::string(1, char('0' + i)) + "\n";
+		}
+
+		// one at a time: highest priority first, then stop at the first failure (exit code 5).
+		std::vector<size_t> oFinished;
+		oOptions.iMaxParallel = 1;
+		oOptions.bFailFast    = true;
+		oOptions.fnFinished   = [&](size_t iJob, const rlSystem::ProcessJobResult &)
+		{
+			oFinished.push_back(iJob);
+		};
+		oResults = rlSystem::RunBatch(oJobs, oOptions);
+		bOK = bOK && oFinished == std::vector<size_t>{ 5 } &&
+			oResults[5].iExitCode == 5 && oResults[0].bCancelled && !oResults[0].bStarted;
+
+		if (!bOK)
+		{
+			printf("  FAIL.\n\n");
+			return 1;
+		}
+		else
+			printf("  SUCCESS.\n\n");
+	}
+#endif
+
 	const auto sNewDir = rlSystem::Path::GetName(szTestDir);
 	printf("Trying to delete \"%s\"...\n",
 		reinterpret_cast<const char *>(sNewDir.c_str()));
@@ -100,6 +1084,7 @@ int main(int argc, char* argv[])
 	else
 		printf("  SUCCESS.\n\n");
 
+#ifdef _WIN32 // drive letters only denote absolute paths on Windows
 	printf("Checking if \"C:/test.txt\" is relative...\n");
 	if (rlSystem::Path::IsRelative(u8R"PATH(C:/test.txt)PATH"))
 	{
@@ -108,6 +1093,7 @@ int main(int argc, char* argv[])
 	}
 	else
 		printf("  SUCCESS.\n\n");
+#endif
 
 
 	printf("\n");
@@ -116,13 +1102,62 @@ int main(int argc, char* argv[])
 		reinterpret_cast<const char *>(szFilename),
 		reinterpret_cast<const char *>(rlSystem::Path::GetFileExtension(szFilename).c_str()));
 
+	printf("Matching filenames against a pattern set...\n");
+	{
+		rlSystem::PatternSet oPatterns(false);
+		oPatterns.AddExtension(u8".tar.gz");
+		oPatterns.AddName(u8"Makefile");
+		oPatterns.AddGlob(u8"*.[ch]pp");
+		oPatterns.AddExtension(u8"gz");
+		oPatterns.AddName(u8"\u00C4rger.txt");
+		oPatterns.AddGlob(u8"\u00DCber*.\u212A");
+
+		if (oPatterns.Match(u8"Archive.TAR.GZ")         != 0 ||
+			oPatterns.Match(u8"makefile")               != 1 ||
+			oPatterns.Match(u8"main.CPP")               != 2 ||
+			oPatterns.Match(u8"data.gz")                != 3 ||
+			oPatterns.Match(u8"\u00E4RGER.TXT")         != 4 ||
+			oPatterns.Match(u8"\u00FCBER-alles.K")      != 5 ||
+			oPatterns.Match(u8"main.cxx")               != rlSystem::PatternSet::NoMatch)
+		{
+			printf("  FAIL.\n\n");
+			return 1;
+		}
+		else
+			printf("  SUCCESS.\n\n");
+	}
+
+
+	printf("Collecting the largest items...\n");
+	{
+		rlSystem::Directory::TopItems oTop(2, rlSystem::Directory::SortKey::Size, true);
+		for (uint64_t iSize : { 10, 30, 20, 5 })
+		{
+			rlSystem::Directory::Item oItem{};
+			oItem.sPath = u8"file" + std::u8string(1, char8_t(u8'0' + iSize / 5));
+			oItem.iSize = iSize;
+			oTop.Add(oItem);
+		}
 
+		const auto oItems = oTop.Take();
+		if (oItems.size() != 2 || oItems[0].iSize != 30 || oItems[1].iSize != 20)
+		{
+			printf("  FAIL.\n\n");
+			return 1;
+		}
+		else
+			printf("  SUCCESS.\n\n");
+	}
+
+
+#ifdef _WIN32
 	printf("Attempting to call CMD synchronously...\n");
 	rlSystem::RunApp(u8"cmd.exe", u8"/C \"echo Hello RunApp()!\"",
 		0, true, 0, false);
 
 	printf("Attempting to call CMD as console app...\n");
 	rlSystem::RunConsoleApp(u8"cmd.exe", u8"/C \"echo Hello RunConsoleApp()!\"");
+#endif
 
 
 	return 0;